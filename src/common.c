@@ -5,6 +5,11 @@
 #include "common.h"
 
 #include <dirent.h>
+#include <math.h>
+#include <linux/fiemap.h>
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 
 int64_t calculate_time_diff_ns(struct timespec *start, struct timespec *end) {
@@ -65,3 +70,337 @@ void remove_dir_recursive(const char *path) {
     closedir(d);
     rmdir(path);
 }
+
+/* 解析带单位后缀的大小，如 "4096"、"4K"、"1M"、"2G"、"1T"（1024 进制） */
+int parse_size(const char *str, size_t *out) {
+    char *end = NULL;
+    errno = 0;
+    unsigned long long value = strtoull(str, &end, 10);
+    if (errno != 0 || end == str) {
+        return -1;
+    }
+    switch (*end) {
+        case '\0':
+            break;
+        case 'k':
+        case 'K':
+            value *= _1KB_BYTES;
+            end++;
+            break;
+        case 'm':
+        case 'M':
+            value *= _1MB_BYTES;
+            end++;
+            break;
+        case 'g':
+        case 'G':
+            value *= _1GB_BYTES;
+            end++;
+            break;
+        case 't':
+        case 'T':
+            value *= 1024ULL * _1GB_BYTES;
+            end++;
+            break;
+        default:
+            return -1;
+    }
+    if (*end == 'B' || *end == 'b') {
+        end++;
+    }
+    if (*end != '\0') {
+        return -1;
+    }
+    *out = (size_t)value;
+    return 0;
+}
+
+void lat_hist_init(struct lat_hist *h) {
+    memset(h, 0, sizeof(*h));
+    h->min_ns = UINT64_MAX;
+}
+
+static int lat_hist_index(uint64_t ns) {
+    if (ns < LAT_HIST_SUB) {
+        return (int)ns;
+    }
+    int msb = 63 - __builtin_clzll(ns);
+    int shift = msb - LAT_HIST_SUB_BITS;
+    return ((shift + 1) << LAT_HIST_SUB_BITS) +
+           (int)((ns >> shift) & (LAT_HIST_SUB - 1));
+}
+
+/* 桶的中点，作为该桶内样本的代表值 */
+static uint64_t lat_hist_bucket_mid(int index) {
+    if (index < LAT_HIST_SUB) {
+        return (uint64_t)index;
+    }
+    int shift = (index >> LAT_HIST_SUB_BITS) - 1;
+    uint64_t mant = (uint64_t)((index & (LAT_HIST_SUB - 1)) | LAT_HIST_SUB);
+    return (mant << shift) + ((1ULL << shift) >> 1);
+}
+
+void lat_hist_add(struct lat_hist *h, uint64_t ns) {
+    h->count++;
+    h->sum_ns += ns;
+    if (ns < h->min_ns) h->min_ns = ns;
+    if (ns > h->max_ns) h->max_ns = ns;
+    h->buckets[lat_hist_index(ns)]++;
+}
+
+void lat_hist_merge(struct lat_hist *dst, const struct lat_hist *src) {
+    if (src->count == 0) return;
+    dst->count += src->count;
+    dst->sum_ns += src->sum_ns;
+    if (src->min_ns < dst->min_ns) dst->min_ns = src->min_ns;
+    if (src->max_ns > dst->max_ns) dst->max_ns = src->max_ns;
+    for (int i = 0; i < LAT_HIST_BUCKETS; i++) {
+        dst->buckets[i] += src->buckets[i];
+    }
+}
+
+/* pct 取值 0-100，返回纳秒 */
+uint64_t lat_hist_percentile(const struct lat_hist *h, double pct) {
+    if (h->count == 0) return 0;
+    uint64_t rank = (uint64_t)(pct / 100.0 * (double)h->count + 0.5);
+    if (rank < 1) rank = 1;
+    if (rank > h->count) rank = h->count;
+
+    uint64_t seen = 0;
+    for (int i = 0; i < LAT_HIST_BUCKETS; i++) {
+        seen += h->buckets[i];
+        if (seen >= rank) {
+            uint64_t v = lat_hist_bucket_mid(i);
+            if (v < h->min_ns) v = h->min_ns;
+            if (v > h->max_ns) v = h->max_ns;
+            return v;
+        }
+    }
+    return h->max_ns;
+}
+
+/* 格式化为 "avg/p50/p90/p99/p99.9/max" 摘要，单位 us */
+void lat_hist_format(const struct lat_hist *h, char *out, size_t out_size) {
+    if (h->count == 0) {
+        snprintf(out, out_size, "no samples");
+        return;
+    }
+    snprintf(out, out_size,
+             "avg %.1f | p50 %.1f | p90 %.1f | p99 %.1f | p99.9 %.1f | "
+             "max %.1f us",
+             h->sum_ns / 1000.0 / h->count,
+             lat_hist_percentile(h, 50.0) / 1000.0,
+             lat_hist_percentile(h, 90.0) / 1000.0,
+             lat_hist_percentile(h, 99.0) / 1000.0,
+             lat_hist_percentile(h, 99.9) / 1000.0, h->max_ns / 1000.0);
+}
+
+/* 解析逗号分隔的大小列表，返回解析出的个数，出错返回 -1 */
+int parse_size_list(const char *str, size_t *out, int max_count) {
+    char buf[MAX_PATH_LEN];
+    strncpy(buf, str, sizeof(buf) - 1);
+    buf[sizeof(buf) - 1] = '\0';
+
+    int count = 0;
+    char *save = NULL;
+    for (char *tok = strtok_r(buf, ",", &save); tok;
+         tok = strtok_r(NULL, ",", &save)) {
+        if (count >= max_count || parse_size(tok, &out[count]) != 0) {
+            return -1;
+        }
+        count++;
+    }
+    return count;
+}
+
+/*
+    解析逗号分隔的大小列表，元素可以是单个值或 "lo-hi" 区间，区间从 lo 起
+    按 2 倍递增到不超过 hi；返回展开后的个数，出错返回 -1
+*/
+int parse_range_list(const char *str, size_t *out, int max_count) {
+    char buf[MAX_PATH_LEN];
+    strncpy(buf, str, sizeof(buf) - 1);
+    buf[sizeof(buf) - 1] = '\0';
+
+    int count = 0;
+    char *save = NULL;
+    for (char *tok = strtok_r(buf, ",", &save); tok;
+         tok = strtok_r(NULL, ",", &save)) {
+        size_t lo, hi;
+        char *dash = strchr(tok, '-');
+        if (dash) *dash = '\0';
+        if (parse_size(tok, &lo) != 0) return -1;
+        hi = lo;
+        if (dash && (parse_size(dash + 1, &hi) != 0 || hi < lo || lo == 0)) {
+            return -1;
+        }
+        for (size_t v = lo; v <= hi; v = v ? v * 2 : hi + 1) {
+            if (count >= max_count) return -1;
+            out[count++] = v;
+        }
+    }
+    return count;
+}
+
+/* 通过 FIEMAP 取文件的 extent 数，不支持时返回 -1 */
+long fiemap_extent_count(int fd) {
+    struct fiemap fm;
+    memset(&fm, 0, sizeof(fm));
+    fm.fm_start = 0;
+    fm.fm_length = FIEMAP_MAX_OFFSET;
+    fm.fm_flags = FIEMAP_FLAG_SYNC;
+    fm.fm_extent_count = 0; /* 只统计数量，不返回 extent 明细 */
+    if (ioctl(fd, FS_IOC_FIEMAP, &fm) != 0) {
+        return -1;
+    }
+    return (long)fm.fm_mapped_extents;
+}
+
+/*
+    通过 mincore 统计文件 [off, off + len) 中驻留在页缓存的页数，失败返回 -1
+    映射只用于查询，不会触发缺页；off 向下对齐到页边界
+*/
+long page_cache_resident(int fd, off_t off, size_t len) {
+    long page = sysconf(_SC_PAGESIZE);
+    off_t start = off - off % page;
+    len += off - start;
+    if (len == 0) return 0;
+    void *map = mmap(NULL, len, PROT_READ, MAP_SHARED, fd, start);
+    if (map == MAP_FAILED) return -1;
+    size_t pages = (len + page - 1) / page;
+    unsigned char *vec = malloc(pages);
+    long resident = -1;
+    if (vec && mincore(map, len, vec) == 0) {
+        resident = 0;
+        for (size_t i = 0; i < pages; i++) resident += vec[i] & 1;
+    }
+    free(vec);
+    munmap(map, len);
+    return resident;
+}
+
+/* O_DIRECT pread 试探：从 512 起倍增，取第一个不返回 EINVAL 的对齐 */
+static int dio_probe(int fd, size_t *mem_align, size_t *off_align) {
+    const size_t max_align = 64 * _1KB_BYTES;
+    void *buf = NULL;
+    int ret = -1;
+    if (posix_memalign(&buf, max_align, 2 * max_align) != 0) return -1;
+    *off_align = 0;
+    for (size_t a = 512; a <= max_align; a *= 2) {
+        if (pread(fd, buf, a, (off_t)a) >= 0) {
+            *off_align = a;
+            break;
+        }
+        if (errno != EINVAL) goto out;
+    }
+    if (*off_align == 0) goto out;
+    for (size_t m = sizeof(void *); m <= max_align; m *= 2) {
+        if (pread(fd, (char *)buf + m, *off_align, 0) >= 0) {
+            *mem_align = m;
+            ret = DIO_ALIGN_PROBED;
+            break;
+        }
+        if (errno != EINVAL) break;
+    }
+out:
+    free(buf);
+    return ret;
+}
+
+/*
+    O_DIRECT 的内存和偏移 / 长度对齐要求：优先 statx(STATX_DIOALIGN)，
+    内核或文件系统不提供时用不同对齐的 O_DIRECT pread 试探，此时 path
+    须是至少 DIO_PROBE_MIN_SIZE 的已有文件。返回 enum dio_align_source，
+    不支持 O_DIRECT 时返回 -1
+*/
+int dio_alignment(const char *path, size_t *mem_align, size_t *off_align) {
+#ifdef STATX_DIOALIGN
+    struct statx stx;
+    if (statx(AT_FDCWD, path, 0, STATX_DIOALIGN, &stx) == 0 &&
+        (stx.stx_mask & STATX_DIOALIGN)) {
+        if (stx.stx_dio_offset_align == 0) {
+            errno = EOPNOTSUPP;
+            return -1;
+        }
+        *mem_align = stx.stx_dio_mem_align;
+        *off_align = stx.stx_dio_offset_align;
+        return DIO_ALIGN_STATX;
+    }
+#endif
+    int fd = open(path, O_RDONLY | O_DIRECT);
+    if (fd < 0) return -1;
+    int ret = dio_probe(fd, mem_align, off_align);
+    int saved = errno;
+    close(fd);
+    errno = saved;
+    return ret;
+}
+
+static int cmp_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static double sorted_median(const double *v, int n) {
+    if (n == 0) return 0.0;
+    return n % 2 ? v[n / 2] : (v[n / 2 - 1] + v[n / 2]) / 2.0;
+}
+
+/* 双侧 95% 的 t 分位数，自由度 1-30，更大时用正态近似 */
+static double t_crit_95(int df) {
+    static const double table[] = {
+        12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+        2.201,  2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+        2.080,  2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042,
+    };
+    if (df < 1) return 0.0;
+    if (df <= (int)(sizeof(table) / sizeof(table[0]))) return table[df - 1];
+    return 1.960;
+}
+
+void sample_stats_compute(const double *samples, int n, int reject_outliers,
+                          struct sample_stats *out) {
+    memset(out, 0, sizeof(*out));
+    if (n <= 0) return;
+    double *v = malloc(n * sizeof(double));
+    double *dev = malloc(n * sizeof(double));
+    if (!v || !dev) {
+        free(v);
+        free(dev);
+        return;
+    }
+    memcpy(v, samples, n * sizeof(double));
+    qsort(v, n, sizeof(double), cmp_double);
+
+    int kept = n;
+    if (reject_outliers && n >= 3) {
+        double med = sorted_median(v, n);
+        for (int i = 0; i < n; i++) dev[i] = fabs(v[i] - med);
+        qsort(dev, n, sizeof(double), cmp_double);
+        double mad = sorted_median(dev, n);
+        if (mad > 0.0) {
+            kept = 0;
+            for (int i = 0; i < n; i++) {
+                if (0.6745 * fabs(v[i] - med) / mad <= 3.5) v[kept++] = v[i];
+            }
+        }
+    }
+
+    double sum = 0.0;
+    for (int i = 0; i < kept; i++) sum += v[i];
+    out->n = kept;
+    out->rejected = n - kept;
+    out->mean = sum / kept;
+    out->median = sorted_median(v, kept);
+    if (kept > 1) {
+        double ss = 0.0;
+        for (int i = 0; i < kept; i++) {
+            ss += (v[i] - out->mean) * (v[i] - out->mean);
+        }
+        out->stddev = sqrt(ss / (kept - 1));
+        out->ci95 = t_crit_95(kept - 1) * out->stddev / sqrt(kept);
+    }
+    out->cv = out->mean != 0.0 ? out->stddev / fabs(out->mean) : 0.0;
+    free(v);
+    free(dev);
+}
@@ -38,6 +38,48 @@ typedef long long ll;
 #define DEFAULT_ITER 5
 #define MAX_JOBS 64
 #define MAX_PATH_LEN 512
+#define MAX_TRIALS 100
+#define DEFAULT_MAX_TRIALS 20
+#define DEFAULT_FILESET_FILES 1000
+#define DEFAULT_SIZE_DIST "lognormal:16K:1.2:1M"
+#define DEFAULT_MD_FANOUT 4
+#define DEFAULT_MD_DEPTH 2
+#define DEFAULT_MD_ITEMS 50
+#define DEFAULT_DIR_SIZES "1K,10K,100K,1M"
+#define DEFAULT_DENTS_BUFS "4K,32K,1M"
+#define DEFAULT_PATH_DEPTHS "1,4,16,64,256"
+#define DEFAULT_PATH_NAME_LENS "1,16,255"
+#define DEFAULT_SYMLINK_CHAINS "1,8,32"
+#define DEFAULT_APPEND_RECORDS 10000
+#define DEFAULT_APPEND_PROCS 1
+#define DEFAULT_FALLOC_SIZE _1MB_BYTES
+#define DEFAULT_SPARSE_SIZE (1024 * _1GB_BYTES)
+#define DEFAULT_SPARSE_WRITES 10000
+#define DEFAULT_SPARSE_MAP "4K:60K,64K:960K"
+#define DEFAULT_SPARSE_EXTENTS 4096
+#define DEFAULT_WAL_COMMITS 1000
+#define DEFAULT_REPLACE_OPS 500
+#define DEFAULT_LOCK_OPS 10000
+#define DEFAULT_XATTR_FILES 1000
+#define DEFAULT_XATTR_SIZES "16,256,2K,16K"
+#define DEFAULT_XATTR_COUNTS "1,8,32"
+#define DEFAULT_DIST_PORT 7979
+#define DEFAULT_DIST_TIME 10
+#define DEFAULT_SS_ROUND 10
+#define DEFAULT_SS_WINDOW 5
+#define DEFAULT_SS_TOLERANCE 20
+#define DEFAULT_SS_SLOPE 10
+#define DEFAULT_SS_MAX_TIME 600
+#define DEFAULT_SWEEP_BS "4K,64K,1M"
+#define DEFAULT_SWEEP_JOBS "1,4"
+#define DEFAULT_SWEEP_QD "1"
+#define DEFAULT_SWEEP_OPS "randread,randwrite"
+#define DEFAULT_SWEEP_TIME 5
+#define MAX_SWEEP_VALUES 32
+#define MAX_SWEEP_QD 256
+#define DEFAULT_KNEE_GAIN 10
+#define DEFAULT_KNEE_TIME 5
+#define DEFAULT_RA_WINDOW (2 * _1MB_BYTES)
 
 /* 测试结果宏 */
 #define TEST_PASS(name) \
@@ -57,17 +99,138 @@ enum fstest_mode {
     TEST_MODE_CONCURRENT = 4,
     TEST_MODE_STRESS = 5,
     TEST_MODE_PERFORMANCE = 6,
+    TEST_MODE_FILESET = 7,
+    TEST_MODE_MDTEST = 8,
+    TEST_MODE_DIRSCALE = 9,
+    TEST_MODE_PATHWALK = 10,
+    TEST_MODE_SHAREDFILE = 11,
+    TEST_MODE_APPEND = 12,
+    TEST_MODE_SPACE = 13,
+    TEST_MODE_WAL = 14,
+    TEST_MODE_REPLACE = 15,
+    TEST_MODE_LOCK = 16,
+    TEST_MODE_XATTR = 17,
+    TEST_MODE_REPLAY = 18,
+    TEST_MODE_AGENT = 19,
+    TEST_MODE_CONTROLLER = 20,
+    TEST_MODE_STEADY = 21,
+    TEST_MODE_SWEEP = 22,
+    TEST_MODE_KNEE = 23,
+    TEST_MODE_READAHEAD = 24,
+    TEST_MODE_ALIGN = 25,
+    TEST_MODE_CALIBRATE = 26,
 };
 
 /* 全局配置结构 */
 struct fstest_config {
     char dir[MAX_PATH_LEN];   /* 测试目录 */
     int jobs;                  /* 并发线程数 */
+    int procs;                 /* worker 以 fork 子进程运行 (--procs) */
+
+    /* 性能测试的重复试验 (-m performance) */
+    int trials;                /* 每个吞吐测试的独立试验次数 */
+    int max_trials;            /* --cv-target 追加试验的上限 */
+    double cv_target;          /* 变异系数目标 (%)，0 表示不追加 */
+    int reject_outliers;       /* 统计前剔除离群试验 */
+    int drop_caches;           /* 每次试验前逐出页缓存 */
+    int residency;             /* 报告测试前后文件驻留页缓存的比例 */
+    int residency_interval;    /* 试验期间的驻留采样间隔 (毫秒)，0 = 不采样 */
+    int calibrate;             /* 先测本机基线，结果按基线折算 */
     size_t io_size;            /* IO 大小 (bytes) */
     size_t file_size;          /* 测试文件大小 (bytes) */
     int iter_count;            /* 迭代次数 */
     enum fstest_mode test_mode; /* 测试模式 (all/functional/...) */
     int verbose;               /* 详细输出 */
+
+    /* fileset 负载参数 (-m fileset) */
+    int fileset_files;         /* 文件集合中的文件数 */
+    int fileset_ops;           /* 每线程每阶段的文件操作数，0 表示自动 */
+    char size_dist[MAX_PATH_LEN]; /* 文件大小分布描述 */
+
+    /* 并行元数据基准参数 (-m mdtest) */
+    int md_shared_dir;         /* 1: 所有线程共享目录树; 0: 每线程独立 */
+    int md_fanout;             /* 目录树每层分支数 */
+    int md_depth;              /* 目录树深度 */
+    int md_items;              /* 每个目录中每线程的条目数 */
+
+    /* 大目录扩展性基准参数 (-m dirscale) */
+    char dir_sizes[MAX_PATH_LEN];  /* 目录条目数列表，如 "1K,10K" */
+    char dents_bufs[MAX_PATH_LEN]; /* getdents64 缓冲区大小列表 */
+
+    /* 路径遍历基准参数 (-m pathwalk) */
+    char path_depths[MAX_PATH_LEN];    /* 目录深度列表 */
+    char path_name_lens[MAX_PATH_LEN]; /* 路径分量长度列表 */
+    char symlink_chains[MAX_PATH_LEN]; /* 符号链接链长度列表 */
+
+    /* 共享文件测试参数 (-m sharedfile) */
+    size_t stride;             /* 交错布局的轮转粒度，0 表示等于 IO 大小 */
+
+    /* 并发追加日志参数 (-m append) */
+    int append_records;        /* 每个写入者追加的记录数 */
+    size_t record_min;         /* 记录大小下限，0 表示等于 IO 大小 */
+    size_t record_max;         /* 记录大小上限 (均匀分布) */
+    int fsync_every;           /* 每多少条记录 fdatasync 一次，0 为不同步 */
+    int append_procs;          /* 写入进程数，每个进程 -j 个线程 */
+
+    /* 空间管理基准参数 (-m space) */
+    size_t falloc_size;        /* 每次 fallocate / 打洞 / 截断的粒度 */
+    size_t sparse_size;        /* 稀疏文件的逻辑大小 */
+    int sparse_writes;         /* 稀疏文件上的随机小写次数 */
+    char sparse_map[MAX_PATH_LEN]; /* 数据 / 空洞模式，如 "4K:60K,1M:1M" */
+    int sparse_extents;        /* 映射测试中的数据段数 */
+
+    /* WAL 提交延迟参数 (-m wal) */
+    int wal_commits;           /* 每线程提交次数 */
+
+    /* 原子替换基准参数 (-m replace) */
+    int replace_ops;           /* 每线程替换次数 */
+
+    /* 文件锁基准参数 (-m lock) */
+    int lock_ops;              /* 每个竞争者的加锁/解锁次数 */
+
+    /* 扩展属性基准参数 (-m xattr) */
+    int xattr_files;                 /* 参与测试的文件数 */
+    char xattr_sizes[MAX_PATH_LEN];  /* 属性值大小列表，如 "16,2K" */
+    char xattr_counts[MAX_PATH_LEN]; /* 每文件属性数列表，如 "1,8" */
+
+    /* 跟踪回放参数 (-m replay) */
+    char trace_file[MAX_PATH_LEN];   /* 二进制跟踪文件 */
+    char strace_file[MAX_PATH_LEN];  /* 先把 strace 输出转换到 trace_file */
+    int replay_afap;                 /* 1 = 忽略原始时间间隔，尽快回放 */
+
+    /* 多节点协同运行参数 (-m agent / -m controller) */
+    int dist_port;                   /* agent 监听端口 / agent 默认端口 */
+    char agents[MAX_PATH_LEN];       /* "host:port,host:port" */
+    int dist_op;                     /* enum test_type */
+    int dist_time;                   /* 每次运行的时长 (秒) */
+
+    /* 稳态检测参数 (-m steady) */
+    int ss_op;                       /* enum test_type */
+    int ss_round;                    /* 每个测量轮次的时长 (秒) */
+    int ss_window;                   /* 判定稳态的连续轮次数 */
+    int ss_tolerance;                /* 数据偏移上限，窗口均值的百分比 */
+    int ss_slope;                    /* 趋势偏移上限，窗口均值的百分比 */
+    int ss_max_time;                 /* 未收敛时的最长运行时间 (秒) */
+
+    /* 参数扫描 (-m sweep)，列表元素可写作 "lo-hi" 表示按 2 倍递增 */
+    char sweep_bs[MAX_PATH_LEN];     /* IO 大小列表，如 "4K-1M" */
+    char sweep_jobs[MAX_PATH_LEN];   /* worker 数列表，如 "1-16" */
+    char sweep_qd[MAX_PATH_LEN];     /* 队列深度列表，如 "1,32" */
+    char sweep_ops[MAX_PATH_LEN];    /* 访问模式列表，如 "randread,seqwrite" */
+    int sweep_time;                  /* 每个点的运行时长 (秒) */
+    int sweep_direct;                /* O_DIRECT */
+    char sweep_csv[MAX_PATH_LEN];    /* 结果另存为 CSV 的路径 */
+
+    /* 饱和点搜索 (-m knee) */
+    int knee_qd;                     /* 1 = 搜索队列深度，0 = 搜索 worker 数 */
+    int knee_op;                     /* enum test_type */
+    int knee_gain;                   /* 每倍增吞吐增益下限 (%) */
+    int knee_p99;                    /* p99 延迟上限 (us)，0 表示不限 */
+    int knee_time;                   /* 每个点的运行时长 (秒) */
+    int knee_max;                    /* 搜索上限，0 表示 jobs 64 / qd 256 */
+
+    /* 预读与 fadvise 效果 (-m readahead) */
+    size_t ra_window;                /* readahead(2) / 读后丢弃的窗口 */
 };
 
 /* 性能测试线程信息 */
@@ -83,6 +246,22 @@ struct test_info {
 
 enum test_type { SEQ_READ, SEQ_WRITE, RAND_READ, RAND_WRITE };
 
+/*
+    延迟直方图：按 2 的幂分段，每段再线性细分 16 个子桶 (相对误差 < 6.25%)
+    结构体大小固定、不含指针，多线程各自记录后可直接相加合并
+*/
+#define LAT_HIST_SUB_BITS 4
+#define LAT_HIST_SUB (1 << LAT_HIST_SUB_BITS)
+#define LAT_HIST_BUCKETS ((64 - LAT_HIST_SUB_BITS + 1) << LAT_HIST_SUB_BITS)
+
+struct lat_hist {
+    uint64_t count;
+    uint64_t sum_ns;
+    uint64_t min_ns;
+    uint64_t max_ns;
+    uint64_t buckets[LAT_HIST_BUCKETS];
+};
+
 /* 工具函数声明 */
 int64_t calculate_time_diff_ns(struct timespec *start, struct timespec *end);
 void fill_rand_buffer(char *buf, size_t size);
@@ -91,5 +270,39 @@ void make_test_path(char *out, size_t out_size, const char *dir,
                     const char *name);
 int ensure_dir_exists(const char *path);
 void remove_dir_recursive(const char *path);
+int parse_size(const char *str, size_t *out);
+int parse_size_list(const char *str, size_t *out, int max_count);
+int parse_range_list(const char *str, size_t *out, int max_count);
+long fiemap_extent_count(int fd);
+long page_cache_resident(int fd, off_t off, size_t len);
+
+/* dio_alignment 的结果来源 */
+enum dio_align_source { DIO_ALIGN_STATX = 0, DIO_ALIGN_PROBED };
+#define DIO_PROBE_MIN_SIZE (128 * _1KB_BYTES)
+int dio_alignment(const char *path, size_t *mem_align, size_t *off_align);
+
+void lat_hist_init(struct lat_hist *h);
+void lat_hist_add(struct lat_hist *h, uint64_t ns);
+void lat_hist_merge(struct lat_hist *dst, const struct lat_hist *src);
+uint64_t lat_hist_percentile(const struct lat_hist *h, double pct);
+void lat_hist_format(const struct lat_hist *h, char *out, size_t out_size);
+
+/*
+    重复试验的样本统计：均值、中位数、样本标准差、变异系数和均值的 95%
+    置信区间 (Student t)。可选按修正 z 分数 (中位数绝对偏差，阈值 3.5)
+    剔除离群值，剔除后的统计只基于保留的样本
+*/
+struct sample_stats {
+    int n;                     /* 参与统计的样本数 */
+    int rejected;              /* 被剔除的离群样本数 */
+    double mean;
+    double median;
+    double stddev;
+    double cv;                 /* stddev / mean */
+    double ci95;               /* 置信区间半宽，mean ± ci95 */
+};
+
+void sample_stats_compute(const double *samples, int n, int reject_outliers,
+                          struct sample_stats *out);
 
 #endif /* FSTEST_COMMON_H */
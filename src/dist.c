@@ -0,0 +1,196 @@
+/*
+    多节点协同运行协议实现
+    阻塞式 socket，定长消息逐字段转换字节序；连接开启 TCP_NODELAY，
+    时钟同步的往返时间不受 Nagle 算法影响
+*/
+
+#include "dist.h"
+
+#include <endian.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+#define DIST_MSG_WIRE_SIZE (8 + DIST_MSG_ARGS * 8)
+#define DIST_HIST_WORDS (4 + LAT_HIST_BUCKETS)
+
+static void dist_set_nodelay(int fd) {
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+}
+
+int dist_listen(int port) {
+    struct addrinfo hints = {0}, *res, *ai;
+    char service[16];
+    snprintf(service, sizeof(service), "%d", port);
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_PASSIVE;
+    int ret = getaddrinfo(NULL, service, &hints, &res);
+    if (ret != 0) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    /* 优先 IPv6 通配地址 (通常同时接受 IPv4)，失败再退回 IPv4 */
+    int fd = -1;
+    for (int pass = 0; pass < 2 && fd < 0; pass++) {
+        for (ai = res; ai; ai = ai->ai_next) {
+            if ((pass == 0) != (ai->ai_family == AF_INET6)) continue;
+            fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+            if (fd < 0) continue;
+            int one = 1;
+            setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+            if (bind(fd, ai->ai_addr, ai->ai_addrlen) == 0 &&
+                listen(fd, 16) == 0) {
+                break;
+            }
+            int saved = errno;
+            close(fd);
+            errno = saved;
+            fd = -1;
+        }
+    }
+    freeaddrinfo(res);
+    return fd;
+}
+
+int dist_connect(const char *addr, int default_port) {
+    char host[MAX_PATH_LEN];
+    char service[16];
+    snprintf(host, sizeof(host), "%s", addr);
+    snprintf(service, sizeof(service), "%d", default_port);
+
+    char *h = host;
+    char *colon = strrchr(host, ':');
+    if (host[0] == '[') {
+        char *close_br = strchr(host, ']');
+        if (!close_br) {
+            errno = EINVAL;
+            return -1;
+        }
+        *close_br = '\0';
+        h = host + 1;
+        if (close_br[1] == ':') {
+            snprintf(service, sizeof(service), "%s", close_br + 2);
+        }
+    } else if (colon && strchr(host, ':') == colon) {
+        *colon = '\0';
+        snprintf(service, sizeof(service), "%s", colon + 1);
+    }
+
+    struct addrinfo hints = {0}, *res, *ai;
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    if (getaddrinfo(h, service, &hints, &res) != 0) {
+        errno = EHOSTUNREACH;
+        return -1;
+    }
+    int fd = -1;
+    for (ai = res; ai; ai = ai->ai_next) {
+        fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (fd < 0) continue;
+        if (connect(fd, ai->ai_addr, ai->ai_addrlen) == 0) break;
+        int saved = errno;
+        close(fd);
+        errno = saved;
+        fd = -1;
+    }
+    freeaddrinfo(res);
+    if (fd >= 0) dist_set_nodelay(fd);
+    return fd;
+}
+
+static int send_all(int fd, const void *buf, size_t len) {
+    const char *p = buf;
+    while (len > 0) {
+        ssize_t ret = send(fd, p, len, MSG_NOSIGNAL);
+        if (ret < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        p += ret;
+        len -= ret;
+    }
+    return 0;
+}
+
+static int recv_all(int fd, void *buf, size_t len) {
+    char *p = buf;
+    while (len > 0) {
+        ssize_t ret = recv(fd, p, len, 0);
+        if (ret < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        if (ret == 0) {
+            errno = ECONNRESET;
+            return -1;
+        }
+        p += ret;
+        len -= ret;
+    }
+    return 0;
+}
+
+int dist_send_msg(int fd, uint32_t type, const uint64_t *args) {
+    uint32_t head[2] = {htobe32(DIST_MAGIC), htobe32(type)};
+    uint64_t body[DIST_MSG_ARGS];
+    char wire[DIST_MSG_WIRE_SIZE];
+    for (int i = 0; i < DIST_MSG_ARGS; i++) {
+        body[i] = htobe64(args ? args[i] : 0);
+    }
+    memcpy(wire, head, sizeof(head));
+    memcpy(wire + sizeof(head), body, sizeof(body));
+    return send_all(fd, wire, sizeof(wire));
+}
+
+int dist_recv_msg(int fd, struct dist_msg *msg) {
+    uint32_t head[2];
+    uint64_t body[DIST_MSG_ARGS];
+    char wire[DIST_MSG_WIRE_SIZE];
+    if (recv_all(fd, wire, sizeof(wire)) != 0) return -1;
+    memcpy(head, wire, sizeof(head));
+    memcpy(body, wire + sizeof(head), sizeof(body));
+    msg->magic = be32toh(head[0]);
+    msg->type = be32toh(head[1]);
+    for (int i = 0; i < DIST_MSG_ARGS; i++) msg->arg[i] = be64toh(body[i]);
+    if (msg->magic != DIST_MAGIC) {
+        errno = EPROTO;
+        return -1;
+    }
+    return 0;
+}
+
+int dist_send_hist(int fd, const struct lat_hist *h) {
+    uint64_t *wire = malloc(DIST_HIST_WORDS * sizeof(uint64_t));
+    if (!wire) return -1;
+    wire[0] = htobe64(h->count);
+    wire[1] = htobe64(h->sum_ns);
+    wire[2] = htobe64(h->min_ns);
+    wire[3] = htobe64(h->max_ns);
+    for (int i = 0; i < LAT_HIST_BUCKETS; i++) {
+        wire[4 + i] = htobe64(h->buckets[i]);
+    }
+    int ret = send_all(fd, wire, DIST_HIST_WORDS * sizeof(uint64_t));
+    free(wire);
+    return ret;
+}
+
+int dist_recv_hist(int fd, struct lat_hist *h) {
+    uint64_t *wire = malloc(DIST_HIST_WORDS * sizeof(uint64_t));
+    if (!wire) return -1;
+    int ret = recv_all(fd, wire, DIST_HIST_WORDS * sizeof(uint64_t));
+    if (ret == 0) {
+        h->count = be64toh(wire[0]);
+        h->sum_ns = be64toh(wire[1]);
+        h->min_ns = be64toh(wire[2]);
+        h->max_ns = be64toh(wire[3]);
+        for (int i = 0; i < LAT_HIST_BUCKETS; i++) {
+            h->buckets[i] = be64toh(wire[4 + i]);
+        }
+    }
+    free(wire);
+    return ret;
+}
@@ -0,0 +1,63 @@
+/*
+    多节点协同运行协议
+    controller 通过 TCP 向各个 agent 下发负载、同步时钟、统一发令并回收结果
+    消息为定长结构，所有字段按网络字节序 (大端) 编码，延迟直方图随结果一起
+    原样传回，controller 直接合并
+*/
+
+#ifndef FSTEST_DIST_H
+#define FSTEST_DIST_H
+
+#include "common.h"
+
+#define DIST_MAGIC 0x46535444u /* "FSTD" */
+#define DIST_VERSION 1
+#define DIST_MSG_ARGS 8
+
+enum dist_msg_type {
+    DIST_HELLO = 1, /* ctl -> agent: 负载描述，见 dist_hello_arg */
+    DIST_READY,     /* agent -> ctl: arg[0] = 0 或 errno (准备失败) */
+    DIST_PING,      /* ctl -> agent: arg[0] = controller 时间 */
+    DIST_PONG,      /* agent -> ctl: arg[0] = agent 时间 */
+    DIST_START,     /* ctl -> agent: arg[0] = agent 时钟下的出发时刻 */
+    DIST_RESULT,    /* agent -> ctl: 见 dist_result_arg，后跟延迟直方图 */
+};
+
+enum dist_hello_arg {
+    DIST_H_VERSION = 0,
+    DIST_H_NODE,               /* 节点编号，决定 agent 端的工作目录 */
+    DIST_H_OP,                 /* enum test_type */
+    DIST_H_JOBS,
+    DIST_H_IO_SIZE,
+    DIST_H_FILE_SIZE,
+    DIST_H_DURATION_NS,
+    DIST_H_PROCS,
+};
+
+enum dist_result_arg {
+    DIST_R_STATUS = 0,         /* 0 或 errno */
+    DIST_R_BYTES,
+    DIST_R_OPS,
+    DIST_R_ERRORS,
+    DIST_R_START_NS,           /* agent 时钟下最早出发时刻 */
+    DIST_R_END_NS,             /* agent 时钟下最晚结束时刻 */
+};
+
+struct dist_msg {
+    uint32_t magic;
+    uint32_t type;
+    uint64_t arg[DIST_MSG_ARGS];
+};
+
+/* 监听本机所有地址上的 port，返回监听 fd 或 -1 */
+int dist_listen(int port);
+/* 连接 "host:port" / "[v6addr]:port"，省略端口时用 default_port */
+int dist_connect(const char *addr, int default_port);
+
+/* 成功返回 0，失败返回 -1 并设置 errno；对端关闭视为 ECONNRESET */
+int dist_send_msg(int fd, uint32_t type, const uint64_t *args);
+int dist_recv_msg(int fd, struct dist_msg *msg);
+int dist_send_hist(int fd, const struct lat_hist *h);
+int dist_recv_hist(int fd, struct lat_hist *h);
+
+#endif /* FSTEST_DIST_H */
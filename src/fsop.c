@@ -0,0 +1,369 @@
+/*
+    文件操作插桩层实现
+    每个线程第一次调用封装时分配自己的统计块并挂到活动链表上；线程退出时
+    通过 pthread key 的析构函数把统计块合并进全局累计并释放。记录统计只
+    访问本线程的块，不加锁；调用方看到的 errno 保持系统调用返回时的值
+*/
+
+#include "fsop.h"
+
+#include <stdarg.h>
+#include <sys/file.h>
+
+#include "timer.h"
+
+#define FSOP_MAX_ERRNO 134
+
+struct fsop_stat {
+    uint64_t count;
+    uint64_t bytes;
+    uint64_t errors;
+    uint32_t errnos[FSOP_MAX_ERRNO]; /* 超出范围的 errno 记在 [0] */
+    struct lat_hist lat;
+};
+
+struct fsop_block {
+    struct fsop_stat ops[FSOP_COUNT];
+    struct fsop_block *prev;
+    struct fsop_block *next;
+};
+
+static const char *const fsop_names[FSOP_COUNT] = {
+    [FSOP_OPEN] = "open",         [FSOP_CLOSE] = "close",
+    [FSOP_READ] = "read",         [FSOP_WRITE] = "write",
+    [FSOP_PREAD] = "pread",       [FSOP_PWRITE] = "pwrite",
+    [FSOP_LSEEK] = "lseek",       [FSOP_FSYNC] = "fsync",
+    [FSOP_FDATASYNC] = "fdatasync", [FSOP_FTRUNCATE] = "ftruncate",
+    [FSOP_TRUNCATE] = "truncate", [FSOP_STAT] = "stat",
+    [FSOP_FSTAT] = "fstat",       [FSOP_LSTAT] = "lstat",
+    [FSOP_RENAME] = "rename",     [FSOP_UNLINK] = "unlink",
+    [FSOP_MKDIR] = "mkdir",       [FSOP_RMDIR] = "rmdir",
+    [FSOP_LINK] = "link",         [FSOP_SYMLINK] = "symlink",
+    [FSOP_READLINK] = "readlink", [FSOP_ACCESS] = "access",
+    [FSOP_CHMOD] = "chmod",       [FSOP_UTIMENSAT] = "utimensat",
+    [FSOP_FLOCK] = "flock",       [FSOP_MMAP] = "mmap",
+    [FSOP_MUNMAP] = "munmap",     [FSOP_MSYNC] = "msync",
+};
+
+int fsop_enabled = 1;
+
+static pthread_mutex_t fsop_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t fsop_once = PTHREAD_ONCE_INIT;
+static pthread_key_t fsop_key;
+static struct fsop_block fsop_total; /* 已退出线程的累计 */
+static struct fsop_block *fsop_live; /* 仍在运行的线程 */
+static __thread struct fsop_block *fsop_self;
+
+static void fsop_block_init(struct fsop_block *b) {
+    memset(b->ops, 0, sizeof(b->ops));
+    for (int op = 0; op < FSOP_COUNT; op++) lat_hist_init(&b->ops[op].lat);
+}
+
+static void fsop_block_merge(struct fsop_block *dst,
+                             const struct fsop_block *src) {
+    for (int op = 0; op < FSOP_COUNT; op++) {
+        const struct fsop_stat *s = &src->ops[op];
+        struct fsop_stat *d = &dst->ops[op];
+        if (s->count == 0) continue;
+        d->count += s->count;
+        d->bytes += s->bytes;
+        d->errors += s->errors;
+        for (int e = 0; e < FSOP_MAX_ERRNO; e++) d->errnos[e] += s->errnos[e];
+        lat_hist_merge(&d->lat, &s->lat);
+    }
+}
+
+static void fsop_thread_exit(void *arg) {
+    struct fsop_block *b = arg;
+    pthread_mutex_lock(&fsop_lock);
+    fsop_block_merge(&fsop_total, b);
+    if (b->prev) b->prev->next = b->next;
+    else fsop_live = b->next;
+    if (b->next) b->next->prev = b->prev;
+    pthread_mutex_unlock(&fsop_lock);
+    free(b);
+}
+
+static void fsop_init_once(void) {
+    pthread_key_create(&fsop_key, fsop_thread_exit);
+    fsop_block_init(&fsop_total);
+}
+
+static struct fsop_block *fsop_get(void) {
+    if (fsop_self) return fsop_self;
+    pthread_once(&fsop_once, fsop_init_once);
+    struct fsop_block *b = malloc(sizeof(*b));
+    if (!b) return NULL;
+    fsop_block_init(b);
+    pthread_mutex_lock(&fsop_lock);
+    b->prev = NULL;
+    b->next = fsop_live;
+    if (fsop_live) fsop_live->prev = b;
+    fsop_live = b;
+    pthread_mutex_unlock(&fsop_lock);
+    pthread_setspecific(fsop_key, b);
+    fsop_self = b;
+    return b;
+}
+
+static void fsop_done(enum fsop_op op, uint64_t t0, int failed, size_t bytes) {
+    int saved_errno = errno;
+    uint64_t t1 = timer_now();
+    struct fsop_block *b = fsop_get();
+    if (b) {
+        struct fsop_stat *s = &b->ops[op];
+        s->count++;
+        if (failed) {
+            s->errors++;
+            s->errnos[saved_errno > 0 && saved_errno < FSOP_MAX_ERRNO
+                          ? saved_errno
+                          : 0]++;
+        } else {
+            s->bytes += bytes;
+        }
+        lat_hist_add(&s->lat, timer_diff_ns(t0, t1));
+    }
+    errno = saved_errno;
+}
+
+/* 计时调用 call，failed / bytes 表达式中可以使用返回值 ret */
+#define FSOP_WRAP(op, type, call, failed, bytes) \
+    do {                                         \
+        if (!fsop_enabled) return call;          \
+        uint64_t t0 = timer_now();               \
+        type ret = call;                         \
+        fsop_done(op, t0, (failed), (bytes));    \
+        return ret;                              \
+    } while (0)
+
+int fs_open(const char *path, int flags, ...) {
+    mode_t mode = 0;
+    /* O_TMPFILE 包含 O_DIRECTORY 位，须整体匹配，与 glibc 的判断一致 */
+    if ((flags & O_CREAT) || (flags & O_TMPFILE) == O_TMPFILE) {
+        va_list ap;
+        va_start(ap, flags);
+        mode = (mode_t)va_arg(ap, int);
+        va_end(ap);
+    }
+    FSOP_WRAP(FSOP_OPEN, int, open(path, flags, mode), ret < 0, 0);
+}
+
+int fs_close(int fd) {
+    FSOP_WRAP(FSOP_CLOSE, int, close(fd), ret < 0, 0);
+}
+
+ssize_t fs_read(int fd, void *buf, size_t count) {
+    FSOP_WRAP(FSOP_READ, ssize_t, read(fd, buf, count), ret < 0,
+              ret > 0 ? (size_t)ret : 0);
+}
+
+ssize_t fs_write(int fd, const void *buf, size_t count) {
+    FSOP_WRAP(FSOP_WRITE, ssize_t, write(fd, buf, count), ret < 0,
+              ret > 0 ? (size_t)ret : 0);
+}
+
+ssize_t fs_pread(int fd, void *buf, size_t count, off_t offset) {
+    FSOP_WRAP(FSOP_PREAD, ssize_t, pread(fd, buf, count, offset), ret < 0,
+              ret > 0 ? (size_t)ret : 0);
+}
+
+ssize_t fs_pwrite(int fd, const void *buf, size_t count, off_t offset) {
+    FSOP_WRAP(FSOP_PWRITE, ssize_t, pwrite(fd, buf, count, offset), ret < 0,
+              ret > 0 ? (size_t)ret : 0);
+}
+
+off_t fs_lseek(int fd, off_t offset, int whence) {
+    FSOP_WRAP(FSOP_LSEEK, off_t, lseek(fd, offset, whence), ret < 0, 0);
+}
+
+int fs_fsync(int fd) {
+    FSOP_WRAP(FSOP_FSYNC, int, fsync(fd), ret < 0, 0);
+}
+
+int fs_fdatasync(int fd) {
+    FSOP_WRAP(FSOP_FDATASYNC, int, fdatasync(fd), ret < 0, 0);
+}
+
+int fs_ftruncate(int fd, off_t length) {
+    FSOP_WRAP(FSOP_FTRUNCATE, int, ftruncate(fd, length), ret < 0, 0);
+}
+
+int fs_truncate(const char *path, off_t length) {
+    FSOP_WRAP(FSOP_TRUNCATE, int, truncate(path, length), ret < 0, 0);
+}
+
+int fs_stat(const char *path, struct stat *st) {
+    FSOP_WRAP(FSOP_STAT, int, stat(path, st), ret < 0, 0);
+}
+
+int fs_fstat(int fd, struct stat *st) {
+    FSOP_WRAP(FSOP_FSTAT, int, fstat(fd, st), ret < 0, 0);
+}
+
+int fs_lstat(const char *path, struct stat *st) {
+    FSOP_WRAP(FSOP_LSTAT, int, lstat(path, st), ret < 0, 0);
+}
+
+int fs_rename(const char *oldpath, const char *newpath) {
+    FSOP_WRAP(FSOP_RENAME, int, rename(oldpath, newpath), ret < 0, 0);
+}
+
+int fs_unlink(const char *path) {
+    FSOP_WRAP(FSOP_UNLINK, int, unlink(path), ret < 0, 0);
+}
+
+int fs_mkdir(const char *path, mode_t mode) {
+    FSOP_WRAP(FSOP_MKDIR, int, mkdir(path, mode), ret < 0, 0);
+}
+
+int fs_rmdir(const char *path) {
+    FSOP_WRAP(FSOP_RMDIR, int, rmdir(path), ret < 0, 0);
+}
+
+int fs_link(const char *oldpath, const char *newpath) {
+    FSOP_WRAP(FSOP_LINK, int, link(oldpath, newpath), ret < 0, 0);
+}
+
+int fs_symlink(const char *target, const char *linkpath) {
+    FSOP_WRAP(FSOP_SYMLINK, int, symlink(target, linkpath), ret < 0, 0);
+}
+
+ssize_t fs_readlink(const char *path, char *buf, size_t size) {
+    FSOP_WRAP(FSOP_READLINK, ssize_t, readlink(path, buf, size), ret < 0, 0);
+}
+
+int fs_access(const char *path, int mode) {
+    FSOP_WRAP(FSOP_ACCESS, int, access(path, mode), ret < 0, 0);
+}
+
+int fs_chmod(const char *path, mode_t mode) {
+    FSOP_WRAP(FSOP_CHMOD, int, chmod(path, mode), ret < 0, 0);
+}
+
+int fs_utimensat(int dirfd, const char *path, const struct timespec times[2],
+                 int flags) {
+    FSOP_WRAP(FSOP_UTIMENSAT, int, utimensat(dirfd, path, times, flags),
+              ret < 0, 0);
+}
+
+int fs_flock(int fd, int operation) {
+    FSOP_WRAP(FSOP_FLOCK, int, flock(fd, operation), ret < 0, 0);
+}
+
+void *fs_mmap(void *addr, size_t length, int prot, int flags, int fd,
+              off_t offset) {
+    FSOP_WRAP(FSOP_MMAP, void *, mmap(addr, length, prot, flags, fd, offset),
+              ret == MAP_FAILED, 0);
+}
+
+int fs_munmap(void *addr, size_t length) {
+    FSOP_WRAP(FSOP_MUNMAP, int, munmap(addr, length), ret < 0, 0);
+}
+
+int fs_msync(void *addr, size_t length, int flags) {
+    FSOP_WRAP(FSOP_MSYNC, int, msync(addr, length, flags), ret < 0, 0);
+}
+
+void fsop_reset(void) {
+    pthread_once(&fsop_once, fsop_init_once);
+    pthread_mutex_lock(&fsop_lock);
+    fsop_block_init(&fsop_total);
+    for (struct fsop_block *b = fsop_live; b; b = b->next) {
+        fsop_block_init(b);
+    }
+    pthread_mutex_unlock(&fsop_lock);
+}
+
+size_t fsop_export_size(void) {
+    return sizeof(struct fsop_block);
+}
+
+void fsop_export(void *dst) {
+    struct fsop_block *out = dst;
+    pthread_once(&fsop_once, fsop_init_once);
+    fsop_block_init(out);
+    pthread_mutex_lock(&fsop_lock);
+    fsop_block_merge(out, &fsop_total);
+    for (struct fsop_block *b = fsop_live; b; b = b->next) {
+        fsop_block_merge(out, b);
+    }
+    pthread_mutex_unlock(&fsop_lock);
+    out->prev = out->next = NULL;
+}
+
+void fsop_import(const void *src) {
+    pthread_once(&fsop_once, fsop_init_once);
+    pthread_mutex_lock(&fsop_lock);
+    fsop_block_merge(&fsop_total, src);
+    pthread_mutex_unlock(&fsop_lock);
+}
+
+static const char *fsop_errno_name(int err) {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 32)
+    const char *name = err > 0 ? strerrorname_np(err) : NULL;
+    if (name) return name;
+#endif
+    return err > 0 ? strerror(err) : "other";
+}
+
+void fsop_print_profile(const char *module) {
+    if (!fsop_enabled) return;
+    pthread_once(&fsop_once, fsop_init_once);
+
+    struct fsop_block *sum = malloc(sizeof(*sum));
+    if (!sum) return;
+    fsop_block_init(sum);
+    pthread_mutex_lock(&fsop_lock);
+    fsop_block_merge(sum, &fsop_total);
+    for (struct fsop_block *b = fsop_live; b; b = b->next) {
+        fsop_block_merge(sum, b);
+    }
+    pthread_mutex_unlock(&fsop_lock);
+
+    /* 按累计耗时从高到低排列 */
+    int order[FSOP_COUNT], n = 0;
+    uint64_t calls = 0, total_ns = 0;
+    for (int op = 0; op < FSOP_COUNT; op++) {
+        if (sum->ops[op].count == 0) continue;
+        int i = n++;
+        while (i > 0 &&
+               sum->ops[order[i - 1]].lat.sum_ns < sum->ops[op].lat.sum_ns) {
+            order[i] = order[i - 1];
+            i--;
+        }
+        order[i] = op;
+        calls += sum->ops[op].count;
+        total_ns += sum->ops[op].lat.sum_ns;
+    }
+    if (n == 0) {
+        free(sum);
+        return;
+    }
+
+    printf("\n  --- 系统调用剖析 (Syscall Profile: %s) ---\n", module);
+    printf("  %-10s | %9s | %6s | %9s | %9s | %5s | latency\n", "op", "calls",
+           "errors", "MB", "total ms", "time%");
+    for (int i = 0; i < n; i++) {
+        const struct fsop_stat *s = &sum->ops[order[i]];
+        char lat[160];
+        lat_hist_format(&s->lat, lat, sizeof(lat));
+        printf("  %-10s | %9llu | %6llu | %9.1f | %9.1f | %5.1f | %s\n",
+               fsop_names[order[i]], (unsigned long long)s->count,
+               (unsigned long long)s->errors, s->bytes / (double)_1MB_BYTES,
+               s->lat.sum_ns / 1e6,
+               total_ns ? 100.0 * s->lat.sum_ns / total_ns : 0.0, lat);
+    }
+    for (int i = 0; i < n; i++) {
+        const struct fsop_stat *s = &sum->ops[order[i]];
+        if (s->errors == 0) continue;
+        printf("  %-10s errors:", fsop_names[order[i]]);
+        for (int e = 0; e < FSOP_MAX_ERRNO; e++) {
+            if (s->errnos[e] == 0) continue;
+            printf(" %s x%u", fsop_errno_name(e), s->errnos[e]);
+        }
+        printf("\n");
+    }
+    printf("  Total: %llu calls, %.1f ms in syscalls\n",
+           (unsigned long long)calls, total_ns / 1e6);
+    free(sum);
+}
@@ -0,0 +1,90 @@
+/*
+    文件操作插桩层
+    对常用文件系统调用的薄封装：按操作类型统计调用次数、字节数、按 errno
+    分类的错误数和延迟直方图。统计按线程累积，线程退出时合并，热路径无锁
+    main 在每个测试模块结束后打印该模块的系统调用剖析
+*/
+
+#ifndef FSTEST_FSOP_H
+#define FSTEST_FSOP_H
+
+#include "common.h"
+
+#include <sys/mman.h>
+
+enum fsop_op {
+    FSOP_OPEN = 0,
+    FSOP_CLOSE,
+    FSOP_READ,
+    FSOP_WRITE,
+    FSOP_PREAD,
+    FSOP_PWRITE,
+    FSOP_LSEEK,
+    FSOP_FSYNC,
+    FSOP_FDATASYNC,
+    FSOP_FTRUNCATE,
+    FSOP_TRUNCATE,
+    FSOP_STAT,
+    FSOP_FSTAT,
+    FSOP_LSTAT,
+    FSOP_RENAME,
+    FSOP_UNLINK,
+    FSOP_MKDIR,
+    FSOP_RMDIR,
+    FSOP_LINK,
+    FSOP_SYMLINK,
+    FSOP_READLINK,
+    FSOP_ACCESS,
+    FSOP_CHMOD,
+    FSOP_UTIMENSAT,
+    FSOP_FLOCK,
+    FSOP_MMAP,
+    FSOP_MUNMAP,
+    FSOP_MSYNC,
+    FSOP_COUNT
+};
+
+/* 0 = 封装直接转发，不计时不统计 (--no-io-profile) */
+extern int fsop_enabled;
+
+int fs_open(const char *path, int flags, ...);
+int fs_close(int fd);
+ssize_t fs_read(int fd, void *buf, size_t count);
+ssize_t fs_write(int fd, const void *buf, size_t count);
+ssize_t fs_pread(int fd, void *buf, size_t count, off_t offset);
+ssize_t fs_pwrite(int fd, const void *buf, size_t count, off_t offset);
+off_t fs_lseek(int fd, off_t offset, int whence);
+int fs_fsync(int fd);
+int fs_fdatasync(int fd);
+int fs_ftruncate(int fd, off_t length);
+int fs_truncate(const char *path, off_t length);
+int fs_stat(const char *path, struct stat *st);
+int fs_fstat(int fd, struct stat *st);
+int fs_lstat(const char *path, struct stat *st);
+int fs_rename(const char *oldpath, const char *newpath);
+int fs_unlink(const char *path);
+int fs_mkdir(const char *path, mode_t mode);
+int fs_rmdir(const char *path);
+int fs_link(const char *oldpath, const char *newpath);
+int fs_symlink(const char *target, const char *linkpath);
+ssize_t fs_readlink(const char *path, char *buf, size_t size);
+int fs_access(const char *path, int mode);
+int fs_chmod(const char *path, mode_t mode);
+int fs_utimensat(int dirfd, const char *path, const struct timespec times[2],
+                 int flags);
+int fs_flock(int fd, int operation);
+void *fs_mmap(void *addr, size_t length, int prot, int flags, int fd,
+              off_t offset);
+int fs_munmap(void *addr, size_t length);
+int fs_msync(void *addr, size_t length, int flags);
+
+/* 清空统计 / 打印自上次清空以来的剖析 (没有调用时不输出) */
+void fsop_reset(void);
+void fsop_print_profile(const char *module);
+
+/* 进程模式 worker 使用：子进程导出自己的统计，父进程合并 */
+size_t fsop_export_size(void);
+void fsop_export(void *dst);
+void fsop_import(const void *src);
+
+#endif /* FSTEST_FSOP_H */
@@ -14,6 +14,26 @@
             concurrent  : 并发测试
             stress      : 压力和稳定性测试
             performance : 性能测试
+            fileset     : 小文件集合负载 (不含在 all 中)
+            mdtest      : 并行元数据基准 (不含在 all 中)
+            dirscale    : 大目录扩展性基准 (不含在 all 中)
+            pathwalk    : 路径遍历开销基准 (不含在 all 中)
+            sharedfile  : 共享文件扩展性测试 (不含在 all 中)
+            append      : 并发追加日志测试 (不含在 all 中)
+            space       : 空间管理基准 (不含在 all 中)
+            wal         : WAL 提交延迟测试 (不含在 all 中)
+            replace     : 原子替换基准 (不含在 all 中)
+            lock        : 文件锁性能测试 (不含在 all 中)
+            xattr       : 扩展属性性能测试 (不含在 all 中)
+            replay      : 跟踪回放 (不含在 all 中)
+            agent       : 多节点 agent (不含在 all 中)
+            controller  : 多节点 controller (不含在 all 中)
+            steady      : 稳态检测 (不含在 all 中)
+            sweep       : 参数扫描 (不含在 all 中)
+            knee        : 饱和点搜索 (不含在 all 中)
+            readahead   : 预读与 fadvise 效果 (不含在 all 中)
+            align       : 对齐代价 (不含在 all 中)
+            calibrate   : 基线校准 (不含在 all 中)
 
     示例：
             ./fstest -d /tmp/fstest_data -m all                 # 运行所有测试
@@ -21,13 +41,236 @@
             ./fstest -d /tmp/fstest_data -m functional         # 仅功能正确性测试
 */
 
+#include <getopt.h>
+
 #include "common.h"
+#include "fsop.h"
+#include "test_append.h"
 #include "test_concurrent.h"
 #include "test_consistency.h"
+#include "test_dirscale.h"
+#include "test_dist.h"
 #include "test_exception.h"
+#include "test_fileset.h"
 #include "test_functional.h"
+#include "test_lock.h"
+#include "test_mdtest.h"
+#include "test_pathwalk.h"
 #include "test_performance.h"
+#include "test_replace.h"
+#include "test_replay.h"
+#include "test_space.h"
+#include "test_steady.h"
+#include "test_sweep.h"
+#include "test_knee.h"
+#include "test_readahead.h"
+#include "test_align.h"
+#include "test_calibrate.h"
 #include "test_stress.h"
+#include "test_wal.h"
+#include "test_xattr.h"
+#include "timed_io.h"
+#include "timer.h"
+
+struct mode_entry {
+    enum fstest_mode mode;
+    const char *key;      /* 英文模式名 */
+    const char *alias;    /* 历史数字别名，新模式没有别名 */
+    const char *name;     /* 中文说明 */
+    void (*run)(const struct fstest_config *cfg);
+    int in_all;           /* 是否包含在 all 模式中 */
+};
+
+/*
+    模式表：前 6 个类别组成 all；其后的扩展基准负载耗时较长或需要专门参数，
+    只在通过 -m 显式指定时运行
+*/
+static const struct mode_entry mode_table[] = {
+    {TEST_MODE_ALL, "all", "0", "所有测试", NULL, 0},
+    {TEST_MODE_FUNCTIONAL, "functional", "1", "功能正确性测试",
+     run_functional_tests, 1},
+    {TEST_MODE_CONSISTENCY, "consistency", "2", "数据一致性测试",
+     run_consistency_tests, 1},
+    {TEST_MODE_EXCEPTION, "exception", "3", "异常场景测试",
+     run_exception_tests, 1},
+    {TEST_MODE_CONCURRENT, "concurrent", "4", "并发测试",
+     run_concurrent_tests, 1},
+    {TEST_MODE_STRESS, "stress", "5", "压力和稳定性测试", run_stress_tests, 1},
+    {TEST_MODE_PERFORMANCE, "performance", "6", "性能测试",
+     run_performance_tests, 1},
+    {TEST_MODE_FILESET, "fileset", NULL, "小文件集合负载", run_fileset_tests,
+     0},
+    {TEST_MODE_MDTEST, "mdtest", NULL, "并行元数据基准", run_mdtest_tests, 0},
+    {TEST_MODE_DIRSCALE, "dirscale", NULL, "大目录扩展性基准",
+     run_dirscale_tests, 0},
+    {TEST_MODE_PATHWALK, "pathwalk", NULL, "路径遍历开销基准",
+     run_pathwalk_tests, 0},
+    {TEST_MODE_SHAREDFILE, "sharedfile", NULL, "共享文件扩展性测试",
+     run_sharedfile_tests, 0},
+    {TEST_MODE_APPEND, "append", NULL, "并发追加日志测试", run_append_tests,
+     0},
+    {TEST_MODE_SPACE, "space", NULL, "空间管理基准", run_space_tests, 0},
+    {TEST_MODE_WAL, "wal", NULL, "WAL 提交延迟测试", run_wal_tests, 0},
+    {TEST_MODE_REPLACE, "replace", NULL, "原子替换基准", run_replace_tests,
+     0},
+    {TEST_MODE_LOCK, "lock", NULL, "文件锁性能测试", run_lock_tests, 0},
+    {TEST_MODE_XATTR, "xattr", NULL, "扩展属性性能测试", run_xattr_tests, 0},
+    {TEST_MODE_REPLAY, "replay", NULL, "跟踪回放", run_replay_tests, 0},
+    {TEST_MODE_AGENT, "agent", NULL, "多节点 agent", run_agent_tests, 0},
+    {TEST_MODE_CONTROLLER, "controller", NULL, "多节点 controller",
+     run_controller_tests, 0},
+    {TEST_MODE_STEADY, "steady", NULL, "稳态检测", run_steady_tests, 0},
+    {TEST_MODE_SWEEP, "sweep", NULL, "参数扫描", run_sweep_tests, 0},
+    {TEST_MODE_KNEE, "knee", NULL, "饱和点搜索", run_knee_tests, 0},
+    {TEST_MODE_READAHEAD, "readahead", NULL, "预读与 fadvise 效果",
+     run_readahead_tests, 0},
+    {TEST_MODE_ALIGN, "align", NULL, "对齐代价", run_align_tests, 0},
+    {TEST_MODE_CALIBRATE, "calibrate", NULL, "基线校准", run_calibrate_tests,
+     0},
+};
+
+#define MODE_COUNT ((int)(sizeof(mode_table) / sizeof(mode_table[0])))
+
+/* 长选项编号，从 256 开始以避开短选项字符 */
+enum long_option_id {
+    OPT_FILESET_FILES = 256,
+    OPT_FILESET_OPS,
+    OPT_SIZE_DIST,
+    OPT_MD_LAYOUT,
+    OPT_MD_FANOUT,
+    OPT_MD_DEPTH,
+    OPT_MD_ITEMS,
+    OPT_DIR_SIZES,
+    OPT_DENTS_BUFS,
+    OPT_PATH_DEPTHS,
+    OPT_PATH_NAME_LENS,
+    OPT_SYMLINK_CHAINS,
+    OPT_STRIDE,
+    OPT_APPEND_RECORDS,
+    OPT_RECORD_SIZE,
+    OPT_FSYNC_EVERY,
+    OPT_APPEND_PROCS,
+    OPT_FALLOC_SIZE,
+    OPT_SPARSE_SIZE,
+    OPT_SPARSE_WRITES,
+    OPT_WAL_COMMITS,
+    OPT_REPLACE_OPS,
+    OPT_LOCK_OPS,
+    OPT_XATTR_FILES,
+    OPT_XATTR_SIZES,
+    OPT_XATTR_COUNTS,
+    OPT_TRACE,
+    OPT_STRACE,
+    OPT_REPLAY_AFAP,
+    OPT_NO_IO_PROFILE,
+    OPT_PROCS,
+    OPT_DIST_PORT,
+    OPT_AGENTS,
+    OPT_DIST_OP,
+    OPT_DIST_TIME,
+    OPT_SS_OP,
+    OPT_SS_ROUND,
+    OPT_SS_WINDOW,
+    OPT_SS_TOLERANCE,
+    OPT_SS_SLOPE,
+    OPT_SS_MAX_TIME,
+    OPT_TRIALS,
+    OPT_MAX_TRIALS,
+    OPT_CV_TARGET,
+    OPT_REJECT_OUTLIERS,
+    OPT_DROP_CACHES,
+    OPT_SWEEP_BS,
+    OPT_SWEEP_JOBS,
+    OPT_SWEEP_QD,
+    OPT_SWEEP_OPS,
+    OPT_SWEEP_TIME,
+    OPT_SWEEP_DIRECT,
+    OPT_SWEEP_CSV,
+    OPT_KNEE_PARAM,
+    OPT_KNEE_OP,
+    OPT_KNEE_GAIN,
+    OPT_KNEE_P99,
+    OPT_KNEE_TIME,
+    OPT_KNEE_MAX,
+    OPT_SPARSE_MAP,
+    OPT_SPARSE_EXTENTS,
+    OPT_RA_WINDOW,
+    OPT_RESIDENCY,
+    OPT_RESIDENCY_INTERVAL,
+    OPT_CALIBRATE,
+    OPT_TIMER,
+};
+
+static const struct option long_options[] = {
+    {"fileset-files", required_argument, NULL, OPT_FILESET_FILES},
+    {"fileset-ops", required_argument, NULL, OPT_FILESET_OPS},
+    {"size-dist", required_argument, NULL, OPT_SIZE_DIST},
+    {"md-layout", required_argument, NULL, OPT_MD_LAYOUT},
+    {"md-fanout", required_argument, NULL, OPT_MD_FANOUT},
+    {"md-depth", required_argument, NULL, OPT_MD_DEPTH},
+    {"md-items", required_argument, NULL, OPT_MD_ITEMS},
+    {"dir-sizes", required_argument, NULL, OPT_DIR_SIZES},
+    {"dents-bufs", required_argument, NULL, OPT_DENTS_BUFS},
+    {"path-depths", required_argument, NULL, OPT_PATH_DEPTHS},
+    {"path-name-lens", required_argument, NULL, OPT_PATH_NAME_LENS},
+    {"symlink-chains", required_argument, NULL, OPT_SYMLINK_CHAINS},
+    {"stride", required_argument, NULL, OPT_STRIDE},
+    {"append-records", required_argument, NULL, OPT_APPEND_RECORDS},
+    {"record-size", required_argument, NULL, OPT_RECORD_SIZE},
+    {"fsync-every", required_argument, NULL, OPT_FSYNC_EVERY},
+    {"append-procs", required_argument, NULL, OPT_APPEND_PROCS},
+    {"falloc-size", required_argument, NULL, OPT_FALLOC_SIZE},
+    {"sparse-size", required_argument, NULL, OPT_SPARSE_SIZE},
+    {"sparse-writes", required_argument, NULL, OPT_SPARSE_WRITES},
+    {"sparse-map", required_argument, NULL, OPT_SPARSE_MAP},
+    {"sparse-extents", required_argument, NULL, OPT_SPARSE_EXTENTS},
+    {"wal-commits", required_argument, NULL, OPT_WAL_COMMITS},
+    {"replace-ops", required_argument, NULL, OPT_REPLACE_OPS},
+    {"lock-ops", required_argument, NULL, OPT_LOCK_OPS},
+    {"xattr-files", required_argument, NULL, OPT_XATTR_FILES},
+    {"xattr-sizes", required_argument, NULL, OPT_XATTR_SIZES},
+    {"xattr-counts", required_argument, NULL, OPT_XATTR_COUNTS},
+    {"trace", required_argument, NULL, OPT_TRACE},
+    {"strace", required_argument, NULL, OPT_STRACE},
+    {"replay-afap", no_argument, NULL, OPT_REPLAY_AFAP},
+    {"no-io-profile", no_argument, NULL, OPT_NO_IO_PROFILE},
+    {"procs", no_argument, NULL, OPT_PROCS},
+    {"port", required_argument, NULL, OPT_DIST_PORT},
+    {"agents", required_argument, NULL, OPT_AGENTS},
+    {"dist-op", required_argument, NULL, OPT_DIST_OP},
+    {"dist-time", required_argument, NULL, OPT_DIST_TIME},
+    {"ss-op", required_argument, NULL, OPT_SS_OP},
+    {"ss-round", required_argument, NULL, OPT_SS_ROUND},
+    {"ss-window", required_argument, NULL, OPT_SS_WINDOW},
+    {"ss-tolerance", required_argument, NULL, OPT_SS_TOLERANCE},
+    {"ss-slope", required_argument, NULL, OPT_SS_SLOPE},
+    {"ss-max-time", required_argument, NULL, OPT_SS_MAX_TIME},
+    {"trials", required_argument, NULL, OPT_TRIALS},
+    {"max-trials", required_argument, NULL, OPT_MAX_TRIALS},
+    {"cv-target", required_argument, NULL, OPT_CV_TARGET},
+    {"reject-outliers", no_argument, NULL, OPT_REJECT_OUTLIERS},
+    {"drop-caches", no_argument, NULL, OPT_DROP_CACHES},
+    {"residency", no_argument, NULL, OPT_RESIDENCY},
+    {"residency-interval", required_argument, NULL, OPT_RESIDENCY_INTERVAL},
+    {"calibrate", no_argument, NULL, OPT_CALIBRATE},
+    {"timer", required_argument, NULL, OPT_TIMER},
+    {"sweep-bs", required_argument, NULL, OPT_SWEEP_BS},
+    {"sweep-jobs", required_argument, NULL, OPT_SWEEP_JOBS},
+    {"sweep-qd", required_argument, NULL, OPT_SWEEP_QD},
+    {"sweep-ops", required_argument, NULL, OPT_SWEEP_OPS},
+    {"sweep-time", required_argument, NULL, OPT_SWEEP_TIME},
+    {"sweep-direct", no_argument, NULL, OPT_SWEEP_DIRECT},
+    {"sweep-csv", required_argument, NULL, OPT_SWEEP_CSV},
+    {"knee-param", required_argument, NULL, OPT_KNEE_PARAM},
+    {"knee-op", required_argument, NULL, OPT_KNEE_OP},
+    {"knee-gain", required_argument, NULL, OPT_KNEE_GAIN},
+    {"knee-p99", required_argument, NULL, OPT_KNEE_P99},
+    {"knee-time", required_argument, NULL, OPT_KNEE_TIME},
+    {"knee-max", required_argument, NULL, OPT_KNEE_MAX},
+    {"ra-window", required_argument, NULL, OPT_RA_WINDOW},
+    {"help", no_argument, NULL, 'h'},
+    {NULL, 0, NULL, 0},
+};
 
 static void print_usage(const char *prog) {
     printf("fstest - 文件系统综合测试工具\n\n");
@@ -36,13 +279,13 @@ static void print_usage(const char *prog) {
     printf("  -d <dir>     测试文件存放目录\n\n");
     printf("Options:\n");
     printf("  -m <mode>    测试模式 (默认: all)\n");
-    printf("                 all = 运行所有测试\n");
-    printf("                 functional = 功能正确性测试\n");
-    printf("                 consistency = 数据一致性测试\n");
-    printf("                 exception = 异常场景测试\n");
-    printf("                 concurrent = 并发测试\n");
-    printf("                 stress = 压力和稳定性测试\n");
-    printf("                 performance = 性能测试\n");
+    for (int i = 0; i < MODE_COUNT; i++) {
+        printf("                 %s = %s%s\n", mode_table[i].key,
+               mode_table[i].name,
+               mode_table[i].mode != TEST_MODE_ALL && !mode_table[i].in_all
+                   ? " (不含在 all 中)"
+                   : "");
+    }
     printf("  -j <n>       并发线程数 (默认: %d, 最大: %d)\n",
            DEFAULT_JOBS, MAX_JOBS);
     printf("  -s <bytes>   IO 大小 (默认: %ld)\n",
@@ -52,94 +295,273 @@ static void print_usage(const char *prog) {
     printf("  -i <n>       迭代次数 (默认: %d)\n", DEFAULT_ITER);
     printf("  -v           详细输出\n");
     printf("  -h           显示帮助信息\n");
+    printf("  --no-io-profile  关闭文件操作插桩 (默认每个模块结束后打印"
+           "系统调用剖析)\n");
+    printf("  --procs      performance / mdtest / concurrent 的 -j 个 worker "
+           "以子进程运行 (默认: 线程)\n");
+    printf("  --timer <t>  单次操作延迟的计时源: auto = 不变 TSC 可用时用 rdtscp，"
+           "否则 clock_gettime; tsc; clock (默认: auto)\n");
+    printf("\nTrial options (-m performance 的吞吐测试):\n");
+    printf("  --trials <n>           每个测试的独立试验次数，报告均值、中位数、"
+           "标准差、CV 和 95%% 置信区间 (默认: 1)\n");
+    printf("  --cv-target <pct>      CV 高于该值时追加试验 (至少 3 次，默认: "
+           "关闭)\n");
+    printf("  --max-trials <n>       追加试验的上限 (默认: %d)\n",
+           DEFAULT_MAX_TRIALS);
+    printf("  --reject-outliers      按修正 z 分数剔除离群试验\n");
+    printf("  --drop-caches          每次试验前逐出页缓存\n");
+    printf("  --residency            报告每个测试前后文件驻留页缓存的比例\n");
+    printf("  --residency-interval <ms>\n"
+           "                         试验期间按该间隔采样驻留比例 "
+           "(隐含 --residency)\n");
+    printf("  --calibrate            先测 memcpy / tmpfs pread / 系统调用基线，"
+           "结果按基线折算\n");
+    printf("\nFileset options (-m fileset):\n");
+    printf("  --fileset-files <n>  文件集合大小 (默认: %d)\n",
+           DEFAULT_FILESET_FILES);
+    printf("  --fileset-ops <n>    每线程每阶段操作的文件数 "
+           "(默认: 文件数 x 迭代次数 / 线程数)\n");
+    printf("  --size-dist <spec>   文件大小分布 (默认: %s)\n",
+           DEFAULT_SIZE_DIST);
+    printf("                         fixed:<size>\n");
+    printf("                         uniform:<min>:<max>\n");
+    printf("                         lognormal:<median>:<sigma>[:<max>]\n");
+    printf("                         hist:<file>  (每行 \"<size> <weight>\")\n");
+    printf("\nMetadata options (-m mdtest):\n");
+    printf("  --md-layout <l>      unique = 每线程独立目录树, "
+           "shared = 共享目录树 (默认: unique)\n");
+    printf("  --md-fanout <n>      目录树每层分支数 (默认: %d)\n",
+           DEFAULT_MD_FANOUT);
+    printf("  --md-depth <n>       目录树深度 (默认: %d)\n", DEFAULT_MD_DEPTH);
+    printf("  --md-items <n>       每个目录中每线程的条目数 (默认: %d)\n",
+           DEFAULT_MD_ITEMS);
+    printf("\nDirectory scaling options (-m dirscale):\n");
+    printf("  --dir-sizes <list>   目录条目数列表 (默认: %s)\n",
+           DEFAULT_DIR_SIZES);
+    printf("  --dents-bufs <list>  getdents64 缓冲区大小列表 (默认: %s)\n",
+           DEFAULT_DENTS_BUFS);
+    printf("\nPath walk options (-m pathwalk):\n");
+    printf("  --path-depths <list>     目录深度列表 (默认: %s)\n",
+           DEFAULT_PATH_DEPTHS);
+    printf("  --path-name-lens <list>  路径分量长度列表 (默认: %s)\n",
+           DEFAULT_PATH_NAME_LENS);
+    printf("  --symlink-chains <list>  符号链接链长度列表 (默认: %s)\n",
+           DEFAULT_SYMLINK_CHAINS);
+    printf("\nShared file options (-m sharedfile):\n");
+    printf("  --stride <bytes>     交错布局的轮转粒度 (默认: 等于 IO 大小)\n");
+    printf("\nAppend options (-m append):\n");
+    printf("  --append-records <n>   每个写入者的记录数 (默认: %d)\n",
+           DEFAULT_APPEND_RECORDS);
+    printf("  --record-size <s>[:<max>]  记录大小，给出上限时均匀分布 "
+           "(默认: IO 大小)\n");
+    printf("  --fsync-every <n>      每 n 条记录 fdatasync 一次 "
+           "(默认: 0 不同步)\n");
+    printf("  --append-procs <n>     写入进程数，每进程 -j 个线程 "
+           "(默认: %d)\n", DEFAULT_APPEND_PROCS);
+    printf("\nSpace management options (-m space):\n");
+    printf("  --falloc-size <s>      fallocate / 打洞 / 截断粒度 "
+           "(默认: 1M)\n");
+    printf("  --sparse-size <s>      稀疏文件逻辑大小 (默认: 1T)\n");
+    printf("  --sparse-writes <n>    稀疏文件随机写次数 (默认: %d)\n",
+           DEFAULT_SPARSE_WRITES);
+    printf("  --sparse-map <list>    映射测试的数据:空洞模式 (默认: %s)\n",
+           DEFAULT_SPARSE_MAP);
+    printf("  --sparse-extents <n>   映射测试的数据段数 (默认: %d)\n",
+           DEFAULT_SPARSE_EXTENTS);
+    printf("\nWAL options (-m wal, 记录大小取 -s):\n");
+    printf("  --wal-commits <n>      每线程提交次数 (默认: %d)\n",
+           DEFAULT_WAL_COMMITS);
+    printf("\nAtomic replace options (-m replace, 文件内容大小取 -s):\n");
+    printf("  --replace-ops <n>      每线程替换次数 (默认: %d)\n",
+           DEFAULT_REPLACE_OPS);
+    printf("\nLock options (-m lock, 竞争者数取 -j):\n");
+    printf("  --lock-ops <n>         每个竞争者的加锁次数 (默认: %d)\n",
+           DEFAULT_LOCK_OPS);
+    printf("\nXattr options (-m xattr):\n");
+    printf("  --xattr-files <n>      参与测试的文件数 (默认: %d)\n",
+           DEFAULT_XATTR_FILES);
+    printf("  --xattr-sizes <list>   属性值大小列表 (默认: %s)\n",
+           DEFAULT_XATTR_SIZES);
+    printf("  --xattr-counts <list>  每文件属性数列表 (默认: %s)\n",
+           DEFAULT_XATTR_COUNTS);
+    printf("\nReplay options (-m replay, 回放线程数取 -j):\n");
+    printf("  --trace <file>         要回放的二进制跟踪文件\n");
+    printf("  --strace <file>        先把 strace -f -ttt 输出转换为 --trace "
+           "文件再回放\n");
+    printf("  --replay-afap          忽略原始时间间隔，尽快回放\n");
+    printf("\nDistributed options (-m agent / -m controller):\n");
+    printf("  --port <n>             agent 监听端口，也是 --agents 中省略端口"
+           "时的默认值 (默认: %d)\n",
+           DEFAULT_DIST_PORT);
+    printf("  --agents <list>        controller 连接的 agent，如 "
+           "node1:7979,node2\n");
+    printf("  --dist-op <op>         seqread / seqwrite / randread / "
+           "randwrite (默认: randread)\n");
+    printf("  --dist-time <sec>      每个节点的运行时长 (默认: %d)\n",
+           DEFAULT_DIST_TIME);
+    printf("  controller 的 -j / -s / -f / --procs 下发给每个 agent\n");
+    printf("\nSteady-state options (-m steady, 负载取 -j / -s / -f / "
+           "--procs):\n");
+    printf("  --ss-op <op>           seqread / seqwrite / randread / "
+           "randwrite (默认: randwrite)\n");
+    printf("  --ss-round <sec>       每个测量轮次的时长 (默认: %d)\n",
+           DEFAULT_SS_ROUND);
+    printf("  --ss-window <n>        判定稳态的连续轮次数 (默认: %d)\n",
+           DEFAULT_SS_WINDOW);
+    printf("  --ss-tolerance <pct>   窗口内最大最小值之差上限，均值的百分比 "
+           "(默认: %d)\n",
+           DEFAULT_SS_TOLERANCE);
+    printf("  --ss-slope <pct>       窗口内拟合趋势变化量上限，均值的百分比 "
+           "(默认: %d)\n",
+           DEFAULT_SS_SLOPE);
+    printf("  --ss-max-time <sec>    未收敛时的最长运行时间 (默认: %d)\n",
+           DEFAULT_SS_MAX_TIME);
+    printf("\nSweep options (-m sweep, 文件大小取 -f，worker 形式取 "
+           "--procs):\n");
+    printf("  列表元素可以是单个值或 lo-hi 区间 (从 lo 按 2 倍递增到 hi)\n");
+    printf("  --sweep-bs <list>      IO 大小 (默认: %s)\n", DEFAULT_SWEEP_BS);
+    printf("  --sweep-jobs <list>    worker 数 (默认: %s)\n",
+           DEFAULT_SWEEP_JOBS);
+    printf("  --sweep-qd <list>      每个 worker 的队列深度，>1 用 POSIX AIO "
+           "(默认: %s)\n",
+           DEFAULT_SWEEP_QD);
+    printf("  --sweep-ops <list>     访问模式 (默认: %s)\n",
+           DEFAULT_SWEEP_OPS);
+    printf("  --sweep-time <sec>     每个点的运行时长 (默认: %d)\n",
+           DEFAULT_SWEEP_TIME);
+    printf("  --sweep-direct         以 O_DIRECT 打开文件\n");
+    printf("  --sweep-csv <file>     结果另存为 CSV\n");
+    printf("\nKnee search options (-m knee, 负载取 -s / -f / --procs):\n");
+    printf("  --knee-param <p>       jobs (队列深度 1) 或 qd (worker 数取 -j) "
+           "(默认: jobs)\n");
+    printf("  --knee-op <op>         seqread / seqwrite / randread / "
+           "randwrite (默认: randread)\n");
+    printf("  --knee-gain <pct>      每倍增吞吐增益低于该值视为饱和 "
+           "(默认: %d)\n",
+           DEFAULT_KNEE_GAIN);
+    printf("  --knee-p99 <us>        p99 延迟上限，超过视为饱和 (默认: 不限)\n");
+    printf("  --knee-time <sec>      每个点的运行时长 (默认: %d)\n",
+           DEFAULT_KNEE_TIME);
+    printf("  --knee-max <n>         搜索上限 (默认: jobs %d / qd %d)\n",
+           MAX_JOBS, MAX_SWEEP_QD);
+    printf("\nReadahead options (-m readahead, 文件取 -f，读大小取 -s):\n");
+    printf("  --ra-window <s>        readahead(2) 和读后丢弃的窗口 "
+           "(默认: 2M)\n");
     printf("\nExamples:\n");
     printf("  %s -d /tmp/fstest_data\n", prog);
     printf("  %s -d /mnt/nufs -m performance -j 4 -s 4096\n", prog);
     printf("  %s -d /tmp/fstest_data -m functional\n", prog);
+    printf("  %s -d /mnt/nufs -m fileset -j 8 --size-dist uniform:4K:1M\n",
+           prog);
+    printf("  %s -d /mnt/nufs -m mdtest -j 16 --md-layout shared\n", prog);
 }
 
-static const char *mode_key(enum fstest_mode mode) {
-    switch (mode) {
-        case TEST_MODE_ALL: return "all";
-        case TEST_MODE_FUNCTIONAL: return "functional";
-        case TEST_MODE_CONSISTENCY: return "consistency";
-        case TEST_MODE_EXCEPTION: return "exception";
-        case TEST_MODE_CONCURRENT: return "concurrent";
-        case TEST_MODE_STRESS: return "stress";
-        case TEST_MODE_PERFORMANCE: return "performance";
-        default: return "unknown";
-    }
-}
-
-static const char *mode_name(enum fstest_mode mode) {
-    switch (mode) {
-        case TEST_MODE_ALL: return "所有测试";
-        case TEST_MODE_FUNCTIONAL: return "功能正确性测试";
-        case TEST_MODE_CONSISTENCY: return "数据一致性测试";
-        case TEST_MODE_EXCEPTION: return "异常场景测试";
-        case TEST_MODE_CONCURRENT: return "并发测试";
-        case TEST_MODE_STRESS: return "压力和稳定性测试";
-        case TEST_MODE_PERFORMANCE: return "性能测试";
-        default: return "未知";
+static const struct mode_entry *find_mode(enum fstest_mode mode) {
+    for (int i = 0; i < MODE_COUNT; i++) {
+        if (mode_table[i].mode == mode) {
+            return &mode_table[i];
+        }
     }
+    return NULL;
 }
 
 static int parse_test_mode(const char *mode_arg, enum fstest_mode *mode) {
-    if (strcasecmp(mode_arg, "all") == 0 || strcmp(mode_arg, "0") == 0) {
-        *mode = TEST_MODE_ALL;
-        return 0;
-    }
-    if (strcasecmp(mode_arg, "functional") == 0 || strcmp(mode_arg, "1") == 0) {
-        *mode = TEST_MODE_FUNCTIONAL;
-        return 0;
-    }
-    if (strcasecmp(mode_arg, "consistency") == 0 || strcmp(mode_arg, "2") == 0) {
-        *mode = TEST_MODE_CONSISTENCY;
-        return 0;
-    }
-    if (strcasecmp(mode_arg, "exception") == 0 || strcmp(mode_arg, "3") == 0) {
-        *mode = TEST_MODE_EXCEPTION;
-        return 0;
-    }
-    if (strcasecmp(mode_arg, "concurrent") == 0 || strcmp(mode_arg, "4") == 0) {
-        *mode = TEST_MODE_CONCURRENT;
-        return 0;
-    }
-    if (strcasecmp(mode_arg, "stress") == 0 || strcmp(mode_arg, "5") == 0) {
-        *mode = TEST_MODE_STRESS;
-        return 0;
-    }
-    if (strcasecmp(mode_arg, "performance") == 0 || strcmp(mode_arg, "6") == 0) {
-        *mode = TEST_MODE_PERFORMANCE;
-        return 0;
+    for (int i = 0; i < MODE_COUNT; i++) {
+        if (strcasecmp(mode_arg, mode_table[i].key) == 0 ||
+            (mode_table[i].alias &&
+             strcmp(mode_arg, mode_table[i].alias) == 0)) {
+            *mode = mode_table[i].mode;
+            return 0;
+        }
     }
 
     return -1;
 }
 
+static void print_valid_modes(void) {
+    fprintf(stderr, "有效模式:");
+    for (int i = 0; i < MODE_COUNT; i++) {
+        fprintf(stderr, "%s %s", i == 0 ? "" : ",", mode_table[i].key);
+    }
+    fprintf(stderr, "\n");
+}
+
 int main(int argc, char *argv[]) {
     struct fstest_config cfg;
     memset(&cfg, 0, sizeof(cfg));
+    int timer_mode = TIMER_AUTO;
     cfg.jobs = DEFAULT_JOBS;
+    cfg.procs = 0;
+    cfg.trials = 1;
+    cfg.max_trials = DEFAULT_MAX_TRIALS;
+    cfg.cv_target = 0.0;
+    cfg.reject_outliers = 0;
+    cfg.drop_caches = 0;
+    cfg.residency = 0;
+    cfg.residency_interval = 0;
+    cfg.calibrate = 0;
     cfg.io_size = DEFAULT_IO_SIZE;
     cfg.file_size = DEFAULT_FILE_SIZE;
     cfg.iter_count = DEFAULT_ITER;
     cfg.test_mode = TEST_MODE_ALL;
     cfg.verbose = 0;
+    cfg.fileset_files = DEFAULT_FILESET_FILES;
+    cfg.fileset_ops = 0;
+    strncpy(cfg.size_dist, DEFAULT_SIZE_DIST, MAX_PATH_LEN - 1);
+    cfg.append_records = DEFAULT_APPEND_RECORDS;
+    cfg.append_procs = DEFAULT_APPEND_PROCS;
+    cfg.falloc_size = DEFAULT_FALLOC_SIZE;
+    cfg.sparse_size = DEFAULT_SPARSE_SIZE;
+    cfg.sparse_writes = DEFAULT_SPARSE_WRITES;
+    strncpy(cfg.sparse_map, DEFAULT_SPARSE_MAP, MAX_PATH_LEN - 1);
+    cfg.sparse_extents = DEFAULT_SPARSE_EXTENTS;
+    cfg.wal_commits = DEFAULT_WAL_COMMITS;
+    cfg.replace_ops = DEFAULT_REPLACE_OPS;
+    cfg.lock_ops = DEFAULT_LOCK_OPS;
+    cfg.xattr_files = DEFAULT_XATTR_FILES;
+    strncpy(cfg.xattr_sizes, DEFAULT_XATTR_SIZES, MAX_PATH_LEN - 1);
+    strncpy(cfg.xattr_counts, DEFAULT_XATTR_COUNTS, MAX_PATH_LEN - 1);
+    cfg.replay_afap = 0;
+    cfg.dist_port = DEFAULT_DIST_PORT;
+    cfg.agents[0] = '\0';
+    cfg.dist_op = RAND_READ;
+    cfg.dist_time = DEFAULT_DIST_TIME;
+    cfg.ss_op = RAND_WRITE;
+    cfg.ss_round = DEFAULT_SS_ROUND;
+    cfg.ss_window = DEFAULT_SS_WINDOW;
+    cfg.ss_tolerance = DEFAULT_SS_TOLERANCE;
+    cfg.ss_slope = DEFAULT_SS_SLOPE;
+    cfg.ss_max_time = DEFAULT_SS_MAX_TIME;
+    strncpy(cfg.sweep_bs, DEFAULT_SWEEP_BS, MAX_PATH_LEN - 1);
+    strncpy(cfg.sweep_jobs, DEFAULT_SWEEP_JOBS, MAX_PATH_LEN - 1);
+    strncpy(cfg.sweep_qd, DEFAULT_SWEEP_QD, MAX_PATH_LEN - 1);
+    strncpy(cfg.sweep_ops, DEFAULT_SWEEP_OPS, MAX_PATH_LEN - 1);
+    cfg.sweep_time = DEFAULT_SWEEP_TIME;
+    cfg.knee_op = RAND_READ;
+    cfg.knee_gain = DEFAULT_KNEE_GAIN;
+    cfg.knee_time = DEFAULT_KNEE_TIME;
+    cfg.ra_window = DEFAULT_RA_WINDOW;
+    cfg.md_shared_dir = 0;
+    cfg.md_fanout = DEFAULT_MD_FANOUT;
+    cfg.md_depth = DEFAULT_MD_DEPTH;
+    cfg.md_items = DEFAULT_MD_ITEMS;
+    strncpy(cfg.dir_sizes, DEFAULT_DIR_SIZES, MAX_PATH_LEN - 1);
+    strncpy(cfg.dents_bufs, DEFAULT_DENTS_BUFS, MAX_PATH_LEN - 1);
+    strncpy(cfg.path_depths, DEFAULT_PATH_DEPTHS, MAX_PATH_LEN - 1);
+    strncpy(cfg.path_name_lens, DEFAULT_PATH_NAME_LENS, MAX_PATH_LEN - 1);
+    strncpy(cfg.symlink_chains, DEFAULT_SYMLINK_CHAINS, MAX_PATH_LEN - 1);
 
     int opt;
-    while ((opt = getopt(argc, argv, "d:m:j:s:f:i:vh")) != -1) {
+    while ((opt = getopt_long(argc, argv, "d:m:j:s:f:i:vh", long_options,
+                              NULL)) != -1) {
         switch (opt) {
             case 'd':
                 strncpy(cfg.dir, optarg, MAX_PATH_LEN - 1);
                 break;
             case 'm':
                 if (parse_test_mode(optarg, &cfg.test_mode) != 0) {
-                    fprintf(stderr,
-                            "Error: 无效的测试模式 '%s'\n"
-                            "有效模式: all, functional, consistency, "
-                            "exception, concurrent, stress, performance\n",
-                            optarg);
+                    fprintf(stderr, "Error: 无效的测试模式 '%s'\n", optarg);
+                    print_valid_modes();
                     return 1;
                 }
                 break;
@@ -164,6 +586,298 @@ int main(int argc, char *argv[]) {
             case 'v':
                 cfg.verbose = 1;
                 break;
+            case OPT_FILESET_FILES:
+                cfg.fileset_files = atoi(optarg);
+                if (cfg.fileset_files < 1) cfg.fileset_files = 1;
+                break;
+            case OPT_FILESET_OPS:
+                cfg.fileset_ops = atoi(optarg);
+                if (cfg.fileset_ops < 0) cfg.fileset_ops = 0;
+                break;
+            case OPT_SIZE_DIST:
+                strncpy(cfg.size_dist, optarg, MAX_PATH_LEN - 1);
+                break;
+            case OPT_MD_LAYOUT:
+                if (strcasecmp(optarg, "shared") == 0) {
+                    cfg.md_shared_dir = 1;
+                } else if (strcasecmp(optarg, "unique") == 0) {
+                    cfg.md_shared_dir = 0;
+                } else {
+                    fprintf(stderr, "Error: 无效的目录布局 '%s' "
+                                    "(unique 或 shared)\n", optarg);
+                    return 1;
+                }
+                break;
+            case OPT_MD_FANOUT:
+                cfg.md_fanout = atoi(optarg);
+                if (cfg.md_fanout < 1) cfg.md_fanout = 1;
+                break;
+            case OPT_MD_DEPTH:
+                cfg.md_depth = atoi(optarg);
+                if (cfg.md_depth < 0) cfg.md_depth = 0;
+                break;
+            case OPT_MD_ITEMS:
+                cfg.md_items = atoi(optarg);
+                if (cfg.md_items < 1) cfg.md_items = 1;
+                break;
+            case OPT_DIR_SIZES:
+                strncpy(cfg.dir_sizes, optarg, MAX_PATH_LEN - 1);
+                break;
+            case OPT_DENTS_BUFS:
+                strncpy(cfg.dents_bufs, optarg, MAX_PATH_LEN - 1);
+                break;
+            case OPT_PATH_DEPTHS:
+                strncpy(cfg.path_depths, optarg, MAX_PATH_LEN - 1);
+                break;
+            case OPT_PATH_NAME_LENS:
+                strncpy(cfg.path_name_lens, optarg, MAX_PATH_LEN - 1);
+                break;
+            case OPT_SYMLINK_CHAINS:
+                strncpy(cfg.symlink_chains, optarg, MAX_PATH_LEN - 1);
+                break;
+            case OPT_APPEND_RECORDS:
+                cfg.append_records = atoi(optarg);
+                if (cfg.append_records < 1) cfg.append_records = 1;
+                break;
+            case OPT_RECORD_SIZE: {
+                char *sep = strchr(optarg, ':');
+                if (sep) *sep = '\0';
+                if (parse_size(optarg, &cfg.record_min) != 0 ||
+                    (sep && parse_size(sep + 1, &cfg.record_max) != 0)) {
+                    fprintf(stderr, "Error: 无效的记录大小 '%s'\n", optarg);
+                    return 1;
+                }
+                if (!sep) cfg.record_max = cfg.record_min;
+                break;
+            }
+            case OPT_FSYNC_EVERY:
+                cfg.fsync_every = atoi(optarg);
+                if (cfg.fsync_every < 0) cfg.fsync_every = 0;
+                break;
+            case OPT_APPEND_PROCS:
+                cfg.append_procs = atoi(optarg);
+                if (cfg.append_procs < 1) cfg.append_procs = 1;
+                if (cfg.append_procs > MAX_JOBS) cfg.append_procs = MAX_JOBS;
+                break;
+            case OPT_FALLOC_SIZE:
+                if (parse_size(optarg, &cfg.falloc_size) != 0 ||
+                    cfg.falloc_size == 0) {
+                    fprintf(stderr, "Error: 无效的 fallocate 粒度 '%s'\n",
+                            optarg);
+                    return 1;
+                }
+                break;
+            case OPT_SPARSE_SIZE:
+                if (parse_size(optarg, &cfg.sparse_size) != 0 ||
+                    cfg.sparse_size < _1MB_BYTES) {
+                    fprintf(stderr, "Error: 无效的稀疏文件大小 '%s'\n",
+                            optarg);
+                    return 1;
+                }
+                break;
+            case OPT_SPARSE_WRITES:
+                cfg.sparse_writes = atoi(optarg);
+                if (cfg.sparse_writes < 1) cfg.sparse_writes = 1;
+                break;
+            case OPT_SPARSE_MAP:
+                strncpy(cfg.sparse_map, optarg, MAX_PATH_LEN - 1);
+                break;
+            case OPT_SPARSE_EXTENTS:
+                cfg.sparse_extents = atoi(optarg);
+                if (cfg.sparse_extents < 1) cfg.sparse_extents = 1;
+                break;
+            case OPT_WAL_COMMITS:
+                cfg.wal_commits = atoi(optarg);
+                if (cfg.wal_commits < 1) cfg.wal_commits = 1;
+                break;
+            case OPT_REPLACE_OPS:
+                cfg.replace_ops = atoi(optarg);
+                if (cfg.replace_ops < 1) cfg.replace_ops = 1;
+                break;
+            case OPT_LOCK_OPS:
+                cfg.lock_ops = atoi(optarg);
+                if (cfg.lock_ops < 1) cfg.lock_ops = 1;
+                break;
+            case OPT_XATTR_FILES:
+                cfg.xattr_files = atoi(optarg);
+                if (cfg.xattr_files < 1) cfg.xattr_files = 1;
+                break;
+            case OPT_XATTR_SIZES:
+                strncpy(cfg.xattr_sizes, optarg, MAX_PATH_LEN - 1);
+                break;
+            case OPT_XATTR_COUNTS:
+                strncpy(cfg.xattr_counts, optarg, MAX_PATH_LEN - 1);
+                break;
+            case OPT_TRACE:
+                strncpy(cfg.trace_file, optarg, MAX_PATH_LEN - 1);
+                break;
+            case OPT_STRACE:
+                strncpy(cfg.strace_file, optarg, MAX_PATH_LEN - 1);
+                break;
+            case OPT_REPLAY_AFAP:
+                cfg.replay_afap = 1;
+                break;
+            case OPT_NO_IO_PROFILE:
+                fsop_enabled = 0;
+                break;
+            case OPT_PROCS:
+                cfg.procs = 1;
+                break;
+            case OPT_DIST_PORT:
+                cfg.dist_port = atoi(optarg);
+                if (cfg.dist_port < 1 || cfg.dist_port > 65535) {
+                    fprintf(stderr, "Error: 无效的端口 '%s'\n", optarg);
+                    return 1;
+                }
+                break;
+            case OPT_AGENTS:
+                strncpy(cfg.agents, optarg, MAX_PATH_LEN - 1);
+                break;
+            case OPT_DIST_OP:
+                cfg.dist_op = test_type_parse(optarg);
+                if (cfg.dist_op < 0) {
+                    fprintf(stderr, "Error: 无效的 dist-op '%s'\n", optarg);
+                    return 1;
+                }
+                break;
+            case OPT_DIST_TIME:
+                cfg.dist_time = atoi(optarg);
+                if (cfg.dist_time < 1) cfg.dist_time = 1;
+                break;
+            case OPT_SS_OP:
+                cfg.ss_op = test_type_parse(optarg);
+                if (cfg.ss_op < 0) {
+                    fprintf(stderr, "Error: 无效的 ss-op '%s'\n", optarg);
+                    return 1;
+                }
+                break;
+            case OPT_SS_ROUND:
+                cfg.ss_round = atoi(optarg);
+                if (cfg.ss_round < 1) cfg.ss_round = 1;
+                break;
+            case OPT_SS_WINDOW:
+                cfg.ss_window = atoi(optarg);
+                if (cfg.ss_window < 2) cfg.ss_window = 2;
+                break;
+            case OPT_SS_TOLERANCE:
+                cfg.ss_tolerance = atoi(optarg);
+                if (cfg.ss_tolerance < 1) cfg.ss_tolerance = 1;
+                break;
+            case OPT_SS_SLOPE:
+                cfg.ss_slope = atoi(optarg);
+                if (cfg.ss_slope < 1) cfg.ss_slope = 1;
+                break;
+            case OPT_SS_MAX_TIME:
+                cfg.ss_max_time = atoi(optarg);
+                if (cfg.ss_max_time < 1) cfg.ss_max_time = 1;
+                break;
+            case OPT_TRIALS:
+                cfg.trials = atoi(optarg);
+                if (cfg.trials < 1) cfg.trials = 1;
+                if (cfg.trials > MAX_TRIALS) cfg.trials = MAX_TRIALS;
+                break;
+            case OPT_MAX_TRIALS:
+                cfg.max_trials = atoi(optarg);
+                if (cfg.max_trials < 1) cfg.max_trials = 1;
+                if (cfg.max_trials > MAX_TRIALS) cfg.max_trials = MAX_TRIALS;
+                break;
+            case OPT_CV_TARGET:
+                cfg.cv_target = atof(optarg);
+                if (cfg.cv_target < 0.0) cfg.cv_target = 0.0;
+                break;
+            case OPT_REJECT_OUTLIERS:
+                cfg.reject_outliers = 1;
+                break;
+            case OPT_DROP_CACHES:
+                cfg.drop_caches = 1;
+                break;
+            case OPT_RESIDENCY:
+                cfg.residency = 1;
+                break;
+            case OPT_CALIBRATE:
+                cfg.calibrate = 1;
+                break;
+            case OPT_TIMER:
+                timer_mode = timer_mode_parse(optarg);
+                if (timer_mode < 0) {
+                    fprintf(stderr, "Error: 无效的 timer '%s'\n", optarg);
+                    return 1;
+                }
+                break;
+            case OPT_RESIDENCY_INTERVAL:
+                cfg.residency_interval = atoi(optarg);
+                if (cfg.residency_interval < 1) cfg.residency_interval = 1;
+                cfg.residency = 1;
+                break;
+            case OPT_SWEEP_BS:
+                strncpy(cfg.sweep_bs, optarg, MAX_PATH_LEN - 1);
+                break;
+            case OPT_SWEEP_JOBS:
+                strncpy(cfg.sweep_jobs, optarg, MAX_PATH_LEN - 1);
+                break;
+            case OPT_SWEEP_QD:
+                strncpy(cfg.sweep_qd, optarg, MAX_PATH_LEN - 1);
+                break;
+            case OPT_SWEEP_OPS:
+                strncpy(cfg.sweep_ops, optarg, MAX_PATH_LEN - 1);
+                break;
+            case OPT_SWEEP_TIME:
+                cfg.sweep_time = atoi(optarg);
+                if (cfg.sweep_time < 1) cfg.sweep_time = 1;
+                break;
+            case OPT_SWEEP_DIRECT:
+                cfg.sweep_direct = 1;
+                break;
+            case OPT_SWEEP_CSV:
+                strncpy(cfg.sweep_csv, optarg, MAX_PATH_LEN - 1);
+                break;
+            case OPT_KNEE_PARAM:
+                if (strcmp(optarg, "jobs") == 0) {
+                    cfg.knee_qd = 0;
+                } else if (strcmp(optarg, "qd") == 0) {
+                    cfg.knee_qd = 1;
+                } else {
+                    fprintf(stderr, "Error: 无效的 knee-param '%s'\n",
+                            optarg);
+                    return 1;
+                }
+                break;
+            case OPT_KNEE_OP:
+                cfg.knee_op = test_type_parse(optarg);
+                if (cfg.knee_op < 0) {
+                    fprintf(stderr, "Error: 无效的 knee-op '%s'\n", optarg);
+                    return 1;
+                }
+                break;
+            case OPT_KNEE_GAIN:
+                cfg.knee_gain = atoi(optarg);
+                if (cfg.knee_gain < 1) cfg.knee_gain = 1;
+                break;
+            case OPT_KNEE_P99:
+                cfg.knee_p99 = atoi(optarg);
+                if (cfg.knee_p99 < 0) cfg.knee_p99 = 0;
+                break;
+            case OPT_KNEE_TIME:
+                cfg.knee_time = atoi(optarg);
+                if (cfg.knee_time < 1) cfg.knee_time = 1;
+                break;
+            case OPT_KNEE_MAX:
+                cfg.knee_max = atoi(optarg);
+                if (cfg.knee_max < 1) cfg.knee_max = 1;
+                break;
+            case OPT_RA_WINDOW:
+                if (parse_size(optarg, &cfg.ra_window) != 0 ||
+                    cfg.ra_window == 0) {
+                    fprintf(stderr, "Error: 无效的预读窗口 '%s'\n", optarg);
+                    return 1;
+                }
+                break;
+            case OPT_STRIDE:
+                if (parse_size(optarg, &cfg.stride) != 0) {
+                    fprintf(stderr, "Error: 无效的 stride '%s'\n", optarg);
+                    return 1;
+                }
+                break;
             case 'h':
                 print_usage(argv[0]);
                 return 0;
@@ -173,6 +887,23 @@ int main(int argc, char *argv[]) {
         }
     }
 
+    if (cfg.record_min == 0) {
+        cfg.record_min = cfg.io_size;
+        cfg.record_max = cfg.io_size;
+    }
+
+    if (cfg.test_mode == TEST_MODE_REPLAY && strlen(cfg.trace_file) == 0) {
+        fprintf(stderr, "Error: replay 模式必须指定 --trace\n\n");
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    if (cfg.test_mode == TEST_MODE_CONTROLLER && strlen(cfg.agents) == 0) {
+        fprintf(stderr, "Error: controller 模式必须指定 --agents\n\n");
+        print_usage(argv[0]);
+        return 1;
+    }
+
     if (strlen(cfg.dir) == 0) {
         fprintf(stderr, "Error: 必须指定测试目录 (-d)\n\n");
         print_usage(argv[0]);
@@ -192,12 +923,24 @@ int main(int argc, char *argv[]) {
     printf("╚══════════════════════════════════════════╝\n");
     printf("配置:\n");
     printf("  测试目录:   %s\n", cfg.dir);
-    printf("  测试模式:   %s (%s)\n", mode_key(cfg.test_mode),
-           mode_name(cfg.test_mode));
-    printf("  线程数:     %d\n", cfg.jobs);
+    const struct mode_entry *selected = find_mode(cfg.test_mode);
+    printf("  测试模式:   %s (%s)\n", selected->key, selected->name);
+    printf("  线程数:     %d%s\n", cfg.jobs, cfg.procs ? " (进程)" : "");
     printf("  IO 大小:    %zu bytes\n", cfg.io_size);
     printf("  文件大小:   %zu MB\n", cfg.file_size / _1MB_BYTES);
     printf("  迭代次数:   %d\n", cfg.iter_count);
+    if (timer_init(timer_mode) != 0) {
+        fprintf(stderr, "Warning: TSC 不可用 (%s)，回退到 clock_gettime\n",
+                timer_fallback_reason());
+    }
+    if (timer_use_tsc) {
+        printf("  计时器:     tsc (%.3f GHz, %.1f ns/次)\n", timer_tsc_ghz(),
+               timer_overhead_ns());
+    } else {
+        printf("  计时器:     clock_gettime (%.1f ns/次%s%s)\n",
+               timer_overhead_ns(), timer_fallback_reason()[0] ? ", " : "",
+               timer_fallback_reason());
+    }
 
     srand(time(NULL));
 
@@ -205,23 +948,15 @@ int main(int argc, char *argv[]) {
     struct timespec total_start, total_end;
     clock_gettime(CLOCK_MONOTONIC, &total_start);
 
-    if (cfg.test_mode == TEST_MODE_ALL || cfg.test_mode == TEST_MODE_FUNCTIONAL) {
-        run_functional_tests(&cfg);
-    }
-    if (cfg.test_mode == TEST_MODE_ALL || cfg.test_mode == TEST_MODE_CONSISTENCY) {
-        run_consistency_tests(&cfg);
-    }
-    if (cfg.test_mode == TEST_MODE_ALL || cfg.test_mode == TEST_MODE_EXCEPTION) {
-        run_exception_tests(&cfg);
-    }
-    if (cfg.test_mode == TEST_MODE_ALL || cfg.test_mode == TEST_MODE_CONCURRENT) {
-        run_concurrent_tests(&cfg);
-    }
-    if (cfg.test_mode == TEST_MODE_ALL || cfg.test_mode == TEST_MODE_STRESS) {
-        run_stress_tests(&cfg);
-    }
-    if (cfg.test_mode == TEST_MODE_ALL || cfg.test_mode == TEST_MODE_PERFORMANCE) {
-        run_performance_tests(&cfg);
+    for (int i = 0; i < MODE_COUNT; i++) {
+        const struct mode_entry *m = &mode_table[i];
+        if (m->run == NULL) continue;
+        if (cfg.test_mode == m->mode ||
+            (cfg.test_mode == TEST_MODE_ALL && m->in_all)) {
+            fsop_reset();
+            m->run(&cfg);
+            fsop_print_profile(m->name);
+        }
     }
 
     clock_gettime(CLOCK_MONOTONIC, &total_end);
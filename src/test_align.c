@@ -0,0 +1,235 @@
+/*
+    对齐代价模块实现
+    - 对齐探测：statx(STATX_DIOALIGN) 报告的内存和偏移 / 长度对齐，不支持时
+      用不同对齐的 O_DIRECT pread 试探；同时列出 st_blksize 和页大小
+    - 不对齐扫描：在 -f 大小的文件上以 IO 大小 (-s 向上取整到页) 为步长顺序
+      访问，每种情况把偏移或长度错开若干字节：
+        aligned / offset +512 / offset +1 / length -512 / length +1
+      每种情况依次执行冷缓存写 (部分页须先从设备读入，即读-改-写)、热缓存写
+      和冷缓存读；O_DIRECT 按探测到的偏移对齐错开一次，衡量细粒度直接 IO
+    每行报告吞吐、单次延迟、相对 aligned 的耗时倍数，以及 /proc/self/io 中
+    该阶段从设备读入的字节数 (读-改-写的直接证据)
+*/
+
+#include "test_align.h"
+
+#include "timed_io.h"
+#include "timer.h"
+
+struct align_case {
+    const char *name;
+    off_t shift;               /* 偏移错开的字节数 */
+    ssize_t delta;             /* 长度增减的字节数 */
+};
+
+static const struct align_case align_cases[] = {
+    {"aligned", 0, 0},
+    {"offset +512", 512, 0},
+    {"offset +1", 1, 0},
+    {"length -512", 0, -512},
+    {"length +1", 0, 1},
+};
+#define ALIGN_CASE_COUNT \
+    ((int)(sizeof(align_cases) / sizeof(align_cases[0])))
+
+enum align_phase { ALIGN_WRITE_COLD, ALIGN_WRITE_WARM, ALIGN_READ_COLD };
+
+static const char *align_phase_name(enum align_phase p) {
+    switch (p) {
+        case ALIGN_WRITE_COLD: return "write cold";
+        case ALIGN_WRITE_WARM: return "write warm";
+        case ALIGN_READ_COLD: return "read cold";
+        default: return "unknown";
+    }
+}
+
+/* /proc/self/io 的 read_bytes (本进程从存储层读入的字节数)，不可用返回 -1 */
+static long long proc_read_bytes(void) {
+    FILE *fp = fopen("/proc/self/io", "r");
+    if (!fp) return -1;
+    char line[128];
+    long long v = -1;
+    while (fgets(line, sizeof(line), fp)) {
+        if (sscanf(line, "read_bytes: %lld", &v) == 1) break;
+    }
+    fclose(fp);
+    return v;
+}
+
+static void align_evict(int fd) {
+    fdatasync(fd);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+}
+
+struct align_result {
+    double secs;
+    double mbs;
+    struct lat_hist hist;
+    long long dev_read;        /* -1 = 不可用 */
+    int errors;
+};
+
+/* 以 stride 为步长顺序访问，每次在 k * stride + shift 处读写 len 字节 */
+static void align_pass(int fd, char *buf, size_t stride, size_t count,
+                       off_t shift, size_t len, int is_write,
+                       struct align_result *r) {
+    struct timespec start, end;
+    uint64_t t0, t1;
+    long long rb0 = proc_read_bytes();
+    lat_hist_init(&r->hist);
+    r->errors = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (size_t k = 0; k < count; k++) {
+        off_t off = (off_t)(k * stride) + shift;
+        t0 = timer_now();
+        ssize_t ret = is_write ? pwrite(fd, buf, len, off)
+                               : pread(fd, buf, len, off);
+        t1 = timer_now();
+        if (ret != (ssize_t)len) {
+            r->errors++;
+            continue;
+        }
+        lat_hist_add(&r->hist, timer_diff_ns(t0, t1));
+    }
+    /* 写入的耗时包含回写，读-改-写的读发生在 pwrite 内部 */
+    if (is_write) fdatasync(fd);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    long long rb1 = proc_read_bytes();
+    r->secs = calculate_time_diff_ns(&start, &end) / (double)NANOS_PER_SECOND;
+    r->mbs = r->secs > 0.0
+                 ? r->hist.count * len / (double)_1MB_BYTES / r->secs
+                 : 0.0;
+    r->dev_read = rb0 >= 0 && rb1 >= 0 ? rb1 - rb0 : -1;
+}
+
+static void print_align_row(const char *name, const char *phase,
+                            const struct align_result *r, double base_secs) {
+    char dev[24] = "n/a";
+    if (r->dev_read >= 0) {
+        snprintf(dev, sizeof(dev), "%.1f", r->dev_read / (double)_1MB_BYTES);
+    }
+    printf("  %-14s | %-10s | %9.2f | %8.1f | %8.1f | %6.2fx | %9s\n", name,
+           phase, r->mbs,
+           r->hist.count ? r->hist.sum_ns / 1000.0 / r->hist.count : 0.0,
+           lat_hist_percentile(&r->hist, 99.0) / 1000.0,
+           base_secs > 0.0 ? r->secs / base_secs : 0.0, dev);
+    fflush(stdout);
+}
+
+static void test_dio_probe(const char *path, size_t *off_align,
+                           size_t *mem_align) {
+    printf("\n  --- O_DIRECT 对齐探测 (DIO Alignment) ---\n");
+    struct stat st;
+    if (stat(path, &st) == 0) {
+        printf("  %-20s | %ld B\n", "st_blksize", (long)st.st_blksize);
+    }
+    printf("  %-20s | %ld B\n", "page size", sysconf(_SC_PAGESIZE));
+    int src = dio_alignment(path, mem_align, off_align);
+    if (src < 0) {
+        *off_align = 0;
+        TEST_SKIP("O_DIRECT alignment", strerror(errno));
+        return;
+    }
+    const char *how = src == DIO_ALIGN_STATX ? "statx" : "probed";
+    printf("  %-20s | %zu B (%s)\n", "memory alignment", *mem_align, how);
+    printf("  %-20s | %zu B (%s)\n", "offset / length", *off_align, how);
+}
+
+void run_align_tests(const struct fstest_config *cfg) {
+    printf("\n");
+    printf("========================================\n");
+    printf("  25. 对齐代价 (Alignment Cost)\n");
+    printf("========================================\n");
+
+    long page = sysconf(_SC_PAGESIZE);
+    size_t stride = (cfg->io_size + page - 1) / page * page;
+    size_t size = cfg->file_size < DIO_PROBE_MIN_SIZE ? DIO_PROBE_MIN_SIZE
+                                                      : cfg->file_size;
+    /* 末次访问可能越过 stride 一个页，留出余量 */
+    size_t count = size / stride > 1 ? size / stride - 1 : 1;
+    size = (count + 1) * stride;
+    printf("  File:         %zu MB | stride %zu B | %zu accesses per pass\n",
+           size / _1MB_BYTES, stride, count);
+
+    char path[MAX_PATH_LEN];
+    make_test_path(path, sizeof(path), cfg->dir, "align.dat");
+    char *buf = NULL;
+    int fd = -1;
+    if (posix_memalign((void **)&buf, 64 * _1KB_BYTES,
+                       stride + 64 * _1KB_BYTES) != 0) {
+        buf = NULL;
+        TEST_FAIL("alignment", strerror(ENOMEM));
+        goto out;
+    }
+    fill_rand_buffer(buf, stride + 64 * _1KB_BYTES);
+    if (timed_io_prefill(path, size) != 0) {
+        TEST_FAIL("alignment prefill", strerror(errno));
+        goto out;
+    }
+
+    size_t off_align = 0, mem_align = 0;
+    test_dio_probe(path, &off_align, &mem_align);
+
+    fd = open(path, O_RDWR);
+    if (fd < 0) {
+        TEST_FAIL("alignment", strerror(errno));
+        goto out;
+    }
+    printf("\n  --- 缓冲 IO 不对齐代价 (Buffered Misalignment) ---\n");
+    printf("  %-14s | %-10s | %9s | %8s | %8s | %7s | %9s\n", "case",
+           "phase", "MB/s", "avg us", "p99 us", "vs algn", "dev rd MB");
+
+    double base[3] = {0.0, 0.0, 0.0};
+    int errors = 0;
+    for (int c = 0; c < ALIGN_CASE_COUNT; c++) {
+        const struct align_case *ac = &align_cases[c];
+        size_t len = (size_t)((ssize_t)stride + ac->delta);
+        for (int p = ALIGN_WRITE_COLD; p <= ALIGN_READ_COLD; p++) {
+            struct align_result r;
+            if (p != ALIGN_WRITE_WARM) align_evict(fd);
+            align_pass(fd, buf, stride, count, ac->shift, len,
+                       p != ALIGN_READ_COLD, &r);
+            if (c == 0) base[p] = r.secs;
+            print_align_row(ac->name, align_phase_name(p), &r, base[p]);
+            errors += r.errors;
+        }
+    }
+
+    if (off_align > 0 && off_align < stride) {
+        int dfd = open(path, O_RDWR | O_DIRECT);
+        if (dfd < 0) {
+            TEST_SKIP("O_DIRECT misalignment", strerror(errno));
+        } else {
+            printf("\n  --- O_DIRECT 细粒度对齐 (Direct I/O at %zu B "
+                   "alignment) ---\n",
+                   off_align);
+            struct align_result r;
+            double dbase[2] = {0.0, 0.0};
+            for (int c = 0; c < 2; c++) {
+                const char *name = c == 0 ? "aligned" : "offset +align";
+                off_t shift = c == 0 ? 0 : (off_t)off_align;
+                for (int w = 1; w >= 0; w--) {
+                    align_pass(dfd, buf, stride, count, shift, stride, w,
+                               &r);
+                    if (c == 0) dbase[w] = r.secs;
+                    print_align_row(name, w ? "write" : "read", &r,
+                                    dbase[w]);
+                    errors += r.errors;
+                }
+            }
+            close(dfd);
+        }
+    }
+
+    if (errors > 0) {
+        char msg[64];
+        snprintf(msg, sizeof(msg), "%d failed IOs", errors);
+        TEST_FAIL("alignment", msg);
+    }
+
+out:
+    if (fd >= 0) close(fd);
+    free(buf);
+    unlink(path);
+    printf("--- 对齐代价测试完成 ---\n");
+}
@@ -0,0 +1,14 @@
+/*
+    对齐代价模块
+    探测 O_DIRECT 的实际对齐要求，并衡量偏移 / 长度不对齐的缓冲 IO
+    (读-改-写) 相对对齐 IO 的代价
+*/
+
+#ifndef FSTEST_TEST_ALIGN_H
+#define FSTEST_TEST_ALIGN_H
+
+#include "common.h"
+
+void run_align_tests(const struct fstest_config *cfg);
+
+#endif /* FSTEST_TEST_ALIGN_H */
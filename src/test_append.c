@@ -0,0 +1,462 @@
+/*
+    并发追加日志负载模块实现
+    --append-procs 个进程，每个进程 -j 个线程，每个线程单独以 O_APPEND 打开
+    同一个日志文件并追加 --append-records 条记录
+    测试项目：
+    - 追加吞吐 (MB/s, records/s) 和单次 write 延迟分位数
+    - 可选每 --fsync-every 条记录 fdatasync 一次，单独统计 fsync 延迟
+    - 追加结束后多线程并行扫描整个文件，校验没有撕裂或交错的记录，
+      且每个写入者的每条记录恰好出现一次
+*/
+
+#include "test_append.h"
+
+#include "timer.h"
+
+#include <sys/mman.h>
+#include <sys/wait.h>
+
+#define APPEND_MAGIC 0x4C4F4752u  /* "RGOL" */
+#define APPEND_FOOTER 0x444E4552u /* "REND" */
+#define APPEND_SCAN_WINDOW (4 * _1MB_BYTES)
+
+/* 记录格式：头部 + 负载 + 4 字节尾标记，len 为整条记录长度 */
+struct append_record_hdr {
+    uint32_t magic;
+    uint32_t writer;
+    uint32_t seq;
+    uint32_t len;
+    uint32_t checksum;
+    uint32_t reserved;
+};
+
+#define APPEND_MIN_RECORD (sizeof(struct append_record_hdr) + sizeof(uint32_t))
+
+/* 每个写入者一个结果槽，位于进程间共享的匿名映射中 */
+struct append_result {
+    struct lat_hist write_lat;
+    struct lat_hist fsync_lat;
+    uint64_t bytes;
+    uint64_t records;
+    int errors;
+};
+
+struct append_job_args {
+    const char *path;
+    uint32_t writer;
+    int records;
+    size_t min_len;
+    size_t max_len;
+    int fsync_every;
+    struct append_result *result;
+};
+
+struct append_scan_args {
+    const char *path;
+    off_t begin;
+    off_t end;
+    off_t file_size;
+    uint32_t writer_n;
+    uint32_t records;
+    size_t min_len;
+    size_t max_len;
+    _Atomic unsigned char *seen;
+    off_t first;     /* 区间内第一条有效记录的起点，-1 表示没有 */
+    off_t last_end;  /* 最后一条解析成功的记录的终点 */
+    uint64_t valid;
+    uint64_t torn;
+    uint64_t duplicates;
+};
+
+/* 读窗口：按需从文件中读入 APPEND_SCAN_WINDOW 大小的数据 */
+struct scan_window {
+    int fd;
+    off_t base;
+    size_t len;
+    size_t cap;
+    off_t file_size;
+    char *buf;
+};
+
+static uint32_t record_checksum(uint32_t writer, uint32_t seq,
+                                const unsigned char *payload, size_t len) {
+    /* FNV-1a */
+    uint32_t h = 2166136261u ^ writer;
+    h = (h ^ seq) * 16777619u;
+    for (size_t i = 0; i < len; i++) {
+        h = (h ^ payload[i]) * 16777619u;
+    }
+    return h;
+}
+
+static size_t build_record(char *buf, uint32_t writer, uint32_t seq,
+                           size_t len) {
+    struct append_record_hdr hdr;
+    size_t payload_len = len - APPEND_MIN_RECORD;
+    unsigned char *payload = (unsigned char *)buf + sizeof(hdr);
+    for (size_t i = 0; i < payload_len; i++) {
+        payload[i] = (unsigned char)(writer * 31 + seq * 7 + i);
+    }
+    hdr.magic = APPEND_MAGIC;
+    hdr.writer = writer;
+    hdr.seq = seq;
+    hdr.len = (uint32_t)len;
+    hdr.checksum = record_checksum(writer, seq, payload, payload_len);
+    hdr.reserved = 0;
+    memcpy(buf, &hdr, sizeof(hdr));
+    uint32_t footer = APPEND_FOOTER;
+    memcpy(buf + len - sizeof(footer), &footer, sizeof(footer));
+    return len;
+}
+
+static void *append_job(void *arg) {
+    struct append_job_args *a = (struct append_job_args *)arg;
+    struct append_result *r = a->result;
+    unsigned int seed = a->writer * 2654435761u + 1;
+    uint64_t t0, t1;
+
+    lat_hist_init(&r->write_lat);
+    lat_hist_init(&r->fsync_lat);
+    int fd = open(a->path, O_WRONLY | O_APPEND);
+    if (fd < 0) {
+        r->errors++;
+        return NULL;
+    }
+    char *buf = malloc(a->max_len);
+
+    for (int i = 0; i < a->records; i++) {
+        size_t len = a->min_len;
+        if (a->max_len > a->min_len) {
+            len += rand_r(&seed) % (a->max_len - a->min_len + 1);
+        }
+        build_record(buf, a->writer, (uint32_t)i, len);
+
+        t0 = timer_now();
+        ssize_t w = write(fd, buf, len);
+        t1 = timer_now();
+        if (w != (ssize_t)len) {
+            r->errors++;
+            continue;
+        }
+        lat_hist_add(&r->write_lat, timer_diff_ns(t0, t1));
+        r->bytes += len;
+        r->records++;
+
+        if (a->fsync_every > 0 && (i + 1) % a->fsync_every == 0) {
+            t0 = timer_now();
+            if (fdatasync(fd) != 0) r->errors++;
+            t1 = timer_now();
+            lat_hist_add(&r->fsync_lat, timer_diff_ns(t0, t1));
+        }
+    }
+
+    free(buf);
+    close(fd);
+    return NULL;
+}
+
+/* 在一个进程内启动 -j 个追加线程 */
+static void run_append_process(const struct fstest_config *cfg,
+                               const char *path, int proc,
+                               struct append_result *results) {
+    int nthreads = cfg->jobs;
+    pthread_t *threads = malloc(nthreads * sizeof(pthread_t));
+    struct append_job_args *args =
+        calloc(nthreads, sizeof(struct append_job_args));
+
+    for (int i = 0; i < nthreads; i++) {
+        args[i].path = path;
+        args[i].writer = (uint32_t)(proc * nthreads + i);
+        args[i].records = cfg->append_records;
+        args[i].min_len = cfg->record_min;
+        args[i].max_len = cfg->record_max;
+        args[i].fsync_every = cfg->fsync_every;
+        args[i].result = &results[args[i].writer];
+        pthread_create(&threads[i], NULL, append_job, &args[i]);
+    }
+    for (int i = 0; i < nthreads; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    free(args);
+    free(threads);
+}
+
+static const char *window_get(struct scan_window *w, off_t off, size_t len) {
+    if (off >= w->base && off + (off_t)len <= w->base + (off_t)w->len) {
+        return w->buf + (off - w->base);
+    }
+    if (off + (off_t)len > w->file_size) return NULL;
+
+    size_t want = w->cap;
+    if (off + (off_t)want > w->file_size) want = w->file_size - off;
+    size_t got = 0;
+    while (got < want) {
+        ssize_t r = pread(w->fd, w->buf + got, want - got, off + got);
+        if (r <= 0) return NULL;
+        got += r;
+    }
+    w->base = off;
+    w->len = want;
+    return w->buf;
+}
+
+/* 检查 pos 处是否是一条完整有效的记录，成功时返回记录头 */
+static int parse_record(struct scan_window *w, const struct append_scan_args *a,
+                        off_t pos, struct append_record_hdr *hdr) {
+    const char *p = window_get(w, pos, sizeof(*hdr));
+    if (!p) return 0;
+    memcpy(hdr, p, sizeof(*hdr));
+    if (hdr->magic != APPEND_MAGIC || hdr->writer >= a->writer_n ||
+        hdr->seq >= a->records || hdr->len < a->min_len ||
+        hdr->len > a->max_len) {
+        return 0;
+    }
+    p = window_get(w, pos, hdr->len);
+    if (!p) return 0;
+
+    uint32_t footer;
+    memcpy(&footer, p + hdr->len - sizeof(footer), sizeof(footer));
+    size_t payload_len = hdr->len - APPEND_MIN_RECORD;
+    return footer == APPEND_FOOTER &&
+           record_checksum(hdr->writer, hdr->seq,
+                           (const unsigned char *)p + sizeof(*hdr),
+                           payload_len) == hdr->checksum;
+}
+
+/* 扫描起点落在 [begin, end) 内的所有记录，遇到损坏数据时逐字节重新同步 */
+static void *append_scan_job(void *arg) {
+    struct append_scan_args *a = (struct append_scan_args *)arg;
+    struct scan_window w = {0};
+    struct append_record_hdr hdr;
+
+    a->first = -1;
+    a->last_end = a->begin;
+    w.fd = open(a->path, O_RDONLY);
+    if (w.fd < 0) return NULL;
+    w.cap = APPEND_SCAN_WINDOW + a->max_len;
+    w.buf = malloc(w.cap);
+    w.file_size = a->file_size;
+    w.base = -1;
+
+    off_t pos = a->begin;
+    int in_sync = 0;
+    while (pos < a->end) {
+        if (parse_record(&w, a, pos, &hdr)) {
+            if (a->first < 0) a->first = pos;
+            size_t idx = (size_t)hdr.writer * a->records + hdr.seq;
+            if (atomic_fetch_add(&a->seen[idx], 1) != 0) a->duplicates++;
+            a->valid++;
+            pos += hdr.len;
+            a->last_end = pos;
+            in_sync = 1;
+        } else {
+            /* 已同步后的解析失败意味着记录被撕裂或交错 */
+            if (in_sync) a->torn++;
+            in_sync = 0;
+            pos++;
+        }
+    }
+
+    free(w.buf);
+    close(w.fd);
+    return NULL;
+}
+
+static int verify_append_file(const char *path, int scan_threads,
+                              uint32_t writer_n, const struct fstest_config *cfg,
+                              double *scan_mbs) {
+    struct stat st;
+    if (stat(path, &st) != 0) return -1;
+    off_t file_size = st.st_size;
+
+    size_t seen_n = (size_t)writer_n * cfg->append_records;
+    _Atomic unsigned char *seen = calloc(seen_n, sizeof(*seen));
+    pthread_t *threads = malloc(scan_threads * sizeof(pthread_t));
+    struct append_scan_args *args =
+        calloc(scan_threads, sizeof(struct append_scan_args));
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < scan_threads; i++) {
+        args[i].path = path;
+        args[i].begin = file_size * i / scan_threads;
+        args[i].end = file_size * (i + 1) / scan_threads;
+        args[i].file_size = file_size;
+        args[i].writer_n = writer_n;
+        args[i].records = (uint32_t)cfg->append_records;
+        args[i].min_len = cfg->record_min;
+        args[i].max_len = cfg->record_max;
+        args[i].seen = seen;
+        pthread_create(&threads[i], NULL, append_scan_job, &args[i]);
+    }
+    for (int i = 0; i < scan_threads; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double duration_s =
+        calculate_time_diff_ns(&start, &end) / (double)NANOS_PER_SECOND;
+    *scan_mbs = duration_s > 0.0 ? file_size / (double)_1MB_BYTES / duration_s
+                                 : 0.0;
+
+    /* 拼接各区间：每个区间的第一条记录必须紧接上一条记录的终点 */
+    uint64_t valid = 0, torn = 0, duplicates = 0, gaps = 0, missing = 0;
+    off_t cursor = 0;
+    for (int i = 0; i < scan_threads; i++) {
+        valid += args[i].valid;
+        torn += args[i].torn;
+        duplicates += args[i].duplicates;
+        if (args[i].first < 0) continue;
+        if (args[i].first != cursor) gaps++;
+        cursor = args[i].last_end;
+    }
+    if (cursor != file_size) gaps++;
+    for (size_t i = 0; i < seen_n; i++) {
+        if (seen[i] == 0) missing++;
+    }
+
+    int ret = 0;
+    if (torn == 0 && duplicates == 0 && gaps == 0 && missing == 0) {
+        char msg[160];
+        snprintf(msg, sizeof(msg),
+                 "append atomicity: %llu records intact, none torn or "
+                 "interleaved",
+                 (unsigned long long)valid);
+        TEST_PASS(msg);
+    } else {
+        char msg[192];
+        snprintf(msg, sizeof(msg),
+                 "%llu valid, %llu torn, %llu gaps, %llu duplicate, "
+                 "%llu missing records",
+                 (unsigned long long)valid, (unsigned long long)torn,
+                 (unsigned long long)gaps, (unsigned long long)duplicates,
+                 (unsigned long long)missing);
+        TEST_FAIL("append atomicity", msg);
+        ret = -1;
+    }
+
+    free(args);
+    free(threads);
+    free(seen);
+    return ret;
+}
+
+void run_append_tests(const struct fstest_config *cfg) {
+    printf("\n");
+    printf("========================================\n");
+    printf("  12. 并发追加日志 (Concurrent O_APPEND)\n");
+    printf("========================================\n");
+
+    int procs = cfg->append_procs;
+    uint32_t writer_n = (uint32_t)(procs * cfg->jobs);
+    struct fstest_config run_cfg = *cfg;
+    if (run_cfg.record_min < APPEND_MIN_RECORD) {
+        run_cfg.record_min = APPEND_MIN_RECORD;
+    }
+    if (run_cfg.record_max < run_cfg.record_min) {
+        run_cfg.record_max = run_cfg.record_min;
+    }
+
+    printf("  Writers:      %d processes x %d threads\n", procs, cfg->jobs);
+    printf("  Records:      %d per writer\n", cfg->append_records);
+    if (run_cfg.record_max > run_cfg.record_min) {
+        printf("  Record size:  %zu - %zu bytes (uniform)\n",
+               run_cfg.record_min, run_cfg.record_max);
+    } else {
+        printf("  Record size:  %zu bytes\n", run_cfg.record_min);
+    }
+    if (cfg->fsync_every > 0) {
+        printf("  fdatasync:    every %d records\n", cfg->fsync_every);
+    } else {
+        printf("  fdatasync:    never\n");
+    }
+
+    char path[MAX_PATH_LEN];
+    make_test_path(path, sizeof(path), cfg->dir, "append_log.dat");
+    int fd = open(path, O_CREAT | O_WRONLY | O_TRUNC, 0644);
+    if (fd < 0) {
+        TEST_FAIL("append log", strerror(errno));
+        return;
+    }
+    close(fd);
+
+    size_t results_size = writer_n * sizeof(struct append_result);
+    struct append_result *results =
+        mmap(NULL, results_size, PROT_READ | PROT_WRITE,
+             MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (results == MAP_FAILED) {
+        TEST_FAIL("append log", strerror(errno));
+        unlink(path);
+        return;
+    }
+    memset(results, 0, results_size);
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    if (procs == 1) {
+        run_append_process(&run_cfg, path, 0, results);
+    } else {
+        pid_t *pids = malloc(procs * sizeof(pid_t));
+        for (int p = 0; p < procs; p++) {
+            pids[p] = fork();
+            if (pids[p] == 0) {
+                run_append_process(&run_cfg, path, p, results);
+                _exit(0);
+            }
+            if (pids[p] < 0) {
+                /* fork 失败时该进程的写入者全部记为错误 */
+                for (int i = 0; i < cfg->jobs; i++) {
+                    results[p * cfg->jobs + i].errors = cfg->append_records;
+                }
+            }
+        }
+        for (int p = 0; p < procs; p++) {
+            if (pids[p] > 0) waitpid(pids[p], NULL, 0);
+        }
+        free(pids);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    struct lat_hist write_lat, fsync_lat;
+    lat_hist_init(&write_lat);
+    lat_hist_init(&fsync_lat);
+    uint64_t bytes = 0, records = 0;
+    int errors = 0;
+    for (uint32_t i = 0; i < writer_n; i++) {
+        lat_hist_merge(&write_lat, &results[i].write_lat);
+        lat_hist_merge(&fsync_lat, &results[i].fsync_lat);
+        bytes += results[i].bytes;
+        records += results[i].records;
+        errors += results[i].errors;
+    }
+    munmap(results, results_size);
+
+    double duration_s =
+        calculate_time_diff_ns(&start, &end) / (double)NANOS_PER_SECOND;
+    char lat[160];
+    printf("\n  --- 追加吞吐 (Append Throughput) ---\n");
+    printf("  Append        | %3u writers | %.2f MB/s | %.0f records/s | "
+           "%.3f s\n",
+           writer_n, bytes / (double)_1MB_BYTES / duration_s,
+           records / duration_s, duration_s);
+    lat_hist_format(&write_lat, lat, sizeof(lat));
+    printf("  write()       | %s\n", lat);
+    if (fsync_lat.count > 0) {
+        lat_hist_format(&fsync_lat, lat, sizeof(lat));
+        printf("  fdatasync()   | %s\n", lat);
+    }
+    if (errors > 0) {
+        char msg[128];
+        snprintf(msg, sizeof(msg), "%d failed appends", errors);
+        TEST_FAIL("append log", msg);
+    }
+
+    printf("\n  --- 记录原子性校验 (Record Atomicity) ---\n");
+    double scan_mbs = 0.0;
+    int scan_threads = cfg->jobs > 1 ? cfg->jobs : 4;
+    verify_append_file(path, scan_threads, writer_n, &run_cfg, &scan_mbs);
+    printf("  Parallel scan | %2d threads | %.2f MB/s\n", scan_threads,
+           scan_mbs);
+
+    unlink(path);
+    printf("--- 并发追加日志测试完成 ---\n");
+}
@@ -0,0 +1,13 @@
+/*
+    并发追加日志负载模块
+    多线程 / 多进程以 O_APPEND 向同一文件追加记录，并校验记录的原子性
+*/
+
+#ifndef FSTEST_TEST_APPEND_H
+#define FSTEST_TEST_APPEND_H
+
+#include "common.h"
+
+void run_append_tests(const struct fstest_config *cfg);
+
+#endif /* FSTEST_TEST_APPEND_H */
@@ -0,0 +1,239 @@
+/*
+    基线校准模块实现
+    - memcpy：每个线程从自己的 CALIB_SRC_SIZE (不小于 io_size) 源区域循环拷贝 io_size 大小的
+      块到一个 io_size 的目标缓冲区，模拟从页缓存读到用户缓冲区
+    - tmpfs pread：在 /dev/shm 上每个线程一个 CALIB_SRC_SIZE 文件，循环
+      pread io_size，作为文件系统读路径的最好情况；/dev/shm 不是 tmpfs 时跳过
+    - 空系统调用 (getppid) 和 clock_gettime 各循环 CALIB_LOOPS 次取平均，
+      另列出启动时测得的单次 IO 计时开销 (见 timer.h)
+    带宽类测量每项运行 CALIB_TIME_NS，多线程由 run_workers 在屏障处一起出发
+*/
+
+#include "test_calibrate.h"
+
+#include "timed_io.h"
+#include "timer.h"
+#include "worker.h"
+
+#include <linux/magic.h>
+#include <sys/syscall.h>
+#include <sys/vfs.h>
+
+#define CALIB_SRC_SIZE (16 * _1MB_BYTES)
+#define CALIB_TIME_NS (200 * 1000000L)
+#define CALIB_LOOPS 1000000
+#define CALIB_SHM_DIR "/dev/shm"
+
+enum calib_kind { CALIB_MEMCPY, CALIB_PREAD };
+
+struct calib_job {
+    enum calib_kind kind;
+    size_t io_size;
+    size_t src_size;           /* 至少一个 io_size */
+    char *src;
+    char *dst;
+    int fd;
+    uint64_t bytes;
+    uint64_t calls;
+    int failed;                /* 出错时的 errno */
+};
+
+static void *calib_job_main(void *arg) {
+    struct calib_job *j = arg;
+    size_t blocks = j->src_size / j->io_size;
+    struct timespec t0, t1;
+    size_t b = 0;
+
+    if (blocks == 0) blocks = 1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    do {
+        /* 每 64 次检查一次时间，避免计时开销混入带宽 */
+        for (int i = 0; i < 64; i++) {
+            if (j->kind == CALIB_MEMCPY) {
+                memcpy(j->dst, j->src + b * j->io_size, j->io_size);
+            } else if (pread(j->fd, j->dst, j->io_size,
+                             (off_t)(b * j->io_size)) !=
+                       (ssize_t)j->io_size) {
+                j->failed = errno ? errno : EIO;
+                return NULL;
+            }
+            j->bytes += j->io_size;
+            j->calls++;
+            if (++b == blocks) b = 0;
+        }
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+    } while (calculate_time_diff_ns(&t0, &t1) < CALIB_TIME_NS);
+    /* 防止编译器把拷贝当作无用代码消除 */
+    __asm__ volatile("" : : "r"(j->dst) : "memory");
+    return NULL;
+}
+
+static int shm_is_tmpfs(void) {
+    struct statfs sfs;
+    return statfs(CALIB_SHM_DIR, &sfs) == 0 && sfs.f_type == TMPFS_MAGIC;
+}
+
+/*
+    运行 n 个同类任务，返回合计 MB/s，出错返回 -1 并设置 errno
+    call_ns 非空时返回单次调用的平均耗时 (按线程折算)
+*/
+static double calib_run(enum calib_kind kind, int n, size_t io_size,
+                        double *call_ns) {
+    struct calib_job *jobs = calloc(n, sizeof(struct calib_job));
+    double mbs = -1.0;
+    int err = 0;
+
+    if (!jobs) {
+        errno = ENOMEM;
+        return -1.0;
+    }
+    /* 先全部置为无效，建立中途失败时清理不会关闭 fd 0 */
+    for (int i = 0; i < n; i++) jobs[i].fd = -1;
+    for (int i = 0; i < n; i++) {
+        jobs[i].kind = kind;
+        jobs[i].io_size = io_size;
+        jobs[i].src_size = io_size > CALIB_SRC_SIZE ? io_size : CALIB_SRC_SIZE;
+        jobs[i].dst = malloc(io_size);
+        if (!jobs[i].dst) {
+            err = ENOMEM;
+            goto out;
+        }
+        fill_rand_buffer(jobs[i].dst, io_size);
+        if (kind == CALIB_MEMCPY) {
+            jobs[i].src = malloc(jobs[i].src_size);
+            if (!jobs[i].src) {
+                err = ENOMEM;
+                goto out;
+            }
+            fill_rand_buffer(jobs[i].src, jobs[i].src_size);
+            continue;
+        }
+        /* 打开后立即删除，异常退出也不会在 /dev/shm 留下文件 */
+        char path[MAX_PATH_LEN];
+        snprintf(path, sizeof(path), "%s/fstest_calib_%d_%d", CALIB_SHM_DIR,
+                 (int)getpid(), i);
+        int ret = timed_io_prefill(path, jobs[i].src_size);
+        jobs[i].fd = ret == 0 ? open(path, O_RDONLY) : -1;
+        err = errno;
+        unlink(path);
+        if (jobs[i].fd < 0) goto out;
+        err = 0;
+    }
+
+    int64_t ns = run_workers(n, 0, calib_job_main, jobs,
+                             sizeof(struct calib_job));
+    uint64_t bytes = 0, calls = 0;
+    if (ns <= 0) err = EAGAIN;
+    for (int i = 0; i < n; i++) {
+        if (!err) err = jobs[i].failed;
+        bytes += jobs[i].bytes;
+        calls += jobs[i].calls;
+    }
+    if (!err) {
+        mbs = bytes / (double)_1MB_BYTES / (ns / (double)NANOS_PER_SECOND);
+        if (call_ns && calls > 0) *call_ns = (double)ns * n / calls;
+    }
+
+out:
+    for (int i = 0; i < n; i++) {
+        if (jobs[i].fd >= 0) close(jobs[i].fd);
+        free(jobs[i].src);
+        free(jobs[i].dst);
+    }
+    free(jobs);
+    errno = err;
+    return mbs;
+}
+
+static double calib_syscall_ns(void) {
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (int i = 0; i < CALIB_LOOPS; i++) syscall(SYS_getppid);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    return calculate_time_diff_ns(&t0, &t1) / (double)CALIB_LOOPS;
+}
+
+static double calib_clock_ns(void) {
+    struct timespec t0, t1, ts;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (int i = 0; i < CALIB_LOOPS; i++) {
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    return calculate_time_diff_ns(&t0, &t1) / (double)CALIB_LOOPS;
+}
+
+int calibrate_measure(size_t io_size, int threads, struct calib_baseline *b) {
+    memset(b, 0, sizeof(*b));
+    if (threads < 1) threads = 1;
+    if (threads > MAX_JOBS) threads = MAX_JOBS;
+    b->io_size = io_size;
+    b->threads = threads;
+    b->clock_ns = calib_clock_ns();
+    b->syscall_ns = calib_syscall_ns();
+    b->memcpy_mbs = calib_run(CALIB_MEMCPY, 1, io_size, NULL);
+    b->memcpy_mt_mbs = threads > 1
+                           ? calib_run(CALIB_MEMCPY, threads, io_size, NULL)
+                           : b->memcpy_mbs;
+    if (b->memcpy_mbs <= 0.0 || b->memcpy_mt_mbs <= 0.0) return -1;
+    if (shm_is_tmpfs()) {
+        b->pread_mbs = calib_run(CALIB_PREAD, 1, io_size, &b->pread_ns);
+        b->pread_mt_mbs = threads > 1
+                              ? calib_run(CALIB_PREAD, threads, io_size, NULL)
+                              : b->pread_mbs;
+        if (b->pread_mbs < 0.0 || b->pread_mt_mbs < 0.0) {
+            b->pread_errno = errno;
+            b->pread_mbs = b->pread_mt_mbs = b->pread_ns = 0.0;
+        }
+    } else {
+        b->pread_errno = -1;
+    }
+    return 0;
+}
+
+void calibrate_print(const struct calib_baseline *b) {
+    printf("  %-24s | %10.2f MB/s at %zu B\n", "memcpy (1 thread)",
+           b->memcpy_mbs, b->io_size);
+    if (b->threads > 1) {
+        char name[32];
+        snprintf(name, sizeof(name), "memcpy (%d threads)", b->threads);
+        printf("  %-24s | %10.2f MB/s\n", name, b->memcpy_mt_mbs);
+    }
+    if (b->pread_mbs > 0.0) {
+        printf("  %-24s | %10.2f MB/s | %.0f ns/call\n",
+               "tmpfs pread (1 thread)", b->pread_mbs, b->pread_ns);
+        if (b->threads > 1) {
+            char name[32];
+            snprintf(name, sizeof(name), "tmpfs pread (%d threads)",
+                     b->threads);
+            printf("  %-24s | %10.2f MB/s\n", name, b->pread_mt_mbs);
+        }
+    } else if (b->pread_errno < 0) {
+        printf("  %-24s | n/a (%s is not tmpfs)\n", "tmpfs pread",
+               CALIB_SHM_DIR);
+    } else {
+        printf("  %-24s | failed: %s\n", "tmpfs pread",
+               strerror(b->pread_errno));
+    }
+    printf("  %-24s | %10.1f ns\n", "null syscall (getppid)",
+           b->syscall_ns);
+    printf("  %-24s | %10.1f ns\n", "clock_gettime", b->clock_ns);
+    char name[32];
+    snprintf(name, sizeof(name), "per-IO timer (%s)", timer_name());
+    printf("  %-24s | %10.1f ns\n", name, timer_overhead_ns());
+}
+
+void run_calibrate_tests(const struct fstest_config *cfg) {
+    printf("\n");
+    printf("========================================\n");
+    printf("  26. 基线校准 (Baseline Calibration)\n");
+    printf("========================================\n");
+
+    struct calib_baseline b;
+    if (calibrate_measure(cfg->io_size, cfg->jobs, &b) != 0) {
+        TEST_FAIL("calibration", strerror(errno));
+    } else {
+        calibrate_print(&b);
+    }
+    printf("--- 基线校准完成 ---\n");
+}
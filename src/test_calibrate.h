@@ -0,0 +1,31 @@
+/*
+    基线校准模块
+    测量本机的内存拷贝带宽、空系统调用和计时开销，以及 tmpfs 上 pread 的
+    最好情况，供性能测试把结果表示为基线的比例，便于跨硬件比较
+*/
+
+#ifndef FSTEST_TEST_CALIBRATE_H
+#define FSTEST_TEST_CALIBRATE_H
+
+#include "common.h"
+
+struct calib_baseline {
+    size_t io_size;
+    int threads;               /* 多线程基线的线程数 */
+    double memcpy_mbs;         /* 单线程 memcpy */
+    double memcpy_mt_mbs;      /* threads 个线程合计 */
+    double pread_mbs;          /* tmpfs 单线程 pread，0 = 无 tmpfs */
+    double pread_mt_mbs;
+    double pread_ns;           /* tmpfs 单次 pread */
+    int pread_errno;           /* pread 基线失败的原因，-1 = 无 tmpfs */
+    double syscall_ns;         /* 空系统调用 */
+    double clock_ns;           /* clock_gettime(CLOCK_MONOTONIC) */
+};
+
+/* 以 io_size 为单位测量各项基线，成功返回 0，失败返回 -1 并设置 errno */
+int calibrate_measure(size_t io_size, int threads, struct calib_baseline *b);
+void calibrate_print(const struct calib_baseline *b);
+
+void run_calibrate_tests(const struct fstest_config *cfg);
+
+#endif /* FSTEST_TEST_CALIBRATE_H */
@@ -9,6 +9,8 @@
 */
 
 #include "test_concurrent.h"
+#include "fsop.h"
+#include "worker.h"
 
 #include <sys/file.h>
 
@@ -29,6 +31,17 @@ struct concurrent_create_args {
     int errors;
 };
 
+/* 运行 n 个 worker 并等待全部结束；失败时记一次 FAIL 并返回 -1 */
+static int conc_run(const struct fstest_config *cfg, const char *name, int n,
+                    void *(*fn)(void *), void *args, size_t arg_size) {
+    int64_t ret = run_workers(n, cfg->procs, fn, args, arg_size);
+    if (ret < 0) {
+        TEST_FAIL(name, worker_strerror(ret));
+        return -1;
+    }
+    return 0;
+}
+
 /* 线程函数：并发写入同一文件 */
 static void *concurrent_write_job(void *arg) {
     struct concurrent_rw_args *a = (struct concurrent_rw_args *)arg;
@@ -42,18 +55,18 @@ static void *concurrent_write_job(void *arg) {
     memset(buf, 'A' + (a->thread_id % 26), a->io_size);
 
     for (int i = 0; i < a->iterations; i++) {
-        int fd = open(a->path, O_WRONLY);
+        int fd = fs_open(a->path, O_WRONLY);
         if (fd < 0) {
             a->errors++;
             continue;
         }
         off_t offset = (off_t)(a->thread_id * a->io_size);
-        lseek(fd, offset, SEEK_SET);
-        ssize_t w = write(fd, buf, a->io_size);
+        fs_lseek(fd, offset, SEEK_SET);
+        ssize_t w = fs_write(fd, buf, a->io_size);
         if (w != (ssize_t)a->io_size) {
             a->errors++;
         }
-        close(fd);
+        fs_close(fd);
     }
 
     free(buf);
@@ -72,18 +85,18 @@ static void *concurrent_read_job(void *arg) {
     }
 
     for (int i = 0; i < a->iterations; i++) {
-        int fd = open(a->path, O_RDONLY);
+        int fd = fs_open(a->path, O_RDONLY);
         if (fd < 0) {
             a->errors++;
             continue;
         }
         off_t offset = (off_t)(a->thread_id * a->io_size);
-        lseek(fd, offset, SEEK_SET);
-        ssize_t r = read(fd, buf, a->io_size);
+        fs_lseek(fd, offset, SEEK_SET);
+        ssize_t r = fs_read(fd, buf, a->io_size);
         if (r < 0) {
             a->errors++;
         }
-        close(fd);
+        fs_close(fd);
     }
 
     free(buf);
@@ -102,20 +115,24 @@ static void test_concurrent_rw(const struct fstest_config *cfg) {
     size_t file_size = nthreads * io_size;
 
     /* 创建初始文件 */
-    int fd = open(path, O_CREAT | O_WRONLY | O_TRUNC, 0644);
+    int fd = fs_open(path, O_CREAT | O_WRONLY | O_TRUNC, 0644);
     if (fd < 0) {
         TEST_FAIL("concurrent rw", strerror(errno));
         return;
     }
     char *init_buf = calloc(1, file_size);
-    (void)!write(fd, init_buf, file_size);
+    (void)!fs_write(fd, init_buf, file_size);
     free(init_buf);
-    close(fd);
+    fs_close(fd);
 
     /* 启动写线程 */
-    pthread_t *threads = malloc(nthreads * sizeof(pthread_t));
     struct concurrent_rw_args *args =
-        malloc(nthreads * sizeof(struct concurrent_rw_args));
+        worker_args_alloc(nthreads, sizeof(*args), cfg->procs);
+    if (!args) {
+        TEST_FAIL("concurrent write", strerror(ENOMEM));
+        fs_unlink(path);
+        return;
+    }
 
     for (int i = 0; i < nthreads; i++) {
         args[i].path = path;
@@ -123,10 +140,12 @@ static void test_concurrent_rw(const struct fstest_config *cfg) {
         args[i].io_size = io_size;
         args[i].iterations = 100;
         args[i].errors = 0;
-        pthread_create(&threads[i], NULL, concurrent_write_job, &args[i]);
     }
-    for (int i = 0; i < nthreads; i++) {
-        pthread_join(threads[i], NULL);
+    if (conc_run(cfg, "concurrent write", nthreads, concurrent_write_job, args,
+                 sizeof(*args)) != 0) {
+        worker_args_free(args, nthreads, sizeof(*args), cfg->procs);
+        fs_unlink(path);
+        return;
     }
 
     int total_errors = 0;
@@ -137,18 +156,20 @@ static void test_concurrent_rw(const struct fstest_config *cfg) {
         TEST_PASS("concurrent write to same file");
     } else {
         char msg[128];
-        snprintf(msg, sizeof(msg), "%d errors in %d threads",
-                 total_errors, nthreads);
+        snprintf(msg, sizeof(msg), "%d errors in %d %s",
+                 total_errors, nthreads, worker_kind(cfg->procs));
         TEST_FAIL("concurrent write", msg);
     }
 
     /* 启动读线程 */
     for (int i = 0; i < nthreads; i++) {
         args[i].errors = 0;
-        pthread_create(&threads[i], NULL, concurrent_read_job, &args[i]);
     }
-    for (int i = 0; i < nthreads; i++) {
-        pthread_join(threads[i], NULL);
+    if (conc_run(cfg, "concurrent read", nthreads, concurrent_read_job, args,
+                 sizeof(*args)) != 0) {
+        worker_args_free(args, nthreads, sizeof(*args), cfg->procs);
+        fs_unlink(path);
+        return;
     }
 
     total_errors = 0;
@@ -159,14 +180,13 @@ static void test_concurrent_rw(const struct fstest_config *cfg) {
         TEST_PASS("concurrent read from same file");
     } else {
         char msg[128];
-        snprintf(msg, sizeof(msg), "%d errors in %d threads",
-                 total_errors, nthreads);
+        snprintf(msg, sizeof(msg), "%d errors in %d %s",
+                 total_errors, nthreads, worker_kind(cfg->procs));
         TEST_FAIL("concurrent read", msg);
     }
 
-    free(threads);
-    free(args);
-    unlink(path);
+    worker_args_free(args, nthreads, sizeof(*args), cfg->procs);
+    fs_unlink(path);
 }
 
 /* 线程函数：并发创建/删除文件 */
@@ -181,16 +201,16 @@ static void *concurrent_create_delete_job(void *arg) {
                  a->dir, a->thread_id, i);
 
         /* 创建文件 */
-        int fd = open(path, O_CREAT | O_WRONLY | O_TRUNC, 0644);
+        int fd = fs_open(path, O_CREAT | O_WRONLY | O_TRUNC, 0644);
         if (fd < 0) {
             a->errors++;
             continue;
         }
-        (void)!write(fd, "test", 4);
-        close(fd);
+        (void)!fs_write(fd, "test", 4);
+        fs_close(fd);
 
         /* 立即删除 */
-        if (unlink(path) != 0) {
+        if (fs_unlink(path) != 0) {
             a->errors++;
         }
     }
@@ -203,20 +223,23 @@ static void test_concurrent_create_delete(const struct fstest_config *cfg) {
     if (nthreads > MAX_JOBS) nthreads = MAX_JOBS;
     int files_per_thread = 100;
 
-    pthread_t *threads = malloc(nthreads * sizeof(pthread_t));
     struct concurrent_create_args *args =
-        malloc(nthreads * sizeof(struct concurrent_create_args));
+        worker_args_alloc(nthreads, sizeof(*args), cfg->procs);
+    if (!args) {
+        TEST_FAIL("concurrent create/delete", strerror(ENOMEM));
+        return;
+    }
 
     for (int i = 0; i < nthreads; i++) {
         args[i].dir = cfg->dir;
         args[i].thread_id = i;
         args[i].file_count = files_per_thread;
         args[i].errors = 0;
-        pthread_create(&threads[i], NULL, concurrent_create_delete_job,
-                       &args[i]);
     }
-    for (int i = 0; i < nthreads; i++) {
-        pthread_join(threads[i], NULL);
+    if (conc_run(cfg, "concurrent create/delete", nthreads,
+                 concurrent_create_delete_job, args, sizeof(*args)) != 0) {
+        worker_args_free(args, nthreads, sizeof(*args), cfg->procs);
+        return;
     }
 
     int total_errors = 0;
@@ -227,18 +250,17 @@ static void test_concurrent_create_delete(const struct fstest_config *cfg) {
     if (total_errors == 0) {
         char msg[128];
         snprintf(msg, sizeof(msg),
-                 "concurrent create/delete (%d threads x %d files)",
-                 nthreads, files_per_thread);
+                 "concurrent create/delete (%d %s x %d files)",
+                 nthreads, worker_kind(cfg->procs), files_per_thread);
         TEST_PASS(msg);
     } else {
         char msg[128];
-        snprintf(msg, sizeof(msg), "%d errors in %d threads",
-                 total_errors, nthreads);
+        snprintf(msg, sizeof(msg), "%d errors in %d %s",
+                 total_errors, nthreads, worker_kind(cfg->procs));
         TEST_FAIL("concurrent create/delete", msg);
     }
 
-    free(threads);
-    free(args);
+    worker_args_free(args, nthreads, sizeof(*args), cfg->procs);
 }
 
 /* 并发目录操作的线程参数 */
@@ -258,7 +280,7 @@ static void *concurrent_dir_job(void *arg) {
         snprintf(path, sizeof(path), "%s/conc_dir_%d_%d",
                  a->base_dir, a->thread_id, i);
 
-        if (mkdir(path, 0755) != 0) {
+        if (fs_mkdir(path, 0755) != 0) {
             a->errors++;
             continue;
         }
@@ -266,14 +288,14 @@ static void *concurrent_dir_job(void *arg) {
         /* 在目录中创建一个文件 */
         char fpath[MAX_PATH_LEN];
         snprintf(fpath, sizeof(fpath), "%s/test.txt", path);
-        int fd = open(fpath, O_CREAT | O_WRONLY, 0644);
+        int fd = fs_open(fpath, O_CREAT | O_WRONLY, 0644);
         if (fd >= 0) {
-            (void)!write(fd, "dir test", 8);
-            close(fd);
-            unlink(fpath);
+            (void)!fs_write(fd, "dir test", 8);
+            fs_close(fd);
+            fs_unlink(fpath);
         }
 
-        if (rmdir(path) != 0) {
+        if (fs_rmdir(path) != 0) {
             a->errors++;
         }
     }
@@ -286,19 +308,23 @@ static void test_concurrent_dir_ops(const struct fstest_config *cfg) {
     if (nthreads > MAX_JOBS) nthreads = MAX_JOBS;
     int dirs_per_thread = 50;
 
-    pthread_t *threads = malloc(nthreads * sizeof(pthread_t));
     struct concurrent_dir_args *args =
-        malloc(nthreads * sizeof(struct concurrent_dir_args));
+        worker_args_alloc(nthreads, sizeof(*args), cfg->procs);
+    if (!args) {
+        TEST_FAIL("concurrent dir ops", strerror(ENOMEM));
+        return;
+    }
 
     for (int i = 0; i < nthreads; i++) {
         args[i].base_dir = cfg->dir;
         args[i].thread_id = i;
         args[i].dir_count = dirs_per_thread;
         args[i].errors = 0;
-        pthread_create(&threads[i], NULL, concurrent_dir_job, &args[i]);
     }
-    for (int i = 0; i < nthreads; i++) {
-        pthread_join(threads[i], NULL);
+    if (conc_run(cfg, "concurrent dir ops", nthreads, concurrent_dir_job, args,
+                 sizeof(*args)) != 0) {
+        worker_args_free(args, nthreads, sizeof(*args), cfg->procs);
+        return;
     }
 
     int total_errors = 0;
@@ -309,18 +335,17 @@ static void test_concurrent_dir_ops(const struct fstest_config *cfg) {
     if (total_errors == 0) {
         char msg[128];
         snprintf(msg, sizeof(msg),
-                 "concurrent dir ops (%d threads x %d dirs)",
-                 nthreads, dirs_per_thread);
+                 "concurrent dir ops (%d %s x %d dirs)",
+                 nthreads, worker_kind(cfg->procs), dirs_per_thread);
         TEST_PASS(msg);
     } else {
         char msg[128];
-        snprintf(msg, sizeof(msg), "%d errors in %d threads",
-                 total_errors, nthreads);
+        snprintf(msg, sizeof(msg), "%d errors in %d %s",
+                 total_errors, nthreads, worker_kind(cfg->procs));
         TEST_FAIL("concurrent dir ops", msg);
     }
 
-    free(threads);
-    free(args);
+    worker_args_free(args, nthreads, sizeof(*args), cfg->procs);
 }
 
 /* 文件锁并发测试参数 */
@@ -338,34 +363,34 @@ static void *file_lock_job(void *arg) {
     a->data_errors = 0;
 
     for (int i = 0; i < a->iterations; i++) {
-        int fd = open(a->path, O_RDWR);
+        int fd = fs_open(a->path, O_RDWR);
         if (fd < 0) {
             a->lock_errors++;
             continue;
         }
 
         /* 获取排他锁 */
-        if (flock(fd, LOCK_EX) != 0) {
+        if (fs_flock(fd, LOCK_EX) != 0) {
             a->lock_errors++;
-            close(fd);
+            fs_close(fd);
             continue;
         }
 
         /* 读取当前计数器 */
-        lseek(fd, 0, SEEK_SET);
+        fs_lseek(fd, 0, SEEK_SET);
         int counter = 0;
-        if (read(fd, &counter, sizeof(counter)) != sizeof(counter)) {
+        if (fs_read(fd, &counter, sizeof(counter)) != sizeof(counter)) {
             counter = 0;
         }
 
         /* 增加计数器 */
         counter++;
-        lseek(fd, 0, SEEK_SET);
-        (void)!write(fd, &counter, sizeof(counter));
+        fs_lseek(fd, 0, SEEK_SET);
+        (void)!fs_write(fd, &counter, sizeof(counter));
 
         /* 释放锁 */
-        flock(fd, LOCK_UN);
-        close(fd);
+        fs_flock(fd, LOCK_UN);
+        fs_close(fd);
     }
     return NULL;
 }
@@ -381,42 +406,49 @@ static void test_file_lock_counter(const struct fstest_config *cfg) {
     int iterations = 100;
 
     /* 初始化计数器文件 */
-    int fd = open(path, O_CREAT | O_WRONLY | O_TRUNC, 0644);
+    int fd = fs_open(path, O_CREAT | O_WRONLY | O_TRUNC, 0644);
     if (fd < 0) {
         TEST_FAIL("file lock counter", strerror(errno));
         return;
     }
     int zero = 0;
-    (void)!write(fd, &zero, sizeof(zero));
-    close(fd);
+    (void)!fs_write(fd, &zero, sizeof(zero));
+    fs_close(fd);
 
     /* 启动线程 */
-    pthread_t *threads = malloc(nthreads * sizeof(pthread_t));
     struct lock_test_args *args =
-        malloc(nthreads * sizeof(struct lock_test_args));
+        worker_args_alloc(nthreads, sizeof(*args), cfg->procs);
+    if (!args) {
+        TEST_FAIL("file lock counter", strerror(ENOMEM));
+        fs_unlink(path);
+        return;
+    }
 
     for (int i = 0; i < nthreads; i++) {
         args[i].path = path;
         args[i].thread_id = i;
         args[i].iterations = iterations;
-        pthread_create(&threads[i], NULL, file_lock_job, &args[i]);
     }
-    for (int i = 0; i < nthreads; i++) {
-        pthread_join(threads[i], NULL);
+    if (conc_run(cfg, "file lock counter", nthreads, file_lock_job, args,
+                 sizeof(*args)) != 0) {
+        worker_args_free(args, nthreads, sizeof(*args), cfg->procs);
+        fs_unlink(path);
+        return;
     }
 
     /* 验证最终计数器值 */
-    fd = open(path, O_RDONLY);
+    fd = fs_open(path, O_RDONLY);
     int final_count = 0;
-    (void)!read(fd, &final_count, sizeof(final_count));
-    close(fd);
+    (void)!fs_read(fd, &final_count, sizeof(final_count));
+    fs_close(fd);
 
     int expected = nthreads * iterations;
     if (final_count == expected) {
         char msg[128];
         snprintf(msg, sizeof(msg),
-                 "file lock counter (%d threads x %d iter = %d)",
-                 nthreads, iterations, expected);
+                 "file lock counter (%d %s x %d iter = %d)",
+                 nthreads, worker_kind(cfg->procs), iterations,
+                 expected);
         TEST_PASS(msg);
     } else {
         char msg[128];
@@ -436,9 +468,8 @@ static void test_file_lock_counter(const struct fstest_config *cfg) {
         TEST_FAIL("file lock reliability", msg);
     }
 
-    free(threads);
-    free(args);
-    unlink(path);
+    worker_args_free(args, nthreads, sizeof(*args), cfg->procs);
+    fs_unlink(path);
 }
 
 /* 竞争条件检测：不使用锁的并发计数器 */
@@ -452,7 +483,7 @@ static void test_race_condition_detect(const struct fstest_config *cfg) {
     if (nthreads < 2) nthreads = 2;
 
     /* 创建共享文件 */
-    int fd = open(path, O_CREAT | O_RDWR | O_TRUNC, 0644);
+    int fd = fs_open(path, O_CREAT | O_RDWR | O_TRUNC, 0644);
     if (fd < 0) {
         TEST_FAIL("race condition detect", strerror(errno));
         return;
@@ -461,14 +492,18 @@ static void test_race_condition_detect(const struct fstest_config *cfg) {
     size_t chunk = 4096;
     size_t total = chunk * nthreads;
     char *init = calloc(1, total);
-    (void)!write(fd, init, total);
+    (void)!fs_write(fd, init, total);
     free(init);
-    close(fd);
+    fs_close(fd);
 
     /* 多线程同时写入不同区域（应该不冲突） */
     struct concurrent_rw_args *args =
-        malloc(nthreads * sizeof(struct concurrent_rw_args));
-    pthread_t *threads = malloc(nthreads * sizeof(pthread_t));
+        worker_args_alloc(nthreads, sizeof(*args), cfg->procs);
+    if (!args) {
+        TEST_FAIL("race condition detect", strerror(ENOMEM));
+        fs_unlink(path);
+        return;
+    }
 
     for (int i = 0; i < nthreads; i++) {
         args[i].path = path;
@@ -476,19 +511,21 @@ static void test_race_condition_detect(const struct fstest_config *cfg) {
         args[i].io_size = chunk;
         args[i].iterations = 50;
         args[i].errors = 0;
-        pthread_create(&threads[i], NULL, concurrent_write_job, &args[i]);
     }
-    for (int i = 0; i < nthreads; i++) {
-        pthread_join(threads[i], NULL);
+    if (conc_run(cfg, "race condition detect", nthreads, concurrent_write_job,
+                 args, sizeof(*args)) != 0) {
+        worker_args_free(args, nthreads, sizeof(*args), cfg->procs);
+        fs_unlink(path);
+        return;
     }
 
     /* 验证每个区域的数据 */
-    fd = open(path, O_RDONLY);
+    fd = fs_open(path, O_RDONLY);
     char *rbuf = malloc(chunk);
     int pass = 1;
     for (int i = 0; i < nthreads; i++) {
-        lseek(fd, i * chunk, SEEK_SET);
-        (void)!read(fd, rbuf, chunk);
+        fs_lseek(fd, i * chunk, SEEK_SET);
+        (void)!fs_read(fd, rbuf, chunk);
         char expected = 'A' + (i % 26);
         for (size_t j = 0; j < chunk; j++) {
             if (rbuf[j] != expected) {
@@ -498,7 +535,7 @@ static void test_race_condition_detect(const struct fstest_config *cfg) {
         }
         if (!pass) break;
     }
-    close(fd);
+    fs_close(fd);
     free(rbuf);
 
     if (pass) {
@@ -508,9 +545,8 @@ static void test_race_condition_detect(const struct fstest_config *cfg) {
                   "data corruption in isolated regions");
     }
 
-    free(args);
-    free(threads);
-    unlink(path);
+    worker_args_free(args, nthreads, sizeof(*args), cfg->procs);
+    fs_unlink(path);
 }
 
 void run_concurrent_tests(const struct fstest_config *cfg) {
@@ -10,6 +10,7 @@
 */
 
 #include "test_consistency.h"
+#include "fsop.h"
 
 #include <sys/stat.h>
 
@@ -54,40 +55,40 @@ static void test_write_read_verify(const struct fstest_config *cfg) {
     srand(42);
     fill_rand_buffer(wbuf, data_size);
 
-    int fd = open(path, O_CREAT | O_WRONLY | O_TRUNC, 0644);
+    int fd = fs_open(path, O_CREAT | O_WRONLY | O_TRUNC, 0644);
     if (fd < 0) {
         TEST_FAIL("write-read verify", strerror(errno));
         free(wbuf);
         free(rbuf);
         return;
     }
-    ssize_t w = write(fd, wbuf, data_size);
+    ssize_t w = fs_write(fd, wbuf, data_size);
     if (w != (ssize_t)data_size) {
         TEST_FAIL("write-read verify", "write incomplete");
-        close(fd);
+        fs_close(fd);
         free(wbuf);
         free(rbuf);
-        unlink(path);
+        fs_unlink(path);
         return;
     }
-    close(fd);
+    fs_close(fd);
 
     /* 读回数据 */
-    fd = open(path, O_RDONLY);
+    fd = fs_open(path, O_RDONLY);
     if (fd < 0) {
         TEST_FAIL("write-read verify", strerror(errno));
         free(wbuf);
         free(rbuf);
-        unlink(path);
+        fs_unlink(path);
         return;
     }
-    ssize_t r = read(fd, rbuf, data_size);
-    close(fd);
+    ssize_t r = fs_read(fd, rbuf, data_size);
+    fs_close(fd);
     if (r != (ssize_t)data_size) {
         TEST_FAIL("write-read verify", "read incomplete");
         free(wbuf);
         free(rbuf);
-        unlink(path);
+        fs_unlink(path);
         return;
     }
 
@@ -100,7 +101,7 @@ static void test_write_read_verify(const struct fstest_config *cfg) {
 
     free(wbuf);
     free(rbuf);
-    unlink(path);
+    fs_unlink(path);
 }
 
 /* 测试：校验和/hash比对 */
@@ -121,20 +122,20 @@ static void test_checksum_verify(const struct fstest_config *cfg) {
     uint32_t write_crc = compute_crc32(buf, data_size);
 
     /* 写入 */
-    int fd = open(path, O_CREAT | O_WRONLY | O_TRUNC, 0644);
+    int fd = fs_open(path, O_CREAT | O_WRONLY | O_TRUNC, 0644);
     if (fd < 0) {
         TEST_FAIL("checksum verify", strerror(errno));
         free(buf);
         return;
     }
-    (void)!write(fd, buf, data_size);
-    close(fd);
+    (void)!fs_write(fd, buf, data_size);
+    fs_close(fd);
 
     /* 清空buffer后读回 */
     memset(buf, 0, data_size);
-    fd = open(path, O_RDONLY);
-    (void)!read(fd, buf, data_size);
-    close(fd);
+    fd = fs_open(path, O_RDONLY);
+    (void)!fs_read(fd, buf, data_size);
+    fs_close(fd);
 
     uint32_t read_crc = compute_crc32(buf, data_size);
 
@@ -148,7 +149,7 @@ static void test_checksum_verify(const struct fstest_config *cfg) {
     }
 
     free(buf);
-    unlink(path);
+    fs_unlink(path);
 }
 
 /* 测试：随机读写一致性检查 */
@@ -168,7 +169,7 @@ static void test_random_rw_consistency(const struct fstest_config *cfg) {
         return;
     }
 
-    int fd = open(path, O_CREAT | O_RDWR | O_TRUNC, 0644);
+    int fd = fs_open(path, O_CREAT | O_RDWR | O_TRUNC, 0644);
     if (fd < 0) {
         TEST_FAIL("random rw consistency", strerror(errno));
         free(block);
@@ -178,7 +179,7 @@ static void test_random_rw_consistency(const struct fstest_config *cfg) {
     /* 每个块用块号填充 */
     for (size_t i = 0; i < block_count; i++) {
         memset(block, (int)(i & 0xFF), block_size);
-        (void)!write(fd, block, block_size);
+        (void)!fs_write(fd, block, block_size);
     }
 
     /* 随机选择若干块写入新数据，记录写入内容 */
@@ -191,8 +192,8 @@ static void test_random_rw_consistency(const struct fstest_config *cfg) {
         size_t blk = rand() % block_count;
         updated_blocks[i] = blk;
         fill_rand_buffer(updated_data + i * block_size, block_size);
-        lseek(fd, blk * block_size, SEEK_SET);
-        (void)!write(fd, updated_data + i * block_size, block_size);
+        fs_lseek(fd, blk * block_size, SEEK_SET);
+        (void)!fs_write(fd, updated_data + i * block_size, block_size);
     }
 
     /* 验证最后一次更新的块内容 */
@@ -209,15 +210,15 @@ static void test_random_rw_consistency(const struct fstest_config *cfg) {
         }
         if (overwritten) continue;
 
-        lseek(fd, blk * block_size, SEEK_SET);
+        fs_lseek(fd, blk * block_size, SEEK_SET);
         memset(block, 0, block_size);
-        (void)!read(fd, block, block_size);
+        (void)!fs_read(fd, block, block_size);
         if (memcmp(block, updated_data + i * block_size, block_size) != 0) {
             pass = 0;
             break;
         }
     }
-    close(fd);
+    fs_close(fd);
 
     if (pass) {
         TEST_PASS("random read/write consistency");
@@ -229,7 +230,7 @@ static void test_random_rw_consistency(const struct fstest_config *cfg) {
     free(block);
     free(updated_blocks);
     free(updated_data);
-    unlink(path);
+    fs_unlink(path);
 }
 
 /* 测试：大文件、小文件、空文件 */
@@ -238,36 +239,36 @@ static void test_various_file_sizes(const struct fstest_config *cfg) {
 
     /* 空文件 */
     make_test_path(path, sizeof(path), cfg->dir, "consist_empty.dat");
-    int fd = open(path, O_CREAT | O_WRONLY | O_TRUNC, 0644);
+    int fd = fs_open(path, O_CREAT | O_WRONLY | O_TRUNC, 0644);
     if (fd < 0) {
         TEST_FAIL("empty file", strerror(errno));
         return;
     }
-    close(fd);
+    fs_close(fd);
     struct stat st;
-    stat(path, &st);
+    fs_stat(path, &st);
     if (st.st_size != 0) {
         TEST_FAIL("empty file", "size not zero");
     } else {
         TEST_PASS("empty file (0 bytes)");
     }
-    unlink(path);
+    fs_unlink(path);
 
     /* 小文件 (1 byte) */
     make_test_path(path, sizeof(path), cfg->dir, "consist_tiny.dat");
-    fd = open(path, O_CREAT | O_WRONLY | O_TRUNC, 0644);
-    (void)!write(fd, "X", 1);
-    close(fd);
-    fd = open(path, O_RDONLY);
+    fd = fs_open(path, O_CREAT | O_WRONLY | O_TRUNC, 0644);
+    (void)!fs_write(fd, "X", 1);
+    fs_close(fd);
+    fd = fs_open(path, O_RDONLY);
     char c = 0;
-    (void)!read(fd, &c, 1);
-    close(fd);
+    (void)!fs_read(fd, &c, 1);
+    fs_close(fd);
     if (c == 'X') {
         TEST_PASS("tiny file (1 byte)");
     } else {
         TEST_FAIL("tiny file", "content mismatch");
     }
-    unlink(path);
+    fs_unlink(path);
 
     /* 较大文件 (使用配置的 file_size, 至少 1MB) */
     size_t large_size = cfg->file_size > _1MB_BYTES ? cfg->file_size : _1MB_BYTES;
@@ -276,7 +277,7 @@ static void test_various_file_sizes(const struct fstest_config *cfg) {
         large_size = 64 * _1MB_BYTES;
     }
     make_test_path(path, sizeof(path), cfg->dir, "consist_large.dat");
-    fd = open(path, O_CREAT | O_WRONLY | O_TRUNC, 0644);
+    fd = fs_open(path, O_CREAT | O_WRONLY | O_TRUNC, 0644);
     if (fd < 0) {
         TEST_FAIL("large file", strerror(errno));
         return;
@@ -286,7 +287,7 @@ static void test_various_file_sizes(const struct fstest_config *cfg) {
     char *buf = malloc(block_size);
     if (!buf) {
         TEST_FAIL("large file", "malloc failed");
-        close(fd);
+        fs_close(fd);
         return;
     }
 
@@ -304,21 +305,21 @@ static void test_various_file_sizes(const struct fstest_config *cfg) {
         for (size_t i = 0; i < to_write; i++) {
             write_crc = crc32_byte(write_crc, p[i]);
         }
-        ssize_t w = write(fd, buf, to_write);
+        ssize_t w = fs_write(fd, buf, to_write);
         if (w != (ssize_t)to_write) {
             TEST_FAIL("large file", "write incomplete");
-            close(fd);
+            fs_close(fd);
             free(buf);
-            unlink(path);
+            fs_unlink(path);
             return;
         }
         written += to_write;
     }
     write_crc ^= 0xFFFFFFFF;
-    close(fd);
+    fs_close(fd);
 
     /* 读回校验 */
-    fd = open(path, O_RDONLY);
+    fd = fs_open(path, O_RDONLY);
     uint32_t read_crc = 0xFFFFFFFF;
     size_t total_read = 0;
     while (total_read < large_size) {
@@ -326,7 +327,7 @@ static void test_various_file_sizes(const struct fstest_config *cfg) {
         if (total_read + to_read > large_size) {
             to_read = large_size - total_read;
         }
-        ssize_t r = read(fd, buf, to_read);
+        ssize_t r = fs_read(fd, buf, to_read);
         if (r <= 0) break;
         const uint8_t *p = (const uint8_t *)buf;
         for (size_t i = 0; i < (size_t)r; i++) {
@@ -335,7 +336,7 @@ static void test_various_file_sizes(const struct fstest_config *cfg) {
         total_read += r;
     }
     read_crc ^= 0xFFFFFFFF;
-    close(fd);
+    fs_close(fd);
 
     if (write_crc == read_crc && total_read == large_size) {
         char msg[64];
@@ -347,7 +348,7 @@ static void test_various_file_sizes(const struct fstest_config *cfg) {
     }
 
     free(buf);
-    unlink(path);
+    fs_unlink(path);
 }
 
 /* 测试：稀疏文件 */
@@ -355,7 +356,7 @@ static void test_sparse_file(const struct fstest_config *cfg) {
     char path[MAX_PATH_LEN];
     make_test_path(path, sizeof(path), cfg->dir, "consist_sparse.dat");
 
-    int fd = open(path, O_CREAT | O_RDWR | O_TRUNC, 0644);
+    int fd = fs_open(path, O_CREAT | O_RDWR | O_TRUNC, 0644);
     if (fd < 0) {
         TEST_FAIL("sparse file", strerror(errno));
         return;
@@ -365,27 +366,27 @@ static void test_sparse_file(const struct fstest_config *cfg) {
     off_t sparse_offset = 1 * _1MB_BYTES;
     const char *data = "sparse data here";
     size_t data_len = strlen(data);
-    lseek(fd, sparse_offset, SEEK_SET);
-    (void)!write(fd, data, data_len);
-    close(fd);
+    fs_lseek(fd, sparse_offset, SEEK_SET);
+    (void)!fs_write(fd, data, data_len);
+    fs_close(fd);
 
     /* 验证文件大小 */
     struct stat st;
-    stat(path, &st);
+    fs_stat(path, &st);
     if (st.st_size != (off_t)(sparse_offset + data_len)) {
         TEST_FAIL("sparse file", "size mismatch");
-        unlink(path);
+        fs_unlink(path);
         return;
     }
 
     /* 读取空洞区域应该是0 */
-    fd = open(path, O_RDONLY);
+    fd = fs_open(path, O_RDONLY);
     char buf[4096] = {0};
-    ssize_t r = read(fd, buf, sizeof(buf));
+    ssize_t r = fs_read(fd, buf, sizeof(buf));
     if (r <= 0) {
         TEST_FAIL("sparse file", "read failed");
-        close(fd);
-        unlink(path);
+        fs_close(fd);
+        fs_unlink(path);
         return;
     }
     int all_zero = 1;
@@ -397,16 +398,16 @@ static void test_sparse_file(const struct fstest_config *cfg) {
     }
     if (!all_zero) {
         TEST_FAIL("sparse file", "hole region not zero");
-        close(fd);
-        unlink(path);
+        fs_close(fd);
+        fs_unlink(path);
         return;
     }
 
     /* 读取写入的数据 */
-    lseek(fd, sparse_offset, SEEK_SET);
+    fs_lseek(fd, sparse_offset, SEEK_SET);
     memset(buf, 0, sizeof(buf));
-    r = read(fd, buf, data_len);
-    close(fd);
+    r = fs_read(fd, buf, data_len);
+    fs_close(fd);
     if (r == (ssize_t)data_len && memcmp(buf, data, data_len) == 0) {
         TEST_PASS("sparse file (hole + data)");
     } else {
@@ -421,7 +422,7 @@ static void test_sparse_file(const struct fstest_config *cfg) {
                   "filesystem may not support sparse files");
     }
 
-    unlink(path);
+    fs_unlink(path);
 }
 
 /* 测试：反复覆盖写后的结果验证 */
@@ -440,7 +441,7 @@ static void test_repeated_overwrite(const struct fstest_config *cfg) {
         return;
     }
 
-    int fd = open(path, O_CREAT | O_RDWR | O_TRUNC, 0644);
+    int fd = fs_open(path, O_CREAT | O_RDWR | O_TRUNC, 0644);
     if (fd < 0) {
         TEST_FAIL("repeated overwrite", strerror(errno));
         free(wbuf);
@@ -450,7 +451,7 @@ static void test_repeated_overwrite(const struct fstest_config *cfg) {
 
     /* 写入初始数据 */
     fill_rand_buffer(wbuf, data_size);
-    (void)!write(fd, wbuf, data_size);
+    (void)!fs_write(fd, wbuf, data_size);
 
     /* 反复覆盖 50 次 */
     int pass = 1;
@@ -460,23 +461,23 @@ static void test_repeated_overwrite(const struct fstest_config *cfg) {
         srand(i * 31 + 7);
         fill_rand_buffer(wbuf, data_size);
 
-        lseek(fd, 0, SEEK_SET);
-        ssize_t w = write(fd, wbuf, data_size);
+        fs_lseek(fd, 0, SEEK_SET);
+        ssize_t w = fs_write(fd, wbuf, data_size);
         if (w != (ssize_t)data_size) {
             pass = 0;
             break;
         }
 
         /* 立即读回验证 */
-        lseek(fd, 0, SEEK_SET);
-        ssize_t r = read(fd, rbuf, data_size);
+        fs_lseek(fd, 0, SEEK_SET);
+        ssize_t r = fs_read(fd, rbuf, data_size);
         if (r != (ssize_t)data_size ||
             memcmp(wbuf, rbuf, data_size) != 0) {
             pass = 0;
             break;
         }
     }
-    close(fd);
+    fs_close(fd);
 
     if (pass) {
         char msg[64];
@@ -490,7 +491,7 @@ static void test_repeated_overwrite(const struct fstest_config *cfg) {
 
     free(wbuf);
     free(rbuf);
-    unlink(path);
+    fs_unlink(path);
 }
 
 void run_consistency_tests(const struct fstest_config *cfg) {
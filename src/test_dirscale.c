@@ -0,0 +1,227 @@
+/*
+    大目录扩展性基准模块实现
+    把同一个目录逐级填充到 --dir-sizes 指定的条目数，在每个规模上测量：
+    - getdents64 全量枚举吞吐 (按 --dents-bufs 指定的多种缓冲区大小)
+    - 命中查找 (已存在条目) 和未命中查找 (ENOENT) 的延迟
+    - 在该规模上新建和删除条目的单次开销
+    结果按目录规模输出为一张开销曲线表
+*/
+
+#include "test_dirscale.h"
+
+#include "timer.h"
+
+#include <sys/stat.h>
+#include <sys/syscall.h>
+
+#define DIRSCALE_MAX_POINTS 16
+#define DIRSCALE_MAX_BUFS 8
+#define DIRSCALE_LOOKUPS 2000
+#define DIRSCALE_PROBES 1000
+
+static void entry_name(char *out, size_t out_size, long index) {
+    snprintf(out, out_size, "e%09ld", index);
+}
+
+/* 用 getdents64 完整枚举一次目录，返回条目数 */
+static long enumerate_dir(int dirfd, char *buf, size_t buf_size) {
+    long entries = 0;
+    if (lseek(dirfd, 0, SEEK_SET) < 0) return -1;
+    for (;;) {
+        long n = syscall(SYS_getdents64, dirfd, buf, buf_size);
+        if (n < 0) return -1;
+        if (n == 0) break;
+        for (long off = 0; off < n;) {
+            /* struct linux_dirent64: d_ino(8) d_off(8) d_reclen(2) ... */
+            unsigned short reclen;
+            memcpy(&reclen, buf + off + 16, sizeof(reclen));
+            entries++;
+            off += reclen;
+        }
+    }
+    return entries;
+}
+
+/* 查找 count 次：hit 时查找已存在的随机条目，否则查找不存在的名字 */
+static int time_lookups(int dirfd, long population, int hit, int count,
+                        struct lat_hist *hist) {
+    unsigned int seed = hit ? 4242 : 2424;
+    char name[32];
+    struct stat st;
+    uint64_t t0, t1;
+    int errors = 0;
+
+    lat_hist_init(hist);
+    for (int i = 0; i < count; i++) {
+        long index = ((long)rand_r(&seed) * RAND_MAX + rand_r(&seed)) %
+                     population;
+        if (hit) {
+            entry_name(name, sizeof(name), index);
+        } else {
+            snprintf(name, sizeof(name), "miss%09ld", index);
+        }
+        t0 = timer_now();
+        int ret = fstatat(dirfd, name, &st, AT_SYMLINK_NOFOLLOW);
+        t1 = timer_now();
+        if ((hit && ret != 0) || (!hit && (ret == 0 || errno != ENOENT))) {
+            errors++;
+            continue;
+        }
+        lat_hist_add(hist, timer_diff_ns(t0, t1));
+    }
+    return errors;
+}
+
+static int create_entry(int dirfd, long index) {
+    char name[32];
+    entry_name(name, sizeof(name), index);
+    int fd = openat(dirfd, name, O_CREAT | O_EXCL | O_WRONLY, 0644);
+    if (fd < 0) return -1;
+    return close(fd);
+}
+
+static int unlink_entry(int dirfd, long index) {
+    char name[32];
+    entry_name(name, sizeof(name), index);
+    return unlinkat(dirfd, name, 0);
+}
+
+void run_dirscale_tests(const struct fstest_config *cfg) {
+    printf("\n");
+    printf("========================================\n");
+    printf("  9. 大目录扩展性基准 (Directory Scaling)\n");
+    printf("========================================\n");
+
+    size_t sizes[DIRSCALE_MAX_POINTS], bufs[DIRSCALE_MAX_BUFS];
+    int size_n = parse_size_list(cfg->dir_sizes, sizes, DIRSCALE_MAX_POINTS);
+    int buf_n = parse_size_list(cfg->dents_bufs, bufs, DIRSCALE_MAX_BUFS);
+    if (size_n <= 0 || buf_n <= 0) {
+        TEST_FAIL("dirscale", "invalid --dir-sizes or --dents-bufs list");
+        return;
+    }
+    for (int i = 0; i < size_n; i++) {
+        if (sizes[i] < 1) {
+            TEST_FAIL("dirscale", "--dir-sizes values must be >= 1");
+            return;
+        }
+        /* 目录只增不减地填充，规模必须递增 */
+        if (i > 0 && sizes[i] <= sizes[i - 1]) {
+            TEST_FAIL("dirscale", "--dir-sizes must be strictly increasing");
+            return;
+        }
+    }
+    size_t max_buf = 0;
+    for (int i = 0; i < buf_n; i++) {
+        if (bufs[i] < 1024) bufs[i] = 1024;
+        if (bufs[i] > max_buf) max_buf = bufs[i];
+    }
+
+    char path[MAX_PATH_LEN];
+    make_test_path(path, sizeof(path), cfg->dir, "dirscale");
+    if (mkdir(path, 0755) != 0 && errno != EEXIST) {
+        TEST_FAIL("dirscale", strerror(errno));
+        return;
+    }
+    int dirfd = open(path, O_RDONLY | O_DIRECTORY);
+    if (dirfd < 0) {
+        TEST_FAIL("dirscale", strerror(errno));
+        rmdir(path);
+        return;
+    }
+    char *dents = malloc(max_buf);
+
+    printf("  Sizes:        %s\n", cfg->dir_sizes);
+    printf("  Dents bufs:   %s\n", cfg->dents_bufs);
+    printf("\n  --- 目录规模曲线 (Cost vs. Directory Size) ---\n");
+    printf("  %9s | %9s | %9s | %9s | %9s | %9s | %9s", "entries",
+           "create us", "unlink us", "hit avg", "hit p99", "miss avg",
+           "miss p99");
+    for (int b = 0; b < buf_n; b++) {
+        char label[24];
+        snprintf(label, sizeof(label), "rd %zuK", bufs[b] / _1KB_BYTES);
+        printf(" | %9s", label);
+    }
+    printf("\n  %9s   %9s   %9s   %9s   %9s   %9s   %9s", "", "", "", "(us)",
+           "(us)", "(us)", "(us)");
+    for (int b = 0; b < buf_n; b++) {
+        printf("   %9s", "(ns/ent)");
+    }
+    printf("\n");
+
+    long population = 0;
+    int errors = 0;
+    struct timespec start, end;
+    for (int s = 0; s < size_n; s++) {
+        long target = (long)sizes[s];
+
+        /* 填充到目标规模 (不计入曲线) */
+        while (population < target) {
+            if (create_entry(dirfd, population) != 0) break;
+            population++;
+        }
+        if (population < target) {
+            char msg[128];
+            snprintf(msg, sizeof(msg), "fill stopped at %ld entries: %s",
+                     population, strerror(errno));
+            TEST_FAIL("dirscale fill", msg);
+            break;
+        }
+
+        /* 在当前规模上额外新建再删除一批条目，得到单次开销 */
+        int probes = DIRSCALE_PROBES;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (int i = 0; i < probes; i++) {
+            if (create_entry(dirfd, population + i) != 0) errors++;
+        }
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        double create_us =
+            calculate_time_diff_ns(&start, &end) / 1000.0 / probes;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (int i = 0; i < probes; i++) {
+            if (unlink_entry(dirfd, population + i) != 0) errors++;
+        }
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        double unlink_us =
+            calculate_time_diff_ns(&start, &end) / 1000.0 / probes;
+
+        struct lat_hist hit, miss;
+        errors += time_lookups(dirfd, population, 1, DIRSCALE_LOOKUPS, &hit);
+        errors += time_lookups(dirfd, population, 0, DIRSCALE_LOOKUPS, &miss);
+
+        printf("  %9ld | %9.2f | %9.2f | %9.2f | %9.2f | %9.2f | %9.2f",
+               population, create_us, unlink_us,
+               hit.count ? hit.sum_ns / 1000.0 / hit.count : 0.0,
+               lat_hist_percentile(&hit, 99.0) / 1000.0,
+               miss.count ? miss.sum_ns / 1000.0 / miss.count : 0.0,
+               lat_hist_percentile(&miss, 99.0) / 1000.0);
+
+        for (int b = 0; b < buf_n; b++) {
+            clock_gettime(CLOCK_MONOTONIC, &start);
+            long seen = enumerate_dir(dirfd, dents, bufs[b]);
+            clock_gettime(CLOCK_MONOTONIC, &end);
+            /* "." 和 ".." 也会被枚举出来 */
+            if (seen != population + 2) errors++;
+            printf(" | %9.1f", seen > 0 ? calculate_time_diff_ns(&start, &end) /
+                                              (double)seen
+                                        : 0.0);
+        }
+        printf("\n");
+        fflush(stdout);
+    }
+
+    if (errors > 0) {
+        char msg[128];
+        snprintf(msg, sizeof(msg), "%d failed directory operations", errors);
+        TEST_FAIL("dirscale", msg);
+    }
+
+    printf("\n  Cleaning up %ld entries...\n", population);
+    for (long i = 0; i < population; i++) {
+        unlink_entry(dirfd, i);
+    }
+    close(dirfd);
+    free(dents);
+    rmdir(path);
+
+    printf("--- 大目录扩展性基准完成 ---\n");
+}
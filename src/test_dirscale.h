@@ -0,0 +1,13 @@
+/*
+    大目录扩展性基准模块
+    衡量目录操作开销随目录条目数增长的变化
+*/
+
+#ifndef FSTEST_TEST_DIRSCALE_H
+#define FSTEST_TEST_DIRSCALE_H
+
+#include "common.h"
+
+void run_dirscale_tests(const struct fstest_config *cfg);
+
+#endif /* FSTEST_TEST_DIRSCALE_H */
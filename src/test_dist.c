@@ -0,0 +1,417 @@
+/*
+    多节点协同运行模块实现
+    agent (-m agent)：监听 --port 端口，逐个处理 controller 会话：
+    - 收到负载描述后在 <测试目录>/dist_nXX 下为每个 worker 预填一个文件
+    - 应答时钟同步探测，按 controller 指定的绝对时刻出发，运行固定时长
+    - 回传字节数、操作数、错误数、起止时刻和延迟直方图，清理后等待下一个会话
+    controller (-m controller)：连接 --agents 中的全部 agent：
+    - 下发 --dist-op / -j / -s / -f / --dist-time / --procs
+    - 对每个 agent 做若干轮 ping，取往返最短的一轮估计时钟偏差
+    - 给每个 agent 换算到其本地时钟的同一出发时刻
+    - 汇总逐节点结果，合并直方图得到全体客户端的聚合带宽和尾延迟
+*/
+
+#include "test_dist.h"
+
+#include "dist.h"
+#include "timed_io.h"
+#include "worker.h"
+
+#include <netdb.h>
+#include <signal.h>
+#include <sys/socket.h>
+
+#define DIST_MAX_NODES 64
+#define DIST_SYNC_ROUNDS 8
+#define DIST_START_DELAY_NS (500 * 1000 * 1000L) /* 发令到出发的余量 */
+#define DIST_RESULT_SLACK_S 60                    /* 等待结果的额外超时 */
+
+/* ====== agent 端 ====== */
+
+static void agent_session(const struct fstest_config *cfg, int fd,
+                          const char *peer) {
+    struct dist_msg msg;
+    uint64_t reply[DIST_MSG_ARGS] = {0};
+
+    if (dist_recv_msg(fd, &msg) != 0 || msg.type != DIST_HELLO) {
+        TEST_FAIL(peer, "bad hello");
+        return;
+    }
+    if (msg.arg[DIST_H_VERSION] != DIST_VERSION) {
+        reply[0] = EPROTO;
+        dist_send_msg(fd, DIST_READY, reply);
+        TEST_FAIL(peer, "protocol version mismatch");
+        return;
+    }
+    int node = (int)msg.arg[DIST_H_NODE];
+    int op = (int)msg.arg[DIST_H_OP];
+    int jobs = (int)msg.arg[DIST_H_JOBS];
+    size_t io_size = msg.arg[DIST_H_IO_SIZE];
+    size_t file_size = msg.arg[DIST_H_FILE_SIZE];
+    uint64_t duration_ns = msg.arg[DIST_H_DURATION_NS];
+    int procs = msg.arg[DIST_H_PROCS] != 0;
+    if (jobs < 1) jobs = 1;
+    if (jobs > MAX_JOBS) jobs = MAX_JOBS;
+    if (op < 0 || op > RAND_WRITE || io_size == 0) {
+        reply[0] = EINVAL;
+        dist_send_msg(fd, DIST_READY, reply);
+        TEST_FAIL(peer, "invalid workload");
+        return;
+    }
+    if (file_size < io_size) file_size = io_size;
+
+    printf("\n  Session:      %s, node %d\n", peer, node);
+    printf("  Workload:     %s | %d %s | IO %zu B | file %zu MB | %.1f s\n",
+           test_type_key(op), jobs, worker_kind(procs), io_size,
+           file_size / _1MB_BYTES, duration_ns / (double)NANOS_PER_SECOND);
+
+    char dir[MAX_PATH_LEN];
+    char name[32];
+    snprintf(name, sizeof(name), "dist_n%02d", node);
+    make_test_path(dir, sizeof(dir), cfg->dir, name);
+    struct timed_io_args *args =
+        worker_args_alloc(jobs, sizeof(struct timed_io_args), procs);
+    int err = 0;
+    if (!args || (mkdir(dir, 0755) != 0 && errno != EEXIST)) err = errno;
+    for (int i = 0; i < jobs && err == 0; i++) {
+        snprintf(args[i].path, sizeof(args[i].path), "%s/f%02d", dir, i);
+        if (timed_io_prefill(args[i].path, file_size) != 0) err = errno;
+    }
+    reply[0] = err;
+    if (dist_send_msg(fd, DIST_READY, reply) != 0 || err != 0) {
+        TEST_FAIL("agent prepare", strerror(err ? err : errno));
+        goto out;
+    }
+
+    /* 应答时钟同步探测直到收到发令 */
+    for (;;) {
+        if (dist_recv_msg(fd, &msg) != 0) {
+            TEST_FAIL("agent sync", strerror(errno));
+            goto out;
+        }
+        if (msg.type == DIST_START) break;
+        if (msg.type != DIST_PING) {
+            TEST_FAIL("agent sync", "unexpected message");
+            goto out;
+        }
+        reply[0] = realtime_ns();
+        if (dist_send_msg(fd, DIST_PONG, reply) != 0) {
+            TEST_FAIL("agent sync", strerror(errno));
+            goto out;
+        }
+    }
+
+    for (int i = 0; i < jobs; i++) {
+        args[i].type = (enum test_type)op;
+        args[i].io_size = io_size;
+        args[i].file_size = file_size;
+        args[i].start_ns = msg.arg[0];
+        args[i].duration_ns = duration_ns;
+        args[i].seed = (unsigned int)(node * MAX_JOBS + i + 1);
+    }
+    int64_t ret = run_workers(jobs, procs, timed_io_job, args,
+                              sizeof(struct timed_io_args));
+
+    struct lat_hist hist;
+    uint64_t result[DIST_MSG_ARGS] = {0};
+    lat_hist_init(&hist);
+    result[DIST_R_STATUS] =
+        ret == WORKER_ERR_EXIT ? ECHILD : ret < 0 ? EAGAIN : 0;
+    result[DIST_R_START_NS] = UINT64_MAX;
+    for (int i = 0; i < jobs && ret >= 0; i++) {
+        result[DIST_R_BYTES] += args[i].bytes;
+        result[DIST_R_OPS] += args[i].ops;
+        result[DIST_R_ERRORS] += args[i].errors;
+        if (args[i].t_start && args[i].t_start < result[DIST_R_START_NS]) {
+            result[DIST_R_START_NS] = args[i].t_start;
+        }
+        if (args[i].t_end > result[DIST_R_END_NS]) {
+            result[DIST_R_END_NS] = args[i].t_end;
+        }
+        lat_hist_merge(&hist, &args[i].hist);
+    }
+    if (result[DIST_R_START_NS] == UINT64_MAX) result[DIST_R_START_NS] = 0;
+    if (dist_send_msg(fd, DIST_RESULT, result) != 0 ||
+        dist_send_hist(fd, &hist) != 0) {
+        TEST_FAIL("agent result", strerror(errno));
+        goto out;
+    }
+
+    double duration_s =
+        (double)(result[DIST_R_END_NS] - result[DIST_R_START_NS]) /
+        NANOS_PER_SECOND;
+    char lat[160];
+    lat_hist_format(&hist, lat, sizeof(lat));
+    printf("  Result:       %.2f MB/s | %.0f ops/s | %llu errors\n",
+           duration_s > 0.0
+               ? result[DIST_R_BYTES] / (double)_1MB_BYTES / duration_s
+               : 0.0,
+           duration_s > 0.0 ? result[DIST_R_OPS] / duration_s : 0.0,
+           (unsigned long long)result[DIST_R_ERRORS]);
+    printf("  Latency:      %s\n", lat);
+
+out:
+    worker_args_free(args, jobs, sizeof(struct timed_io_args), procs);
+    remove_dir_recursive(dir);
+}
+
+void run_agent_tests(const struct fstest_config *cfg) {
+    printf("\n");
+    printf("========================================\n");
+    printf("  19. 多节点 agent (Distributed Agent)\n");
+    printf("========================================\n");
+
+    /* controller 中途断开时 send 返回 EPIPE 而不是终止进程 */
+    signal(SIGPIPE, SIG_IGN);
+    int lfd = dist_listen(cfg->dist_port);
+    if (lfd < 0) {
+        TEST_FAIL("agent listen", strerror(errno));
+        return;
+    }
+    printf("  Listening:    port %d (Ctrl-C 退出)\n", cfg->dist_port);
+    fflush(stdout);
+
+    for (;;) {
+        struct sockaddr_storage peer_addr;
+        socklen_t peer_len = sizeof(peer_addr);
+        int fd = accept(lfd, (struct sockaddr *)&peer_addr, &peer_len);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            TEST_FAIL("agent accept", strerror(errno));
+            break;
+        }
+        char host[128], serv[16], peer[160];
+        if (getnameinfo((struct sockaddr *)&peer_addr, peer_len, host,
+                        sizeof(host), serv, sizeof(serv),
+                        NI_NUMERICHOST | NI_NUMERICSERV) != 0) {
+            snprintf(host, sizeof(host), "?");
+            snprintf(serv, sizeof(serv), "?");
+        }
+        snprintf(peer, sizeof(peer), "%s:%s", host, serv);
+        agent_session(cfg, fd, peer);
+        close(fd);
+        fflush(stdout);
+    }
+
+    close(lfd);
+    printf("--- 多节点 agent 结束 ---\n");
+}
+
+/* ====== controller 端 ====== */
+
+struct dist_node {
+    char addr[MAX_PATH_LEN];
+    int fd;
+    int64_t offset_ns;         /* agent 时钟 - controller 时钟 */
+    uint64_t rtt_ns;           /* 最短往返时间 */
+    uint64_t result[DIST_MSG_ARGS];
+    struct lat_hist hist;
+};
+
+static int parse_agent_list(const char *list, struct dist_node *nodes,
+                            int max_nodes) {
+    char buf[MAX_PATH_LEN];
+    char *save = NULL;
+    int n = 0;
+    snprintf(buf, sizeof(buf), "%s", list);
+    for (char *tok = strtok_r(buf, ",", &save); tok && n < max_nodes;
+         tok = strtok_r(NULL, ",", &save)) {
+        if (*tok == '\0') continue;
+        snprintf(nodes[n].addr, sizeof(nodes[n].addr), "%s", tok);
+        nodes[n].fd = -1;
+        n++;
+    }
+    return n;
+}
+
+/* 取往返最短的一轮，假设链路对称，偏差 = agent 时间 - 往返中点 */
+static int dist_clock_sync(struct dist_node *node) {
+    struct dist_msg msg;
+    uint64_t args[DIST_MSG_ARGS] = {0};
+    node->rtt_ns = UINT64_MAX;
+    for (int r = 0; r < DIST_SYNC_ROUNDS; r++) {
+        uint64_t t0 = realtime_ns();
+        args[0] = t0;
+        if (dist_send_msg(node->fd, DIST_PING, args) != 0) return -1;
+        if (dist_recv_msg(node->fd, &msg) != 0) return -1;
+        uint64_t t1 = realtime_ns();
+        if (msg.type != DIST_PONG) {
+            errno = EPROTO;
+            return -1;
+        }
+        if (t1 - t0 < node->rtt_ns) {
+            node->rtt_ns = t1 - t0;
+            node->offset_ns = (int64_t)(msg.arg[0] - (t0 + (t1 - t0) / 2));
+        }
+    }
+    return 0;
+}
+
+static void dist_node_fail(struct dist_node *node, const char *what) {
+    char name[MAX_PATH_LEN + 32];
+    snprintf(name, sizeof(name), "%s %s", node->addr, what);
+    TEST_FAIL(name, strerror(errno));
+}
+
+static void print_controller_report(const struct dist_node *nodes, int n) {
+    struct lat_hist total;
+    uint64_t bytes = 0, ops = 0, errors = 0;
+    int64_t first_start = INT64_MAX, last_start = INT64_MIN;
+    int64_t last_end = INT64_MIN;
+    double node_mbs_sum = 0.0;
+    char lat[160];
+
+    lat_hist_init(&total);
+    printf("\n  %-4s | %-21s | %10s | %7s | %9s | %9s | %6s | latency\n",
+           "node", "agent", "offset us", "rtt us", "MB/s", "ops/s", "errors");
+    for (int i = 0; i < n; i++) {
+        const struct dist_node *d = &nodes[i];
+        const uint64_t *r = d->result;
+        /* 换算到 controller 时钟 */
+        int64_t start = (int64_t)r[DIST_R_START_NS] - d->offset_ns;
+        int64_t end = (int64_t)r[DIST_R_END_NS] - d->offset_ns;
+        double node_s = (end - start) / (double)NANOS_PER_SECOND;
+        double node_mbs =
+            node_s > 0.0 ? r[DIST_R_BYTES] / (double)_1MB_BYTES / node_s : 0;
+
+        if (start < first_start) first_start = start;
+        if (start > last_start) last_start = start;
+        if (end > last_end) last_end = end;
+        bytes += r[DIST_R_BYTES];
+        ops += r[DIST_R_OPS];
+        errors += r[DIST_R_ERRORS];
+        node_mbs_sum += node_mbs;
+        lat_hist_merge(&total, &d->hist);
+
+        lat_hist_format(&d->hist, lat, sizeof(lat));
+        printf("  %-4d | %-21s | %10.1f | %7.1f | %9.2f | %9.0f | %6llu | "
+               "%s\n",
+               i, d->addr, d->offset_ns / 1000.0, d->rtt_ns / 1000.0,
+               node_mbs, node_s > 0.0 ? r[DIST_R_OPS] / node_s : 0.0,
+               (unsigned long long)r[DIST_R_ERRORS], lat);
+    }
+
+    double window_s = (last_end - first_start) / (double)NANOS_PER_SECOND;
+    lat_hist_format(&total, lat, sizeof(lat));
+    printf("\n  --- 聚合结果 (Aggregate, %d nodes) ---\n", n);
+    printf("  Start skew:   %.1f us (controller 时钟下最早到最晚出发)\n",
+           (last_start - first_start) / 1000.0);
+    printf("  Window:       %.3f s\n", window_s);
+    if (window_s > 0.0) {
+        printf("  Bandwidth:    %.2f MB/s (sum of nodes %.2f MB/s)\n",
+               bytes / (double)_1MB_BYTES / window_s, node_mbs_sum);
+        printf("  IOPS:         %.0f ops/s\n", ops / window_s);
+    }
+    printf("  Latency:      %s\n", lat);
+    if (errors > 0) {
+        char msg[64];
+        snprintf(msg, sizeof(msg), "%llu failed ops across nodes",
+                 (unsigned long long)errors);
+        TEST_FAIL("controller", msg);
+    }
+}
+
+void run_controller_tests(const struct fstest_config *cfg) {
+    printf("\n");
+    printf("========================================\n");
+    printf("  20. 多节点 controller (Distributed Controller)\n");
+    printf("========================================\n");
+
+    signal(SIGPIPE, SIG_IGN);
+    struct dist_node *nodes = calloc(DIST_MAX_NODES, sizeof(*nodes));
+    int n = parse_agent_list(cfg->agents, nodes, DIST_MAX_NODES);
+    if (n == 0) {
+        TEST_FAIL("controller", "no agents");
+        free(nodes);
+        return;
+    }
+    printf("  Agents:       %d (%s)\n", n, cfg->agents);
+    printf("  Workload:     %s | %d %s per node | IO %zu B | file %zu MB | "
+           "%d s\n",
+           test_type_key(cfg->dist_op), cfg->jobs, worker_kind(cfg->procs),
+           cfg->io_size, cfg->file_size / _1MB_BYTES, cfg->dist_time);
+
+    uint64_t hello[DIST_MSG_ARGS] = {0};
+    hello[DIST_H_VERSION] = DIST_VERSION;
+    hello[DIST_H_OP] = cfg->dist_op;
+    hello[DIST_H_JOBS] = cfg->jobs;
+    hello[DIST_H_IO_SIZE] = cfg->io_size;
+    hello[DIST_H_FILE_SIZE] = cfg->file_size;
+    hello[DIST_H_DURATION_NS] = (uint64_t)cfg->dist_time * NANOS_PER_SECOND;
+    hello[DIST_H_PROCS] = cfg->procs;
+
+    /* 先全部下发再逐个等待就绪，各节点的预填并行进行 */
+    int ok = 1;
+    for (int i = 0; i < n && ok; i++) {
+        nodes[i].fd = dist_connect(nodes[i].addr, cfg->dist_port);
+        hello[DIST_H_NODE] = i;
+        if (nodes[i].fd < 0) {
+            dist_node_fail(&nodes[i], "connect");
+            ok = 0;
+        } else if (dist_send_msg(nodes[i].fd, DIST_HELLO, hello) != 0) {
+            dist_node_fail(&nodes[i], "hello");
+            ok = 0;
+        }
+    }
+    if (ok) printf("  Preparing:    prefilling files on all agents...\n");
+    for (int i = 0; i < n && ok; i++) {
+        struct dist_msg msg;
+        if (dist_recv_msg(nodes[i].fd, &msg) != 0 || msg.type != DIST_READY) {
+            dist_node_fail(&nodes[i], "ready");
+            ok = 0;
+        } else if (msg.arg[0] != 0) {
+            errno = (int)msg.arg[0];
+            dist_node_fail(&nodes[i], "prepare");
+            ok = 0;
+        }
+    }
+    uint64_t max_rtt = 0;
+    for (int i = 0; i < n && ok; i++) {
+        if (dist_clock_sync(&nodes[i]) != 0) {
+            dist_node_fail(&nodes[i], "clock sync");
+            ok = 0;
+        } else if (nodes[i].rtt_ns > max_rtt) {
+            max_rtt = nodes[i].rtt_ns;
+        }
+    }
+
+    if (ok) {
+        uint64_t start = realtime_ns() + DIST_START_DELAY_NS + n * max_rtt;
+        uint64_t args[DIST_MSG_ARGS] = {0};
+        struct timeval tv = {cfg->dist_time + DIST_RESULT_SLACK_S, 0};
+        printf("  Running:      %d s from synchronized start...\n",
+               cfg->dist_time);
+        fflush(stdout);
+        for (int i = 0; i < n && ok; i++) {
+            args[0] = start + nodes[i].offset_ns;
+            setsockopt(nodes[i].fd, SOL_SOCKET, SO_RCVTIMEO, &tv,
+                       sizeof(tv));
+            if (dist_send_msg(nodes[i].fd, DIST_START, args) != 0) {
+                dist_node_fail(&nodes[i], "start");
+                ok = 0;
+            }
+        }
+    }
+    for (int i = 0; i < n && ok; i++) {
+        struct dist_msg msg;
+        if (dist_recv_msg(nodes[i].fd, &msg) != 0 ||
+            msg.type != DIST_RESULT ||
+            dist_recv_hist(nodes[i].fd, &nodes[i].hist) != 0) {
+            dist_node_fail(&nodes[i], "result");
+            ok = 0;
+        } else if (msg.arg[DIST_R_STATUS] != 0) {
+            errno = (int)msg.arg[DIST_R_STATUS];
+            dist_node_fail(&nodes[i], "run");
+            ok = 0;
+        } else {
+            memcpy(nodes[i].result, msg.arg, sizeof(nodes[i].result));
+        }
+    }
+    if (ok) print_controller_report(nodes, n);
+
+    for (int i = 0; i < n; i++) {
+        if (nodes[i].fd >= 0) close(nodes[i].fd);
+    }
+    free(nodes);
+    printf("--- 多节点 controller 完成 ---\n");
+}
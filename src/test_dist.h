@@ -0,0 +1,15 @@
+/*
+    多节点协同运行模块
+    agent 在各客户端上等待 controller 下发负载；controller 统一发令，
+    汇总逐节点结果和全体客户端的聚合带宽、尾延迟
+*/
+
+#ifndef FSTEST_TEST_DIST_H
+#define FSTEST_TEST_DIST_H
+
+#include "common.h"
+
+void run_agent_tests(const struct fstest_config *cfg);
+void run_controller_tests(const struct fstest_config *cfg);
+
+#endif /* FSTEST_TEST_DIST_H */
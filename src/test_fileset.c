@@ -0,0 +1,377 @@
+/*
+    小文件集合负载模块实现
+    每个线程从文件集合中随机挑选文件，open -> 整文件读或写 -> close
+    测试项目：
+    - 文件大小分布：fixed / uniform / lognormal / hist (直方图文件)
+    - 整文件写入吞吐 (files/s, MB/s)
+    - 整文件读取吞吐 (files/s, MB/s)
+    - open / 数据读写 / close 各自的平均开销
+*/
+
+#include "test_fileset.h"
+
+#include "timer.h"
+
+#include <math.h>
+#include <sys/stat.h>
+
+#define FILESET_FILES_PER_DIR 1000
+#define FILESET_MAX_HIST_BINS 256
+#define FILESET_MAX_IO (8 * _1MB_BYTES)
+#define FILESET_DEFAULT_LOGNORMAL_MAX _1GB_BYTES
+
+enum size_dist_kind { DIST_FIXED, DIST_UNIFORM, DIST_LOGNORMAL, DIST_HIST };
+
+struct size_dist {
+    enum size_dist_kind kind;
+    size_t a;     /* fixed: 大小; uniform: 下限; lognormal: 中位数 */
+    size_t b;     /* uniform: 上限; lognormal: 截断上限 */
+    double sigma; /* lognormal: ln 空间的标准差 */
+    int bins;
+    size_t bin_size[FILESET_MAX_HIST_BINS];
+    double bin_cdf[FILESET_MAX_HIST_BINS];
+};
+
+struct fileset {
+    char root[MAX_PATH_LEN];
+    int file_count;
+    size_t *sizes;
+    size_t total_bytes;
+    size_t max_size;
+};
+
+/* 单个线程的参数和统计 */
+struct fileset_job_args {
+    const struct fileset *fs;
+    int thread_id;
+    int ops;
+    int is_write;
+    char *buf;
+    size_t buf_size;
+    int files;
+    size_t bytes;
+    int errors;
+    int64_t open_ns;
+    int64_t io_ns;
+    int64_t close_ns;
+};
+
+static int load_hist_file(struct size_dist *dist, const char *path) {
+    FILE *fp = fopen(path, "r");
+    if (!fp) return -1;
+
+    char line[256];
+    double total = 0.0;
+    dist->bins = 0;
+    while (fgets(line, sizeof(line), fp)) {
+        char size_str[64];
+        double weight = 0.0;
+        if (line[0] == '#' || line[0] == '\n') continue;
+        if (sscanf(line, "%63s %lf", size_str, &weight) != 2) continue;
+        if (dist->bins >= FILESET_MAX_HIST_BINS || weight <= 0.0) continue;
+        size_t size;
+        if (parse_size(size_str, &size) != 0) continue;
+        dist->bin_size[dist->bins] = size;
+        total += weight;
+        dist->bin_cdf[dist->bins] = total;
+        dist->bins++;
+    }
+    fclose(fp);
+
+    if (dist->bins == 0) return -1;
+    for (int i = 0; i < dist->bins; i++) {
+        dist->bin_cdf[i] /= total;
+    }
+    return 0;
+}
+
+/* 解析 --size-dist 描述，格式见 print_usage */
+static int parse_size_dist(const char *spec, struct size_dist *dist) {
+    char buf[MAX_PATH_LEN];
+    strncpy(buf, spec, sizeof(buf) - 1);
+    buf[sizeof(buf) - 1] = '\0';
+
+    char *save = NULL;
+    char *kind = strtok_r(buf, ":", &save);
+    char *arg1 = strtok_r(NULL, ":", &save);
+    char *arg2 = strtok_r(NULL, ":", &save);
+    char *arg3 = strtok_r(NULL, ":", &save);
+    if (!kind || !arg1) return -1;
+
+    memset(dist, 0, sizeof(*dist));
+    if (strcasecmp(kind, "fixed") == 0) {
+        dist->kind = DIST_FIXED;
+        return parse_size(arg1, &dist->a);
+    }
+    if (strcasecmp(kind, "uniform") == 0) {
+        dist->kind = DIST_UNIFORM;
+        if (!arg2 || parse_size(arg1, &dist->a) != 0 ||
+            parse_size(arg2, &dist->b) != 0 || dist->b < dist->a) {
+            return -1;
+        }
+        return 0;
+    }
+    if (strcasecmp(kind, "lognormal") == 0) {
+        dist->kind = DIST_LOGNORMAL;
+        dist->b = FILESET_DEFAULT_LOGNORMAL_MAX;
+        if (!arg2 || parse_size(arg1, &dist->a) != 0 || dist->a == 0) {
+            return -1;
+        }
+        dist->sigma = strtod(arg2, NULL);
+        if (dist->sigma < 0.0) return -1;
+        if (arg3 && parse_size(arg3, &dist->b) != 0) return -1;
+        return 0;
+    }
+    if (strcasecmp(kind, "hist") == 0) {
+        dist->kind = DIST_HIST;
+        /* 直方图文件路径本身可能包含冒号，取第一个冒号之后的全部内容 */
+        return load_hist_file(dist, strchr(spec, ':') + 1);
+    }
+    return -1;
+}
+
+static size_t sample_size(const struct size_dist *dist, unsigned int *seed) {
+    switch (dist->kind) {
+        case DIST_FIXED:
+            return dist->a;
+        case DIST_UNIFORM: {
+            double u = rand_r(seed) / ((double)RAND_MAX + 1.0);
+            return dist->a + (size_t)(u * (double)(dist->b - dist->a + 1));
+        }
+        case DIST_LOGNORMAL: {
+            /* Box-Muller 生成标准正态分布 */
+            double u1 = (rand_r(seed) + 1.0) / ((double)RAND_MAX + 2.0);
+            double u2 = rand_r(seed) / ((double)RAND_MAX + 1.0);
+            double z = sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+            double v = (double)dist->a * exp(dist->sigma * z);
+            if (v < 1.0) v = 1.0;
+            if (v > (double)dist->b) v = (double)dist->b;
+            return (size_t)v;
+        }
+        case DIST_HIST: {
+            double u = rand_r(seed) / ((double)RAND_MAX + 1.0);
+            for (int i = 0; i < dist->bins; i++) {
+                if (u < dist->bin_cdf[i]) return dist->bin_size[i];
+            }
+            return dist->bin_size[dist->bins - 1];
+        }
+    }
+    return 0;
+}
+
+static void fileset_path(char *out, size_t out_size, const struct fileset *fs,
+                         int index) {
+    snprintf(out, out_size, "%s/d%04d/f%07d.dat", fs->root,
+             index / FILESET_FILES_PER_DIR, index);
+}
+
+/* 按大小写满一个文件，IO 按 buf_size 切分 */
+static ssize_t write_whole_file(int fd, const char *buf, size_t buf_size,
+                                size_t size) {
+    size_t done = 0;
+    while (done < size) {
+        size_t chunk = size - done < buf_size ? size - done : buf_size;
+        ssize_t w = write(fd, buf, chunk);
+        if (w <= 0) return -1;
+        done += w;
+    }
+    return (ssize_t)done;
+}
+
+static ssize_t read_whole_file(int fd, char *buf, size_t buf_size) {
+    size_t done = 0;
+    for (;;) {
+        ssize_t r = read(fd, buf, buf_size);
+        if (r < 0) return -1;
+        if (r == 0) break;
+        done += r;
+    }
+    return (ssize_t)done;
+}
+
+/* 创建文件集合 (不计时) */
+static int create_fileset(struct fileset *fs, const struct size_dist *dist,
+                          char *buf, size_t buf_size) {
+    char path[MAX_PATH_LEN];
+    unsigned int seed = 12345;
+
+    if (mkdir(fs->root, 0755) != 0 && errno != EEXIST) return -1;
+    for (int i = 0; i < fs->file_count; i++) {
+        if (i % FILESET_FILES_PER_DIR == 0) {
+            snprintf(path, sizeof(path), "%s/d%04d", fs->root,
+                     i / FILESET_FILES_PER_DIR);
+            if (mkdir(path, 0755) != 0 && errno != EEXIST) return -1;
+        }
+        fs->sizes[i] = sample_size(dist, &seed);
+        fs->total_bytes += fs->sizes[i];
+        if (fs->sizes[i] > fs->max_size) fs->max_size = fs->sizes[i];
+
+        fileset_path(path, sizeof(path), fs, i);
+        int fd = open(path, O_CREAT | O_WRONLY | O_TRUNC, 0644);
+        if (fd < 0) return -1;
+        ssize_t w = write_whole_file(fd, buf, buf_size, fs->sizes[i]);
+        close(fd);
+        if (w < 0) return -1;
+    }
+    return 0;
+}
+
+static void *fileset_job(void *arg) {
+    struct fileset_job_args *a = (struct fileset_job_args *)arg;
+    const struct fileset *fs = a->fs;
+    unsigned int seed = (unsigned int)(a->thread_id * 7919 + 17);
+    char path[MAX_PATH_LEN];
+    uint64_t t0, t1, t2, t3;
+
+    for (int i = 0; i < a->ops; i++) {
+        int index = rand_r(&seed) % fs->file_count;
+        fileset_path(path, sizeof(path), fs, index);
+
+        t0 = timer_now();
+        int fd = a->is_write ? open(path, O_WRONLY | O_TRUNC)
+                             : open(path, O_RDONLY);
+        t1 = timer_now();
+        if (fd < 0) {
+            a->errors++;
+            continue;
+        }
+
+        ssize_t n = a->is_write
+                        ? write_whole_file(fd, a->buf, a->buf_size,
+                                           fs->sizes[index])
+                        : read_whole_file(fd, a->buf, a->buf_size);
+        t2 = timer_now();
+        close(fd);
+        t3 = timer_now();
+
+        if (n < 0) {
+            a->errors++;
+            continue;
+        }
+        a->files++;
+        a->bytes += n;
+        a->open_ns += timer_diff_ns(t0, t1);
+        a->io_ns += timer_diff_ns(t1, t2);
+        a->close_ns += timer_diff_ns(t2, t3);
+    }
+    return NULL;
+}
+
+/* 运行一个阶段 (整文件读或写)，并打印结果 */
+static void run_fileset_phase(const struct fileset *fs, int nthreads, int ops,
+                              int is_write) {
+    pthread_t *threads = malloc(nthreads * sizeof(pthread_t));
+    struct fileset_job_args *args =
+        calloc(nthreads, sizeof(struct fileset_job_args));
+    size_t buf_size = fs->max_size < FILESET_MAX_IO ? fs->max_size
+                                                    : FILESET_MAX_IO;
+    if (buf_size == 0) buf_size = 1;
+
+    for (int i = 0; i < nthreads; i++) {
+        args[i].fs = fs;
+        args[i].thread_id = i;
+        args[i].ops = ops;
+        args[i].is_write = is_write;
+        args[i].buf_size = buf_size;
+        args[i].buf = malloc(buf_size);
+        fill_rand_buffer(args[i].buf, buf_size);
+    }
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < nthreads; i++) {
+        pthread_create(&threads[i], NULL, fileset_job, &args[i]);
+    }
+    for (int i = 0; i < nthreads; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    int files = 0, errors = 0;
+    size_t bytes = 0;
+    int64_t open_ns = 0, io_ns = 0, close_ns = 0;
+    for (int i = 0; i < nthreads; i++) {
+        files += args[i].files;
+        errors += args[i].errors;
+        bytes += args[i].bytes;
+        open_ns += args[i].open_ns;
+        io_ns += args[i].io_ns;
+        close_ns += args[i].close_ns;
+        free(args[i].buf);
+    }
+
+    double duration_s =
+        calculate_time_diff_ns(&start, &end) / (double)NANOS_PER_SECOND;
+    double per_file = files > 0 ? 1000.0 * files : 1.0;
+    printf("  %-18s | %2d jobs | %8.0f files/s | %8.2f MB/s | "
+           "open %7.1f us | %s %7.1f us | close %6.1f us | %.3f s\n",
+           is_write ? "Whole-file Write" : "Whole-file Read", nthreads,
+           files / duration_s, (bytes / (double)_1MB_BYTES) / duration_s,
+           open_ns / per_file, is_write ? "write" : "read ",
+           io_ns / per_file, close_ns / per_file, duration_s);
+    if (errors > 0) {
+        char msg[128];
+        snprintf(msg, sizeof(msg), "%d failed file operations", errors);
+        TEST_FAIL(is_write ? "fileset write" : "fileset read", msg);
+    }
+
+    free(args);
+    free(threads);
+}
+
+void run_fileset_tests(const struct fstest_config *cfg) {
+    printf("\n");
+    printf("========================================\n");
+    printf("  7. 小文件集合负载 (File-set Workload)\n");
+    printf("========================================\n");
+
+    struct size_dist dist;
+    if (parse_size_dist(cfg->size_dist, &dist) != 0) {
+        TEST_FAIL("fileset", "invalid --size-dist specification");
+        return;
+    }
+
+    int nthreads = cfg->jobs;
+    int ops = cfg->fileset_ops;
+    if (ops == 0) {
+        ops = (int)((long)cfg->fileset_files * cfg->iter_count / nthreads);
+        if (ops < 1) ops = 1;
+    }
+
+    struct fileset fs;
+    memset(&fs, 0, sizeof(fs));
+    make_test_path(fs.root, sizeof(fs.root), cfg->dir, "fileset");
+    fs.file_count = cfg->fileset_files;
+    fs.sizes = calloc(fs.file_count, sizeof(size_t));
+
+    printf("  Files:        %d\n", fs.file_count);
+    printf("  Size dist:    %s\n", cfg->size_dist);
+    printf("  Threads:      %d\n", nthreads);
+    printf("  Ops per job:  %d\n", ops);
+
+    char *buf = malloc(FILESET_MAX_IO);
+    fill_rand_buffer(buf, FILESET_MAX_IO);
+    printf("\n  Creating file set...\n");
+    if (create_fileset(&fs, &dist, buf, FILESET_MAX_IO) != 0) {
+        TEST_FAIL("fileset create", strerror(errno));
+        free(buf);
+        free(fs.sizes);
+        remove_dir_recursive(fs.root);
+        return;
+    }
+    free(buf);
+    printf("  Created %d files, %.2f MB total (avg %.1f KB, max %.1f KB)\n",
+           fs.file_count, fs.total_bytes / (double)_1MB_BYTES,
+           fs.total_bytes / (double)_1KB_BYTES / fs.file_count,
+           fs.max_size / (double)_1KB_BYTES);
+
+    printf("\n  --- 整文件读写 (Whole-file I/O) ---\n");
+    run_fileset_phase(&fs, nthreads, ops, 1);
+    run_fileset_phase(&fs, nthreads, ops, 0);
+
+    printf("\n  Cleaning up file set...\n");
+    remove_dir_recursive(fs.root);
+    free(fs.sizes);
+
+    printf("--- 小文件集合负载完成 ---\n");
+}
@@ -0,0 +1,13 @@
+/*
+    小文件集合负载模块
+    在大量文件组成的集合上做整文件读写，衡量小文件吞吐和 open/close 开销
+*/
+
+#ifndef FSTEST_TEST_FILESET_H
+#define FSTEST_TEST_FILESET_H
+
+#include "common.h"
+
+void run_fileset_tests(const struct fstest_config *cfg);
+
+#endif /* FSTEST_TEST_FILESET_H */
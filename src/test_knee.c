@@ -0,0 +1,274 @@
+/*
+    饱和点搜索模块实现
+    搜索变量 x 为 worker 数 (--knee-param jobs，队列深度固定为 1) 或每个
+    worker 的队列深度 (--knee-param qd，worker 数取 -j)。每个点运行
+    --knee-time 秒的 --knee-op 负载，一个点"合格"当且仅当：
+    - 相对上一个合格点 lo，吞吐按每倍增折算的增益不低于 --knee-gain %
+      (gain = (tput(x) / tput(lo)) ^ (1 / log2(x / lo)) - 1)
+    - 设置了 --knee-p99 时，p99 延迟不超过该上限
+    倍增阶段从 1 开始每次翻倍，直到出现不合格点或到达 --knee-max；
+    二分阶段在最后合格点和第一个不合格点之间收缩到相邻整数。
+    最后合格点即最佳工作点
+*/
+
+#include "test_knee.h"
+
+#include "timed_io.h"
+#include "worker.h"
+
+#include <math.h>
+
+struct knee_point {
+    int measured;
+    double mbs;
+    double iops;
+    double avg_us;
+    double p99_us;
+    long errors;
+};
+
+struct knee_state {
+    const struct fstest_config *cfg;
+    struct timed_io_args *args;
+    struct knee_point *pts;    /* 按 x 下标 */
+    char dir[MAX_PATH_LEN];
+    size_t file_size;
+    int max_x;
+    int max_jobs;
+    int prefilled;             /* 已预填的文件数 */
+};
+
+static const char *knee_param_name(const struct fstest_config *cfg) {
+    return cfg->knee_qd ? "qd" : "jobs";
+}
+
+/* 文件随 worker 数增长按需预填，二分阶段只会用到已预填的文件 */
+static int knee_prefill(struct knee_state *st, int jobs) {
+    for (int i = st->prefilled; i < jobs; i++) {
+        snprintf(st->args[i].path, sizeof(st->args[i].path), "%s/f%02d",
+                 st->dir, i);
+        if (timed_io_prefill(st->args[i].path, st->file_size) != 0) {
+            return -1;
+        }
+        st->prefilled = i + 1;
+    }
+    return 0;
+}
+
+static int knee_measure(struct knee_state *st, int x) {
+    const struct fstest_config *cfg = st->cfg;
+    struct knee_point *p = &st->pts[x];
+    if (p->measured) return 0;
+
+    int jobs = cfg->knee_qd ? st->max_jobs : x;
+    int qd = cfg->knee_qd ? x : 1;
+    if (knee_prefill(st, jobs) != 0) {
+        TEST_FAIL("knee prefill", strerror(errno));
+        return -1;
+    }
+    for (int i = 0; i < jobs; i++) {
+        st->args[i].type = (enum test_type)cfg->knee_op;
+        st->args[i].io_size = cfg->io_size;
+        st->args[i].file_size = st->file_size;
+        st->args[i].start_ns = 0;
+        st->args[i].duration_ns = (uint64_t)cfg->knee_time * NANOS_PER_SECOND;
+        st->args[i].seed = (unsigned int)(i + 1);
+        st->args[i].qd = qd;
+        st->args[i].direct = 0;
+        st->args[i].mem_align = 0;
+        st->args[i].next_block = 0;
+    }
+    int64_t ns = run_workers(jobs, cfg->procs, timed_io_job, st->args,
+                             sizeof(struct timed_io_args));
+    if (ns <= 0) {
+        TEST_FAIL("knee", worker_strerror(ns));
+        return -1;
+    }
+
+    struct lat_hist hist;
+    uint64_t bytes = 0, ops = 0;
+    lat_hist_init(&hist);
+    p->errors = 0;
+    for (int i = 0; i < jobs; i++) {
+        bytes += st->args[i].bytes;
+        ops += st->args[i].ops;
+        p->errors += st->args[i].errors;
+        lat_hist_merge(&hist, &st->args[i].hist);
+    }
+    double secs = ns / (double)NANOS_PER_SECOND;
+    p->mbs = bytes / (double)_1MB_BYTES / secs;
+    p->iops = ops / secs;
+    p->avg_us = hist.count ? hist.sum_ns / 1000.0 / hist.count : 0.0;
+    p->p99_us = lat_hist_percentile(&hist, 99.0) / 1000.0;
+    p->measured = 1;
+    return 0;
+}
+
+/* 相对 lo 的吞吐增益，按每倍增折算 (%) */
+static double knee_gain(const struct knee_point *pts, int lo, int x) {
+    if (pts[lo].mbs <= 0.0) return pts[x].mbs > 0.0 ? 100.0 : 0.0;
+    double doublings = log2((double)x / lo);
+    return (pow(pts[x].mbs / pts[lo].mbs, 1.0 / doublings) - 1.0) * 100.0;
+}
+
+/* 返回 1 表示合格；reason 记录不合格原因 */
+static int knee_ok(const struct knee_state *st, int lo, int x,
+                   char *reason, size_t reason_size) {
+    const struct fstest_config *cfg = st->cfg;
+    const struct knee_point *p = &st->pts[x];
+    if (cfg->knee_p99 > 0 && p->p99_us > cfg->knee_p99) {
+        snprintf(reason, reason_size, "p99 %.1f us > %d us", p->p99_us,
+                 cfg->knee_p99);
+        return 0;
+    }
+    if (lo > 0) {
+        double gain = knee_gain(st->pts, lo, x);
+        if (gain < cfg->knee_gain) {
+            snprintf(reason, reason_size,
+                     "gain %.1f%%/doubling < %d%% vs %s=%d", gain,
+                     cfg->knee_gain, knee_param_name(cfg), lo);
+            return 0;
+        }
+    }
+    reason[0] = '\0';
+    return 1;
+}
+
+static void print_point(const char *phase, int x, const struct knee_point *p,
+                        const char *gain, const char *verdict) {
+    printf("  %-7s | %5d | %9.2f | %9.0f | %9.1f | %9.1f | %8s | %s\n", phase,
+           x, p->mbs, p->iops, p->avg_us, p->p99_us, gain, verdict);
+    fflush(stdout);
+}
+
+void run_knee_tests(const struct fstest_config *cfg) {
+    printf("\n");
+    printf("========================================\n");
+    printf("  23. 饱和点搜索 (Saturation Knee Search)\n");
+    printf("========================================\n");
+
+    struct knee_state st = {0};
+    st.cfg = cfg;
+    st.max_x = cfg->knee_max;
+    if (st.max_x <= 0) st.max_x = cfg->knee_qd ? MAX_SWEEP_QD : MAX_JOBS;
+    if (!cfg->knee_qd && st.max_x > MAX_JOBS) st.max_x = MAX_JOBS;
+    if (cfg->knee_qd && st.max_x > MAX_SWEEP_QD) st.max_x = MAX_SWEEP_QD;
+    st.max_jobs = cfg->knee_qd ? cfg->jobs : st.max_x;
+    st.file_size = cfg->file_size < cfg->io_size ? cfg->io_size
+                                                  : cfg->file_size;
+
+    printf("  Search:       %s in 1-%d (%s) | %s | IO %zu B | %d s per "
+           "point\n",
+           knee_param_name(cfg), st.max_x,
+           cfg->knee_qd ? "fixed -j workers" : "qd 1",
+           test_type_key(cfg->knee_op), cfg->io_size, cfg->knee_time);
+    if (cfg->knee_qd) {
+        printf("  Workers:      %d %s\n", cfg->jobs, worker_kind(cfg->procs));
+    }
+    if (cfg->knee_p99 > 0) {
+        printf("  Criteria:     gain < %d%% per doubling or p99 > %d us\n",
+               cfg->knee_gain, cfg->knee_p99);
+    } else {
+        printf("  Criteria:     gain < %d%% per doubling\n", cfg->knee_gain);
+    }
+
+    make_test_path(st.dir, sizeof(st.dir), cfg->dir, "knee");
+    if (mkdir(st.dir, 0755) != 0 && errno != EEXIST) {
+        TEST_FAIL("knee", strerror(errno));
+        return;
+    }
+    st.args = worker_args_alloc(st.max_jobs, sizeof(struct timed_io_args),
+                                cfg->procs);
+    st.pts = calloc(st.max_x + 1, sizeof(struct knee_point));
+    if (!st.args || !st.pts) {
+        TEST_FAIL("knee", strerror(ENOMEM));
+        goto out;
+    }
+
+    printf("\n  %-7s | %5s | %9s | %9s | %9s | %9s | %8s | %s\n", "phase",
+           knee_param_name(cfg), "MB/s", "IOPS", "avg us", "p99 us",
+           "gain %", "verdict");
+
+    /* 倍增阶段：lo 为最后合格点，hi 为第一个不合格点 (0 = 未出现) */
+    int lo = 0, hi = 0;
+    char reason[96] = "";
+    char gain_col[16];
+    for (int x = 1;; x = x * 2 < st.max_x ? x * 2 : st.max_x) {
+        if (knee_measure(&st, x) != 0) goto out;
+        snprintf(gain_col, sizeof(gain_col), "-");
+        if (lo > 0) {
+            snprintf(gain_col, sizeof(gain_col), "%.1f",
+                     knee_gain(st.pts, lo, x));
+        }
+        int ok = knee_ok(&st, lo, x, reason, sizeof(reason));
+        print_point("double", x, &st.pts[x], gain_col, ok ? "ok" : reason);
+        if (!ok) {
+            hi = x;
+            break;
+        }
+        lo = x;
+        if (x == st.max_x) break;
+    }
+
+    /* 二分阶段 */
+    char knee_reason[96] = "";
+    if (hi > 0) snprintf(knee_reason, sizeof(knee_reason), "%s", reason);
+    while (lo > 0 && hi - lo > 1) {
+        int mid = lo + (hi - lo) / 2;
+        if (knee_measure(&st, mid) != 0) goto out;
+        snprintf(gain_col, sizeof(gain_col), "%.1f",
+                 knee_gain(st.pts, lo, mid));
+        int ok = knee_ok(&st, lo, mid, reason, sizeof(reason));
+        print_point("bisect", mid, &st.pts[mid], gain_col,
+                    ok ? "ok" : reason);
+        if (ok) {
+            lo = mid;
+        } else {
+            hi = mid;
+            snprintf(knee_reason, sizeof(knee_reason), "%s", reason);
+        }
+    }
+
+    printf("\n  --- 扩展曲线 (Scaling Curve) ---\n");
+    printf("  %5s | %9s | %9s | %9s | %9s |\n", knee_param_name(cfg),
+           "MB/s", "IOPS", "avg us", "p99 us");
+    long errors = 0;
+    for (int x = 1; x <= st.max_x; x++) {
+        const struct knee_point *p = &st.pts[x];
+        if (!p->measured) continue;
+        errors += p->errors;
+        printf("  %5d | %9.2f | %9.0f | %9.1f | %9.1f |%s\n", x, p->mbs,
+               p->iops, p->avg_us, p->p99_us,
+               x == lo ? " <- optimal" : x == hi ? " <- knee" : "");
+    }
+
+    printf("\n");
+    if (lo == 0) {
+        printf("  Result:       criteria violated at %s=1 (%s)\n",
+               knee_param_name(cfg), knee_reason);
+        TEST_FAIL("knee", "no operating point meets the criteria");
+    } else {
+        const struct knee_point *p = &st.pts[lo];
+        printf("  Optimal:      %s=%d | %.2f MB/s | %.0f IOPS | p99 %.1f us\n",
+               knee_param_name(cfg), lo, p->mbs, p->iops, p->p99_us);
+        if (hi > 0) {
+            printf("  Knee:         %s=%d (%s)\n", knee_param_name(cfg), hi,
+                   knee_reason);
+        } else {
+            printf("  Knee:         not reached up to %s=%d\n",
+                   knee_param_name(cfg), st.max_x);
+        }
+    }
+    if (errors > 0) {
+        char msg[64];
+        snprintf(msg, sizeof(msg), "%ld failed IOs", errors);
+        TEST_FAIL("knee", msg);
+    }
+
+out:
+    free(st.pts);
+    worker_args_free(st.args, st.max_jobs, sizeof(struct timed_io_args),
+                     cfg->procs);
+    remove_dir_recursive(st.dir);
+    printf("--- 饱和点搜索完成 ---\n");
+}
@@ -0,0 +1,14 @@
+/*
+    饱和点搜索模块
+    自适应地调整 worker 数或队列深度 (先倍增再二分)，找到吞吐不再扩展或
+    p99 延迟超限的拐点，报告最佳工作点和拐点附近的扩展曲线
+*/
+
+#ifndef FSTEST_TEST_KNEE_H
+#define FSTEST_TEST_KNEE_H
+
+#include "common.h"
+
+void run_knee_tests(const struct fstest_config *cfg);
+
+#endif /* FSTEST_TEST_KNEE_H */
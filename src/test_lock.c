@@ -0,0 +1,275 @@
+/*
+    文件锁性能基准模块实现
+    锁类型：flock / POSIX fcntl 记录锁 / OFD (open file description) 记录锁
+    竞争者：-j 个线程，或 -j 个进程；每个竞争者单独打开文件
+    场景：
+    - uncontended: 单个竞争者反复加锁解锁
+    - disjoint:    N 个竞争者各锁不同的字节范围 (flock 为各自不同的文件)
+    - overlapping: N 个竞争者争同一个字节范围 (flock 为同一个文件)
+    报告每秒加锁/解锁次数和加锁等待时间分位数；overlapping 场景在锁内对
+    共享计数器做非原子自增，最后检查互斥是否成立
+    注意：POSIX 记录锁属于进程，同一进程的线程之间不互斥，线程竞争者跳过该类型
+*/
+
+#include "test_lock.h"
+
+#include "timer.h"
+
+#include <signal.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+
+#define LOCK_RANGE_LEN 4096
+
+enum lock_kind { LOCK_KIND_FLOCK, LOCK_KIND_POSIX, LOCK_KIND_OFD };
+enum lock_case { LOCK_UNCONTENDED, LOCK_DISJOINT, LOCK_OVERLAP };
+
+struct lock_result {
+    struct lat_hist wait;
+    uint64_t ops;
+    int errors;
+    struct timespec start;     /* 竞争者自己记录的起止时间 */
+    struct timespec end;
+};
+
+/* 放在共享匿名映射中，线程和进程竞争者都可以使用 */
+struct lock_shared {
+    pthread_barrier_t barrier;
+    volatile uint64_t counter;
+    struct lock_result results[MAX_JOBS];
+};
+
+struct lock_params {
+    const char *dir;
+    enum lock_kind kind;
+    enum lock_case lcase;
+    int ops;
+    struct lock_shared *shared;
+};
+
+struct lock_thread_args {
+    const struct lock_params *params;
+    int id;
+};
+
+static const char *lock_kind_name(enum lock_kind kind) {
+    switch (kind) {
+        case LOCK_KIND_FLOCK: return "flock";
+        case LOCK_KIND_POSIX: return "POSIX fcntl";
+        case LOCK_KIND_OFD: return "OFD fcntl";
+        default: return "unknown";
+    }
+}
+
+static const char *lock_case_name(enum lock_case lcase) {
+    switch (lcase) {
+        case LOCK_UNCONTENDED: return "uncontended";
+        case LOCK_DISJOINT: return "disjoint";
+        case LOCK_OVERLAP: return "overlapping";
+        default: return "unknown";
+    }
+}
+
+static int lock_range(int fd, enum lock_kind kind, off_t start, short type) {
+    if (kind == LOCK_KIND_FLOCK) {
+        return flock(fd, type == F_UNLCK ? LOCK_UN : LOCK_EX);
+    }
+    struct flock fl;
+    memset(&fl, 0, sizeof(fl));
+    fl.l_type = type;
+    fl.l_whence = SEEK_SET;
+    fl.l_start = start;
+    fl.l_len = LOCK_RANGE_LEN;
+    return fcntl(fd, kind == LOCK_KIND_OFD ? F_OFD_SETLKW : F_SETLKW, &fl);
+}
+
+static void lock_contender(const struct lock_params *p, int id) {
+    struct lock_result *r = &p->shared->results[id];
+    char path[MAX_PATH_LEN];
+    uint64_t t0, t1;
+
+    lat_hist_init(&r->wait);
+    /* flock 的 disjoint 场景没有字节范围，改为每个竞争者各用一个文件 */
+    if (p->kind == LOCK_KIND_FLOCK && p->lcase == LOCK_DISJOINT) {
+        snprintf(path, sizeof(path), "%s/lock_bench_%d.dat", p->dir, id);
+    } else {
+        snprintf(path, sizeof(path), "%s/lock_bench.dat", p->dir);
+    }
+    int fd = open(path, O_RDWR | O_CREAT, 0644);
+    off_t start = p->lcase == LOCK_DISJOINT ? (off_t)id * LOCK_RANGE_LEN : 0;
+
+    pthread_barrier_wait(&p->shared->barrier);
+    clock_gettime(CLOCK_MONOTONIC, &r->start);
+    r->end = r->start;
+    if (fd < 0) {
+        r->errors++;
+        return;
+    }
+    for (int i = 0; i < p->ops; i++) {
+        t0 = timer_now();
+        if (lock_range(fd, p->kind, start, F_WRLCK) != 0) {
+            r->errors++;
+            continue;
+        }
+        t1 = timer_now();
+        lat_hist_add(&r->wait, timer_diff_ns(t0, t1));
+        if (p->lcase == LOCK_OVERLAP) {
+            p->shared->counter = p->shared->counter + 1;
+        }
+        if (lock_range(fd, p->kind, start, F_UNLCK) != 0) r->errors++;
+        r->ops++;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &r->end);
+    close(fd);
+}
+
+static void *lock_thread(void *arg) {
+    struct lock_thread_args *a = (struct lock_thread_args *)arg;
+    lock_contender(a->params, a->id);
+    return NULL;
+}
+
+static void run_lock_case(const struct fstest_config *cfg, const char *dir,
+                          enum lock_kind kind, int use_procs,
+                          enum lock_case lcase) {
+    int n = lcase == LOCK_UNCONTENDED ? 1 : cfg->jobs;
+    const char *who = use_procs ? "processes" : "threads";
+
+    if (kind == LOCK_KIND_POSIX && !use_procs && n > 1) {
+        char msg[96];
+        snprintf(msg, sizeof(msg), "%s / threads / %s: locks are per-process",
+                 lock_kind_name(kind), lock_case_name(lcase));
+        TEST_SKIP("lock bench", msg);
+        return;
+    }
+
+    struct lock_shared *shared =
+        mmap(NULL, sizeof(*shared), PROT_READ | PROT_WRITE,
+             MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (shared == MAP_FAILED) {
+        TEST_FAIL("lock bench", strerror(errno));
+        return;
+    }
+    memset(shared, 0, sizeof(*shared));
+    pthread_barrierattr_t attr;
+    pthread_barrierattr_init(&attr);
+    pthread_barrierattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+    pthread_barrier_init(&shared->barrier, &attr, n + 1);
+    pthread_barrierattr_destroy(&attr);
+
+    struct lock_params params = {dir, kind, lcase, cfg->lock_ops, shared};
+    pthread_t threads[MAX_JOBS];
+    struct lock_thread_args targs[MAX_JOBS];
+    pid_t pids[MAX_JOBS];
+    int started = 0;
+
+    for (int i = 0; i < n; i++) {
+        if (use_procs) {
+            pids[i] = fork();
+            if (pids[i] == 0) {
+                lock_contender(&params, i);
+                _exit(0);
+            }
+            if (pids[i] < 0) break;
+        } else {
+            targs[i].params = &params;
+            targs[i].id = i;
+            pthread_create(&threads[i], NULL, lock_thread, &targs[i]);
+        }
+        started++;
+    }
+
+    if (started == n) {
+        pthread_barrier_wait(&shared->barrier);
+    } else {
+        /* fork 失败时已启动的子进程永远等不齐屏障，直接结束它们 */
+        for (int i = 0; i < started; i++) kill(pids[i], SIGKILL);
+    }
+    for (int i = 0; i < started; i++) {
+        if (use_procs) {
+            waitpid(pids[i], NULL, 0);
+        } else {
+            pthread_join(threads[i], NULL);
+        }
+    }
+
+    /* 以最早开始到最晚结束作为测量区间，父进程的调度延迟不计入 */
+    struct lat_hist wait;
+    struct timespec start = shared->results[0].start;
+    struct timespec end = shared->results[0].end;
+    uint64_t ops = 0;
+    int errors = started == n ? 0 : n - started;
+    lat_hist_init(&wait);
+    for (int i = 0; i < started; i++) {
+        lat_hist_merge(&wait, &shared->results[i].wait);
+        ops += shared->results[i].ops;
+        errors += shared->results[i].errors;
+        if (calculate_time_diff_ns(&start, &shared->results[i].start) < 0) {
+            start = shared->results[i].start;
+        }
+        if (calculate_time_diff_ns(&end, &shared->results[i].end) > 0) {
+            end = shared->results[i].end;
+        }
+    }
+
+    double duration_s =
+        calculate_time_diff_ns(&start, &end) / (double)NANOS_PER_SECOND;
+    char lat[160];
+    lat_hist_format(&wait, lat, sizeof(lat));
+    printf("  %-11s | %-9s | %-11s | %2d | %9.0f lock/s | wait %s\n",
+           lock_kind_name(kind), who, lock_case_name(lcase), n,
+           duration_s > 0.0 ? ops / duration_s : 0.0, lat);
+
+    char label[96];
+    snprintf(label, sizeof(label), "%s / %s / %s", lock_kind_name(kind), who,
+             lock_case_name(lcase));
+    if (errors > 0) {
+        char msg[128];
+        snprintf(msg, sizeof(msg), "%d lock errors", errors);
+        TEST_FAIL(label, msg);
+    }
+    if (lcase == LOCK_OVERLAP && shared->counter != ops) {
+        char msg[128];
+        snprintf(msg, sizeof(msg),
+                 "mutual exclusion broken: counter %llu, expected %llu",
+                 (unsigned long long)shared->counter,
+                 (unsigned long long)ops);
+        TEST_FAIL(label, msg);
+    }
+
+    pthread_barrier_destroy(&shared->barrier);
+    munmap(shared, sizeof(*shared));
+}
+
+void run_lock_tests(const struct fstest_config *cfg) {
+    printf("\n");
+    printf("========================================\n");
+    printf("  16. 文件锁性能 (File Lock Benchmark)\n");
+    printf("========================================\n");
+    printf("  Contenders:   %d\n", cfg->jobs);
+    printf("  Lock ops:     %d per contender\n", cfg->lock_ops);
+
+    char dir[MAX_PATH_LEN];
+    make_test_path(dir, sizeof(dir), cfg->dir, "lock_bench");
+    if (mkdir(dir, 0755) != 0 && errno != EEXIST) {
+        TEST_FAIL("lock bench", strerror(errno));
+        return;
+    }
+
+    printf("\n  %-11s | %-9s | %-11s | %2s | %16s |\n", "lock", "contender",
+           "ranges", "n", "throughput");
+    for (int kind = LOCK_KIND_FLOCK; kind <= LOCK_KIND_OFD; kind++) {
+        for (int use_procs = 0; use_procs <= 1; use_procs++) {
+            for (int lcase = LOCK_UNCONTENDED; lcase <= LOCK_OVERLAP;
+                 lcase++) {
+                if (lcase == LOCK_UNCONTENDED && use_procs) continue;
+                run_lock_case(cfg, dir, (enum lock_kind)kind, use_procs,
+                              (enum lock_case)lcase);
+            }
+        }
+    }
+
+    remove_dir_recursive(dir);
+    printf("--- 文件锁性能测试完成 ---\n");
+}
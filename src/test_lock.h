@@ -0,0 +1,13 @@
+/*
+    文件锁性能基准模块
+    衡量 flock / POSIX 记录锁 / OFD 锁在有无竞争时的吞吐和等待时间
+*/
+
+#ifndef FSTEST_TEST_LOCK_H
+#define FSTEST_TEST_LOCK_H
+
+#include "common.h"
+
+void run_lock_tests(const struct fstest_config *cfg);
+
+#endif /* FSTEST_TEST_LOCK_H */
@@ -0,0 +1,273 @@
+/*
+    并行元数据基准模块实现
+    目录树由 --md-fanout 和 --md-depth 决定，树中每个目录放 --md-items 个条目
+    目录布局：
+    - unique: 每个线程有自己独立的目录树
+    - shared: 所有线程在同一棵目录树中操作，暴露父目录锁竞争
+    测试阶段 (每阶段之间全部线程同步)：
+    - mkdir / create / stat / open (已存在文件) / 跨目录 rename / unlink / rmdir
+    每个阶段报告 ops/s 和延迟分位数
+*/
+
+#include "test_mdtest.h"
+#include "timer.h"
+#include "worker.h"
+
+#include <sys/stat.h>
+
+#define MD_MAX_TREE_DIRS 100000
+
+enum md_phase {
+    MD_MKDIR,
+    MD_CREATE,
+    MD_STAT,
+    MD_OPEN,
+    MD_RENAME,
+    MD_UNLINK,
+    MD_RMDIR,
+    MD_PHASE_COUNT,
+};
+
+static const char *md_phase_name(enum md_phase phase) {
+    switch (phase) {
+        case MD_MKDIR: return "mkdir";
+        case MD_CREATE: return "create";
+        case MD_STAT: return "stat";
+        case MD_OPEN: return "open";
+        case MD_RENAME: return "rename (x-dir)";
+        case MD_UNLINK: return "unlink";
+        case MD_RMDIR: return "rmdir";
+        default: return "unknown";
+    }
+}
+
+/* 目录树：tree_dirs[i] 为相对于树根的路径，tree_dirs[0] 为树根本身 */
+struct md_tree {
+    char **dirs;
+    int count;
+};
+
+struct md_job_args {
+    const struct md_tree *tree;
+    char base[MAX_PATH_LEN]; /* 本线程使用的树根 */
+    int thread_id;
+    int items;
+    enum md_phase phase;
+    int errors;
+    struct lat_hist hist;
+};
+
+static int build_tree(struct md_tree *tree, int fanout, int depth) {
+    long total = 1, level = 1;
+    for (int d = 0; d < depth; d++) {
+        level *= fanout;
+        total += level;
+        if (total > MD_MAX_TREE_DIRS) return -1;
+    }
+
+    tree->dirs = calloc(total, sizeof(char *));
+    tree->count = 1;
+    tree->dirs[0] = strdup("");
+
+    /* 按层展开 (BFS)，保证父目录排在子目录之前 */
+    int level_start = 0, level_end = 1;
+    for (int d = 0; d < depth; d++) {
+        for (int p = level_start; p < level_end; p++) {
+            for (int c = 0; c < fanout; c++) {
+                char rel[MAX_PATH_LEN];
+                snprintf(rel, sizeof(rel), "%s%sn%d", tree->dirs[p],
+                         tree->dirs[p][0] ? "/" : "", c);
+                tree->dirs[tree->count++] = strdup(rel);
+            }
+        }
+        level_start = level_end;
+        level_end = tree->count;
+    }
+    return 0;
+}
+
+static void free_tree(struct md_tree *tree) {
+    for (int i = 0; i < tree->count; i++) {
+        free(tree->dirs[i]);
+    }
+    free(tree->dirs);
+}
+
+static int create_tree_dirs(const struct md_tree *tree, const char *base) {
+    if (mkdir(base, 0755) != 0 && errno != EEXIST) return -1;
+    for (int i = 1; i < tree->count; i++) {
+        char p[MAX_PATH_LEN];
+        snprintf(p, sizeof(p), "%s/%s", base, tree->dirs[i]);
+        if (mkdir(p, 0755) != 0 && errno != EEXIST) return -1;
+    }
+    return 0;
+}
+
+static void item_path(char *out, size_t out_size, const struct md_job_args *a,
+                      int dir, const char *kind, int item, int renamed) {
+    const char *rel = a->tree->dirs[dir];
+    snprintf(out, out_size, "%s%s%s/%s.%d.%d%s", a->base, rel[0] ? "/" : "",
+             rel, kind, a->thread_id, item, renamed ? ".r" : "");
+}
+
+static int md_do_op(const struct md_job_args *a, int dir, int item) {
+    char p1[MAX_PATH_LEN], p2[MAX_PATH_LEN];
+    struct stat st;
+    int fd;
+
+    switch (a->phase) {
+        case MD_MKDIR:
+            item_path(p1, sizeof(p1), a, dir, "dir", item, 0);
+            return mkdir(p1, 0755);
+        case MD_CREATE:
+            item_path(p1, sizeof(p1), a, dir, "file", item, 0);
+            fd = open(p1, O_CREAT | O_EXCL | O_WRONLY, 0644);
+            if (fd < 0) return -1;
+            return close(fd);
+        case MD_STAT:
+            item_path(p1, sizeof(p1), a, dir, "file", item, 0);
+            return stat(p1, &st);
+        case MD_OPEN:
+            item_path(p1, sizeof(p1), a, dir, "file", item, 0);
+            fd = open(p1, O_RDONLY);
+            if (fd < 0) return -1;
+            return close(fd);
+        case MD_RENAME:
+            /* 移动到树中的下一个目录，跨越父目录 */
+            item_path(p1, sizeof(p1), a, dir, "file", item, 0);
+            item_path(p2, sizeof(p2), a, (dir + 1) % a->tree->count, "file",
+                      item, 1);
+            return rename(p1, p2);
+        case MD_UNLINK:
+            item_path(p1, sizeof(p1), a, (dir + 1) % a->tree->count, "file",
+                      item, 1);
+            return unlink(p1);
+        case MD_RMDIR:
+            item_path(p1, sizeof(p1), a, dir, "dir", item, 0);
+            return rmdir(p1);
+        default:
+            return -1;
+    }
+}
+
+static void *md_job(void *arg) {
+    struct md_job_args *a = (struct md_job_args *)arg;
+    uint64_t t0, t1;
+
+    lat_hist_init(&a->hist);
+    a->errors = 0;
+    for (int d = 0; d < a->tree->count; d++) {
+        for (int i = 0; i < a->items; i++) {
+            t0 = timer_now();
+            int ret = md_do_op(a, d, i);
+            t1 = timer_now();
+            if (ret != 0) {
+                a->errors++;
+                continue;
+            }
+            lat_hist_add(&a->hist, timer_diff_ns(t0, t1));
+        }
+    }
+    return NULL;
+}
+
+static void run_md_phase(struct md_job_args *args, int nthreads,
+                         int use_procs, enum md_phase phase) {
+    struct lat_hist total;
+    int errors = 0;
+
+    lat_hist_init(&total);
+    for (int i = 0; i < nthreads; i++) {
+        args[i].phase = phase;
+    }
+    int64_t elapsed_ns = run_workers(nthreads, use_procs, md_job, args,
+                                     sizeof(struct md_job_args));
+    if (elapsed_ns < 0) {
+        TEST_FAIL(md_phase_name(phase), worker_strerror(elapsed_ns));
+        return;
+    }
+
+    for (int i = 0; i < nthreads; i++) {
+        lat_hist_merge(&total, &args[i].hist);
+        errors += args[i].errors;
+    }
+
+    double duration_s = elapsed_ns / (double)NANOS_PER_SECOND;
+    char lat[160];
+    lat_hist_format(&total, lat, sizeof(lat));
+    printf("  %-14s | %2d jobs | %9.0f ops/s | %s\n", md_phase_name(phase),
+           nthreads, duration_s > 0.0 ? total.count / duration_s : 0.0, lat);
+    if (errors > 0) {
+        char msg[128];
+        snprintf(msg, sizeof(msg), "%d failed operations", errors);
+        TEST_FAIL(md_phase_name(phase), msg);
+    }
+}
+
+void run_mdtest_tests(const struct fstest_config *cfg) {
+    printf("\n");
+    printf("========================================\n");
+    printf("  8. 并行元数据基准 (Metadata Benchmark)\n");
+    printf("========================================\n");
+
+    int nthreads = cfg->jobs;
+    struct md_tree tree;
+    if (build_tree(&tree, cfg->md_fanout, cfg->md_depth) != 0) {
+        TEST_FAIL("mdtest", "directory tree too large");
+        return;
+    }
+
+    printf("  Layout:       %s\n",
+           cfg->md_shared_dir ? "shared directory" : "unique per thread");
+    printf("  Tree:         fan-out %d, depth %d (%d dirs)\n", cfg->md_fanout,
+           cfg->md_depth, tree.count);
+    printf("  Items:        %d per dir per thread\n", cfg->md_items);
+    printf("  Threads:      %d (%s)\n", nthreads, worker_kind(cfg->procs));
+
+    char root[MAX_PATH_LEN];
+    make_test_path(root, sizeof(root), cfg->dir, "mdtest");
+    if (mkdir(root, 0755) != 0 && errno != EEXIST) {
+        TEST_FAIL("mdtest", strerror(errno));
+        free_tree(&tree);
+        return;
+    }
+
+    struct md_job_args *args =
+        worker_args_alloc(nthreads, sizeof(struct md_job_args), cfg->procs);
+    if (!args) {
+        TEST_FAIL("mdtest", strerror(ENOMEM));
+        free_tree(&tree);
+        return;
+    }
+
+    /* 目录树骨架不计时 */
+    int setup_ok = 1;
+    for (int i = 0; i < nthreads; i++) {
+        args[i].tree = &tree;
+        args[i].thread_id = i;
+        args[i].items = cfg->md_items;
+        if (cfg->md_shared_dir) {
+            snprintf(args[i].base, sizeof(args[i].base), "%s/shared", root);
+        } else {
+            snprintf(args[i].base, sizeof(args[i].base), "%s/t%02d", root, i);
+        }
+        if ((i == 0 || !cfg->md_shared_dir) &&
+            create_tree_dirs(&tree, args[i].base) != 0) {
+            setup_ok = 0;
+        }
+    }
+    if (!setup_ok) {
+        TEST_FAIL("mdtest tree setup", strerror(errno));
+    } else {
+        printf("\n  --- 元数据阶段 (Phases) ---\n");
+        for (int p = 0; p < MD_PHASE_COUNT; p++) {
+            run_md_phase(args, nthreads, cfg->procs, (enum md_phase)p);
+        }
+    }
+
+    remove_dir_recursive(root);
+    worker_args_free(args, nthreads, sizeof(struct md_job_args), cfg->procs);
+    free_tree(&tree);
+
+    printf("--- 并行元数据基准完成 ---\n");
+}
@@ -0,0 +1,13 @@
+/*
+    并行元数据基准模块
+    类似 mdtest，多线程在目录树中执行 mkdir/create/stat/open/rename/unlink/rmdir
+*/
+
+#ifndef FSTEST_TEST_MDTEST_H
+#define FSTEST_TEST_MDTEST_H
+
+#include "common.h"
+
+void run_mdtest_tests(const struct fstest_config *cfg);
+
+#endif /* FSTEST_TEST_MDTEST_H */
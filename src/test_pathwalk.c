@@ -0,0 +1,321 @@
+/*
+    路径遍历开销基准模块实现
+    目录链全部通过 mkdirat/openat 相对目录 fd 创建，深度不受 PATH_MAX 限制
+    测试项目 (每种分量长度 x 每种深度)：
+    - 完整路径 stat / open (路径超过 PATH_MAX 时不可用)
+    - 分段遍历 stat：每段不超过 PATH_MAX，逐段 openat(O_PATH)，最后 fstatat
+    - 缓存叶子目录 fd 后的 fstatat / openat
+    - 符号链接链：经过 N 级符号链接解析到目标文件的 stat / open
+*/
+
+#include "test_pathwalk.h"
+
+#include "timer.h"
+
+#include <limits.h>
+#include <sys/stat.h>
+
+#define PATHWALK_MAX_POINTS 16
+#define PATHWALK_SAMPLES 2000
+#define PATHWALK_MAX_NAME 255
+
+enum walk_op {
+    WALK_STAT_FULL,
+    WALK_STAT_CHUNKED,
+    WALK_FSTATAT_CACHED,
+    WALK_OPEN_FULL,
+    WALK_OPENAT_CACHED,
+    WALK_OP_COUNT,
+};
+
+struct walk_target {
+    const char *full;    /* 完整路径，过长时为 NULL */
+    const char *rel;     /* 相对基准目录的路径 */
+    int basefd;          /* 基准目录 fd */
+    int leaffd;          /* 叶子目录 fd */
+    const char *leaf;    /* 叶子目录中的文件名 */
+};
+
+/* 每段不超过 PATH_MAX 逐段解析，返回 fstatat 的结果 */
+static int chunked_stat(int basefd, const char *rel, struct stat *st) {
+    char chunk[PATH_MAX];
+    int fd = basefd;
+    int ret;
+
+    while (strlen(rel) >= PATH_MAX) {
+        const char *cut = rel + PATH_MAX - 1;
+        while (cut > rel && *cut != '/') cut--;
+        if (cut == rel) {
+            errno = ENAMETOOLONG;
+            ret = -1;
+            goto out;
+        }
+        memcpy(chunk, rel, cut - rel);
+        chunk[cut - rel] = '\0';
+        int nfd = openat(fd, chunk, O_PATH | O_DIRECTORY);
+        if (fd != basefd) close(fd);
+        if (nfd < 0) return -1;
+        fd = nfd;
+        rel = cut + 1;
+    }
+    ret = fstatat(fd, rel, st, 0);
+out:
+    if (fd != basefd) close(fd);
+    return ret;
+}
+
+static int do_walk_op(const struct walk_target *t, enum walk_op op) {
+    struct stat st;
+    int fd;
+
+    switch (op) {
+        case WALK_STAT_FULL:
+            return stat(t->full, &st);
+        case WALK_STAT_CHUNKED:
+            return chunked_stat(t->basefd, t->rel, &st);
+        case WALK_FSTATAT_CACHED:
+            return fstatat(t->leaffd, t->leaf, &st, 0);
+        case WALK_OPEN_FULL:
+            fd = open(t->full, O_RDONLY);
+            if (fd < 0) return -1;
+            return close(fd);
+        case WALK_OPENAT_CACHED:
+            fd = openat(t->leaffd, t->leaf, O_RDONLY);
+            if (fd < 0) return -1;
+            return close(fd);
+        default:
+            return -1;
+    }
+}
+
+/* 返回平均延迟 (us)，出错或不可用返回 -1 */
+static double time_walk_op(const struct walk_target *t, enum walk_op op) {
+    uint64_t t0, t1;
+    struct lat_hist hist;
+
+    if ((op == WALK_STAT_FULL || op == WALK_OPEN_FULL) && t->full == NULL) {
+        return -1.0;
+    }
+    /* 预热一次，保证 dentry 已在缓存中 */
+    if (do_walk_op(t, op) != 0) return -1.0;
+
+    lat_hist_init(&hist);
+    for (int i = 0; i < PATHWALK_SAMPLES; i++) {
+        t0 = timer_now();
+        int ret = do_walk_op(t, op);
+        t1 = timer_now();
+        if (ret != 0) return -1.0;
+        lat_hist_add(&hist, timer_diff_ns(t0, t1));
+    }
+    return hist.sum_ns / 1000.0 / hist.count;
+}
+
+static void print_cell(double us) {
+    if (us < 0.0) {
+        printf(" | %10s", "n/a");
+    } else {
+        printf(" | %10.2f", us);
+    }
+}
+
+/*
+    从叶子目录经 ".." 逐层向上删除至多 depth 层，到达 basefd 即停止，
+    不会越过基准目录；消耗 leaffd
+*/
+static void remove_chain(int basefd, int leaffd, const char *name, int depth) {
+    struct stat bst, st;
+    int fd = leaffd;
+    unlinkat(fd, "f", 0);
+    if (fstat(basefd, &bst) != 0) {
+        close(fd);
+        return;
+    }
+    for (int i = 0; i < depth; i++) {
+        if (fstat(fd, &st) != 0 ||
+            (st.st_dev == bst.st_dev && st.st_ino == bst.st_ino)) {
+            break;
+        }
+        int parent = openat(fd, "..", O_RDONLY | O_DIRECTORY);
+        close(fd);
+        if (parent < 0) return;
+        unlinkat(parent, name, AT_REMOVEDIR);
+        fd = parent;
+    }
+    close(fd);
+}
+
+/*
+    逐层 mkdirat + openat 建立目录链，返回叶子目录 fd
+    中途失败时删除已建立的各层并返回 -1 (errno 为失败原因)
+*/
+static int build_chain(int basefd, const char *name, int depth) {
+    int fd = dup(basefd);
+    if (fd < 0) return -1;
+    for (int i = 0; i < depth; i++) {
+        int nfd = -1;
+        if (mkdirat(fd, name, 0755) == 0 || errno == EEXIST) {
+            nfd = openat(fd, name, O_RDONLY | O_DIRECTORY);
+            if (nfd < 0) {
+                int saved = errno;
+                unlinkat(fd, name, AT_REMOVEDIR);
+                errno = saved;
+            }
+        }
+        if (nfd < 0) {
+            int saved = errno;
+            remove_chain(basefd, fd, name, i);
+            errno = saved;
+            return -1;
+        }
+        close(fd);
+        fd = nfd;
+    }
+    return fd;
+}
+
+/* 测量一个 (深度, 分量长度) 点，成功返回 0，无法建立时返回 errno */
+static int test_depth_point(const char *base, int basefd, size_t name_len,
+                            int depth) {
+    char name[PATHWALK_MAX_NAME + 1];
+    memset(name, 'd', name_len);
+    name[name_len] = '\0';
+
+    int leaffd = build_chain(basefd, name, depth);
+    if (leaffd < 0) return errno ? errno : EIO;
+    int fd = openat(leaffd, "f", O_CREAT | O_WRONLY, 0644);
+    if (fd < 0) {
+        int err = errno;
+        remove_chain(basefd, leaffd, name, depth);
+        return err;
+    }
+    close(fd);
+
+    size_t rel_len = (size_t)depth * (name_len + 1) + 2;
+    char *rel = malloc(rel_len);
+    char *p = rel;
+    for (int i = 0; i < depth; i++) {
+        memcpy(p, name, name_len);
+        p[name_len] = '/';
+        p += name_len + 1;
+    }
+    strcpy(p, "f");
+
+    size_t full_len = strlen(base) + 1 + strlen(rel) + 1;
+    char *full = NULL;
+    if (full_len <= PATH_MAX) {
+        full = malloc(full_len);
+        snprintf(full, full_len, "%s/%s", base, rel);
+    }
+
+    struct walk_target t = {full, rel, basefd, leaffd, "f"};
+    printf("  %6d | %5zu | %8zu", depth, name_len, full_len - 1);
+    for (int op = 0; op < WALK_OP_COUNT; op++) {
+        print_cell(time_walk_op(&t, (enum walk_op)op));
+    }
+    printf("\n");
+    fflush(stdout);
+
+    free(full);
+    free(rel);
+    remove_chain(basefd, leaffd, name, depth);
+    return 0;
+}
+
+static void test_symlink_chain(int basefd, int chain) {
+    char name[32], prev[32];
+    int fd = openat(basefd, "target", O_CREAT | O_WRONLY, 0644);
+    if (fd >= 0) close(fd);
+
+    snprintf(prev, sizeof(prev), "target");
+    for (int i = 0; i < chain; i++) {
+        snprintf(name, sizeof(name), "link%d", i);
+        if (symlinkat(prev, basefd, name) != 0 && errno != EEXIST) break;
+        snprintf(prev, sizeof(prev), "%s", name);
+    }
+
+    struct walk_target t = {NULL, prev, basefd, basefd, prev};
+    printf("  %6d", chain);
+    print_cell(time_walk_op(&t, WALK_FSTATAT_CACHED));
+    print_cell(time_walk_op(&t, WALK_OPENAT_CACHED));
+    printf("\n");
+
+    for (int i = 0; i < chain; i++) {
+        snprintf(name, sizeof(name), "link%d", i);
+        unlinkat(basefd, name, 0);
+    }
+    unlinkat(basefd, "target", 0);
+}
+
+void run_pathwalk_tests(const struct fstest_config *cfg) {
+    printf("\n");
+    printf("========================================\n");
+    printf("  10. 路径遍历开销基准 (Path Walk)\n");
+    printf("========================================\n");
+
+    size_t depths[PATHWALK_MAX_POINTS], lens[PATHWALK_MAX_POINTS];
+    size_t chains[PATHWALK_MAX_POINTS];
+    int depth_n = parse_size_list(cfg->path_depths, depths,
+                                  PATHWALK_MAX_POINTS);
+    int len_n = parse_size_list(cfg->path_name_lens, lens,
+                                PATHWALK_MAX_POINTS);
+    int chain_n = parse_size_list(cfg->symlink_chains, chains,
+                                  PATHWALK_MAX_POINTS);
+    if (depth_n <= 0 || len_n <= 0 || chain_n <= 0) {
+        TEST_FAIL("pathwalk", "invalid --path-depths, --path-name-lens or "
+                              "--symlink-chains list");
+        return;
+    }
+
+    char base[MAX_PATH_LEN];
+    make_test_path(base, sizeof(base), cfg->dir, "pathwalk");
+    if (mkdir(base, 0755) != 0 && errno != EEXIST) {
+        TEST_FAIL("pathwalk", strerror(errno));
+        return;
+    }
+    int basefd = open(base, O_RDONLY | O_DIRECTORY);
+    if (basefd < 0) {
+        TEST_FAIL("pathwalk", strerror(errno));
+        rmdir(base);
+        return;
+    }
+
+    printf("  Depths:       %s\n", cfg->path_depths);
+    printf("  Name lengths: %s\n", cfg->path_name_lens);
+    printf("  Samples:      %d per cell (avg us)\n", PATHWALK_SAMPLES);
+
+    printf("\n  --- 深度与分量长度 (Depth x Component Length) ---\n");
+    printf("  %6s | %5s | %8s | %10s | %10s | %10s | %10s | %10s\n", "depth",
+           "name", "path B", "stat full", "stat walk", "fstatat fd",
+           "open full", "openat fd");
+    int errors = 0, first_err = 0;
+    for (int l = 0; l < len_n; l++) {
+        size_t name_len = lens[l];
+        if (name_len < 1) name_len = 1;
+        if (name_len > PATHWALK_MAX_NAME) name_len = PATHWALK_MAX_NAME;
+        for (int d = 0; d < depth_n; d++) {
+            int err = test_depth_point(base, basefd, name_len,
+                                       (int)depths[d]);
+            if (err != 0) {
+                if (errors++ == 0) first_err = err;
+            }
+        }
+    }
+    if (errors > 0) {
+        char msg[128];
+        snprintf(msg, sizeof(msg), "%d depth points could not be built: %s",
+                 errors, strerror(first_err));
+        TEST_FAIL("pathwalk", msg);
+    }
+
+    printf("\n  --- 符号链接链 (Symlink Chains) ---\n");
+    printf("  %6s | %10s | %10s\n", "links", "stat", "open");
+    test_symlink_chain(basefd, 0);
+    for (int c = 0; c < chain_n; c++) {
+        test_symlink_chain(basefd, (int)chains[c]);
+    }
+
+    close(basefd);
+    rmdir(base);
+
+    printf("--- 路径遍历开销基准完成 ---\n");
+}
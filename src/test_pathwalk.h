@@ -0,0 +1,13 @@
+/*
+    路径遍历开销基准模块
+    衡量 stat/open 延迟随路径深度、分量长度和符号链接链长度的变化
+*/
+
+#ifndef FSTEST_TEST_PATHWALK_H
+#define FSTEST_TEST_PATHWALK_H
+
+#include "common.h"
+
+void run_pathwalk_tests(const struct fstest_config *cfg);
+
+#endif /* FSTEST_TEST_PATHWALK_H */
@@ -9,9 +9,16 @@
     - mmap 映射方式的顺序/随机读写吞吐
     - 元数据操作性能 (create/stat/rename/unlink)
     - 不同块大小、不同并发数下的表现
+    - 多线程共享同一文件 (分段 / 交错布局) 的扩展性 (sharedfile 模式)
+    - 吞吐测试前后测试文件驻留页缓存的比例 (--residency)
+    - 以本机 memcpy / tmpfs pread / 系统调用基线折算结果 (--calibrate)
 */
 
 #include "test_performance.h"
+#include "fsop.h"
+#include "test_calibrate.h"
+#include "timer.h"
+#include "worker.h"
 
 #include <sys/mman.h>
 #include <sys/stat.h>
@@ -20,6 +27,44 @@
 static char **perf_filenames = NULL;
 static int perf_filenames_count = 0;
 
+/* run_perf_test 的 worker 以子进程运行 (--procs) */
+static int perf_use_procs = 0;
+
+/* 重复试验设置 (--trials 等)，run_performance_tests 入口处设置 */
+static const struct fstest_config *perf_cfg = NULL;
+static int perf_evict_global = 0;     /* 可写 /proc/sys/vm/drop_caches */
+
+/* 本机基线 (--calibrate)，run_performance_tests 入口处测量 */
+static struct calib_baseline perf_calib;
+static int perf_calib_valid = 0;
+
+/* O_DIRECT 缓冲区对齐，test_direct_io_perf 按探测结果设置 */
+static size_t perf_dio_mem_align = 4096;
+
+/* 逐出后仍有超过该比例的页驻留时，认为"冷"试验实际是热的 */
+#define RESIDENCY_WARN_PCT 10.0
+
+/* 一个测试的页缓存驻留情况，百分比按页数计算 */
+struct perf_residency {
+    double before;             /* 各次试验开始前的最大值 */
+    double after;              /* 最后一次试验结束后 */
+    double file_before[MAX_JOBS];
+    double file_after[MAX_JOBS];
+    double during_min;
+    double during_max;
+    int samples;
+};
+
+/* 试验期间的周期采样线程 (--residency-interval) */
+struct residency_sampler {
+    pthread_t thread;
+    atomic_int stop;
+    int job_n;
+    size_t file_size;
+    int interval_ms;
+    struct perf_residency *res;
+};
+
 struct mmap_test_info {
     const char *file_name;
     int fd;
@@ -33,6 +78,25 @@ struct mmap_test_info {
     int error;
 };
 
+enum shared_layout { LAYOUT_SEGMENTED, LAYOUT_STRIDED };
+
+/* 共享文件测试线程信息：所有线程各自打开同一个文件 */
+struct shared_test_info {
+    const char *file_name;
+    int fd;
+    char *buf;
+    int job_id;
+    int job_n;
+    size_t file_size;
+    size_t io_size;
+    size_t stride;
+    int iter_count;
+    enum shared_layout layout;
+    int is_write;
+    size_t total_bytes;
+    int errors;
+};
+
 static const char *perf_type_name(enum test_type type) {
     switch (type) {
         case SEQ_READ:
@@ -84,7 +148,7 @@ static void create_perf_file(const char *filename, size_t file_size) {
     size_t block_size = 4 * _1MB_BYTES;
     size_t block_count = file_size / block_size;
 
-    int fd = open(filename, O_CREAT | O_WRONLY | O_TRUNC, 0644);
+    int fd = fs_open(filename, O_CREAT | O_WRONLY | O_TRUNC, 0644);
     if (fd < 0) {
         perror("create_perf_file");
         return;
@@ -93,16 +157,16 @@ static void create_perf_file(const char *filename, size_t file_size) {
     fill_rand_buffer(buf, block_size);
 
     for (size_t i = 0; i < block_count; i++) {
-        if (write(fd, buf, block_size) != (ssize_t)block_size) {
+        if (fs_write(fd, buf, block_size) != (ssize_t)block_size) {
             break;
         }
     }
     /* 写入余量 */
     size_t remainder = file_size % block_size;
     if (remainder > 0) {
-        (void)!write(fd, buf, remainder);
+        (void)!fs_write(fd, buf, remainder);
     }
-    close(fd);
+    fs_close(fd);
     free(buf);
 }
 
@@ -114,11 +178,11 @@ static void *perf_seq_read_job(void *arg) {
 
     for (int i = 0; i < info->iter_count; i++) {
         for (size_t j = 0; j < block_count; j++) {
-            ssize_t r = read(info->fd, info->buf, info->io_size);
+            ssize_t r = fs_read(info->fd, info->buf, info->io_size);
             if (r <= 0) break;
             total_bytes += r;
         }
-        lseek(info->fd, 0, SEEK_SET);
+        fs_lseek(info->fd, 0, SEEK_SET);
     }
     info->total_bytes = total_bytes;
     return NULL;
@@ -131,11 +195,11 @@ static void *perf_seq_write_job(void *arg) {
 
     for (int i = 0; i < info->iter_count; i++) {
         for (size_t j = 0; j < block_count; j++) {
-            ssize_t w = write(info->fd, info->buf, info->io_size);
+            ssize_t w = fs_write(info->fd, info->buf, info->io_size);
             if (w <= 0) break;
             total_bytes += w;
         }
-        lseek(info->fd, 0, SEEK_SET);
+        fs_lseek(info->fd, 0, SEEK_SET);
     }
     info->total_bytes = total_bytes;
     return NULL;
@@ -151,8 +215,8 @@ static void *perf_rand_read_job(void *arg) {
         for (size_t j = 0; j < block_count; j++) {
             off_t offset =
                 (off_t)(rand_r(&seed) % block_count) * info->io_size;
-            lseek(info->fd, offset, SEEK_SET);
-            ssize_t r = read(info->fd, info->buf, info->io_size);
+            fs_lseek(info->fd, offset, SEEK_SET);
+            ssize_t r = fs_read(info->fd, info->buf, info->io_size);
             if (r <= 0) break;
             total_bytes += r;
         }
@@ -171,8 +235,8 @@ static void *perf_rand_write_job(void *arg) {
         for (size_t j = 0; j < block_count; j++) {
             off_t offset =
                 (off_t)(rand_r(&seed) % block_count) * info->io_size;
-            lseek(info->fd, offset, SEEK_SET);
-            ssize_t w = write(info->fd, info->buf, info->io_size);
+            fs_lseek(info->fd, offset, SEEK_SET);
+            ssize_t w = fs_write(info->fd, info->buf, info->io_size);
             if (w <= 0) break;
             total_bytes += w;
         }
@@ -213,7 +277,7 @@ static void *perf_mmap_job(void *arg) {
         }
 
         if (info->type == SEQ_WRITE || info->type == RAND_WRITE) {
-            if (msync(info->map, info->file_size, MS_SYNC) != 0) {
+            if (fs_msync(info->map, info->file_size, MS_SYNC) != 0) {
                 info->error = errno;
                 break;
             }
@@ -224,13 +288,61 @@ static void *perf_mmap_job(void *arg) {
     return NULL;
 }
 
-/* 多线程性能测试 */
-static double run_perf_test(int job_n, size_t io_size, size_t file_size,
-                            int iter_count, enum test_type type,
-                            int use_direct_io) {
+/* 共享文件线程：分段布局下每个线程负责连续的一段，交错布局下按 stride 轮转 */
+static void *perf_shared_job(void *arg) {
+    struct shared_test_info *info = (struct shared_test_info *)arg;
+    size_t block_count = info->file_size / info->io_size;
+    size_t chunk_blocks = info->stride / info->io_size;
+    size_t total_bytes = 0;
+
+    if (chunk_blocks == 0) chunk_blocks = 1;
+    /* 末尾不足一个 stride 的块单独成段，保证整个文件都被访问 */
+    size_t chunk_count = (block_count + chunk_blocks - 1) / chunk_blocks;
+
+    for (int i = 0; i < info->iter_count; i++) {
+        size_t begin = 0, end = 0, step = 1;
+        if (info->layout == LAYOUT_SEGMENTED) {
+            begin = block_count * info->job_id / info->job_n;
+            end = block_count * (info->job_id + 1) / info->job_n;
+        } else {
+            begin = info->job_id;
+            end = chunk_count;
+            step = info->job_n;
+        }
+
+        for (size_t c = begin; c < end; c += step) {
+            size_t first = c, count = 1;
+            if (info->layout == LAYOUT_STRIDED) {
+                first = c * chunk_blocks;
+                count = block_count - first < chunk_blocks ? block_count - first
+                                                           : chunk_blocks;
+            }
+            for (size_t b = first; b < first + count; b++) {
+                off_t offset = (off_t)(b * info->io_size);
+                ssize_t n = info->is_write
+                                ? fs_pwrite(info->fd, info->buf, info->io_size,
+                                         offset)
+                                : fs_pread(info->fd, info->buf, info->io_size,
+                                        offset);
+                if (n <= 0) {
+                    info->errors++;
+                    break;
+                }
+                total_bytes += n;
+            }
+        }
+    }
+    info->total_bytes = total_bytes;
+    return NULL;
+}
+
+/* 多线程性能测试的一次试验，返回 MB/s，SKIP 返回 -1，出错返回 0 */
+static double perf_trial(int job_n, size_t io_size, size_t file_size,
+                         int iter_count, enum test_type type,
+                         int use_direct_io, double *secs_out) {
     void *(*test_job)(void *) = NULL;
     const char *type_str = perf_type_name(type);
-    int open_flags;
+    int open_flags = O_RDONLY;
     size_t buf_alignment = sizeof(void *);
     switch (type) {
         case SEQ_READ:
@@ -254,7 +366,9 @@ static double run_perf_test(int job_n, size_t io_size, size_t file_size,
 #ifdef O_DIRECT
     if (use_direct_io) {
         open_flags |= O_DIRECT;
-        buf_alignment = 4096;
+        if (perf_dio_mem_align > buf_alignment) {
+            buf_alignment = perf_dio_mem_align;
+        }
     }
 #else
     if (use_direct_io) {
@@ -264,10 +378,15 @@ static double run_perf_test(int job_n, size_t io_size, size_t file_size,
     }
 #endif
 
-    struct test_info *infos = malloc(job_n * sizeof(struct test_info));
+    struct test_info *infos =
+        worker_args_alloc(job_n, sizeof(struct test_info), perf_use_procs);
+    if (!infos) {
+        printf("  [ERROR] %s: %s\n", type_str, strerror(ENOMEM));
+        return 0.0;
+    }
     for (int i = 0; i < job_n; i++) {
         infos[i].file_name = perf_filenames[i];
-        infos[i].fd = open(perf_filenames[i], open_flags, 0644);
+        infos[i].fd = fs_open(perf_filenames[i], open_flags, 0644);
         if (infos[i].fd < 0) {
             if (use_direct_io && is_direct_io_unsupported(errno)) {
                 printf("  [SKIP] %s (O_DIRECT): %s\n",
@@ -277,20 +396,22 @@ static double run_perf_test(int job_n, size_t io_size, size_t file_size,
                        perf_filenames[i], strerror(errno));
             }
             for (int j = 0; j < i; j++) {
-                close(infos[j].fd);
+                fs_close(infos[j].fd);
                 free(infos[j].buf);
             }
-            free(infos);
+            worker_args_free(infos, job_n, sizeof(struct test_info),
+                             perf_use_procs);
             return use_direct_io && is_direct_io_unsupported(errno) ? -1.0 : 0.0;
         }
         if (posix_memalign(&infos[i].buf, buf_alignment, io_size) != 0) {
             printf("  [ERROR] posix_memalign failed for job %d\n", i);
             for (int j = 0; j < i; j++) {
-                close(infos[j].fd);
+                fs_close(infos[j].fd);
                 free(infos[j].buf);
             }
-            close(infos[i].fd);
-            free(infos);
+            fs_close(infos[i].fd);
+            worker_args_free(infos, job_n, sizeof(struct test_info),
+                             perf_use_procs);
             return 0.0;
         }
         fill_rand_buffer(infos[i].buf, io_size);
@@ -300,49 +421,36 @@ static double run_perf_test(int job_n, size_t io_size, size_t file_size,
         infos[i].iter_count = iter_count;
     }
 
-    pthread_t *threads = malloc(job_n * sizeof(pthread_t));
-    struct timespec start, end;
+    /* worker 在屏障处一起出发，线程创建 / fork 不计入测量区间 */
     size_t total_bytes = 0;
-
-    atomic_thread_fence(memory_order_seq_cst);
-    clock_gettime(CLOCK_MONOTONIC, &start);
-    atomic_thread_fence(memory_order_seq_cst);
-
+    int64_t elapsed_ns = run_workers(job_n, perf_use_procs, test_job, infos,
+                                     sizeof(struct test_info));
     for (int i = 0; i < job_n; i++) {
-        pthread_create(&threads[i], NULL, test_job, &infos[i]);
-    }
-    for (int i = 0; i < job_n; i++) {
-        pthread_join(threads[i], NULL);
         total_bytes += infos[i].total_bytes;
+        fs_close(infos[i].fd);
+        free(infos[i].buf);
+    }
+    worker_args_free(infos, job_n, sizeof(struct test_info), perf_use_procs);
+    if (elapsed_ns <= 0) {
+        printf("  [ERROR] %s: %s (%d %s)\n", type_str,
+               worker_strerror(elapsed_ns), job_n,
+               worker_kind(perf_use_procs));
+        return 0.0;
     }
 
-    atomic_thread_fence(memory_order_seq_cst);
-    clock_gettime(CLOCK_MONOTONIC, &end);
-    atomic_thread_fence(memory_order_seq_cst);
-
-    double duration_ns = calculate_time_diff_ns(&start, &end);
+    double duration_ns = (double)elapsed_ns;
     double duration_s = duration_ns / (double)NANOS_PER_SECOND;
     double throughput_mbs =
         (total_bytes / (1024.0 * 1024.0)) / duration_s;
 
-    for (int i = 0; i < job_n; i++) {
-        close(infos[i].fd);
-        free(infos[i].buf);
-    }
-    free(infos);
-    free(threads);
-
-    char label[48];
-    snprintf(label, sizeof(label), "%s%s", type_str,
-             use_direct_io ? " (O_DIRECT)" : "");
-    printf("  %-31s | IO: %6zuB | %2d jobs | %.2f MB/s | %.3f s\n",
-           label,
-           io_size, job_n, throughput_mbs, duration_s);
+    *secs_out = duration_s;
     return throughput_mbs;
 }
 
-static double run_mmap_perf_test(int job_n, size_t io_size, size_t file_size,
-                                 int iter_count, enum test_type type) {
+/* mmap 方式的一次试验，返回 MB/s，出错返回 0 */
+static double mmap_perf_trial(int job_n, size_t io_size, size_t file_size,
+                              int iter_count, enum test_type type,
+                              double *secs_out) {
     int open_flags =
         (type == SEQ_READ || type == RAND_READ) ? O_RDONLY : O_RDWR;
     int prot =
@@ -360,13 +468,13 @@ static double run_mmap_perf_test(int job_n, size_t io_size, size_t file_size,
     memset(infos, 0, job_n * sizeof(struct mmap_test_info));
     for (int i = 0; i < job_n; i++) {
         infos[i].file_name = perf_filenames[i];
-        infos[i].fd = open(perf_filenames[i], open_flags, 0644);
+        infos[i].fd = fs_open(perf_filenames[i], open_flags, 0644);
         if (infos[i].fd < 0) {
             printf("  [ERROR] Cannot open %s for mmap test: %s\n",
                    perf_filenames[i], strerror(errno));
             for (int j = 0; j < i; j++) {
-                munmap(infos[j].map, infos[j].file_size);
-                close(infos[j].fd);
+                fs_munmap(infos[j].map, infos[j].file_size);
+                fs_close(infos[j].fd);
                 free(infos[j].buf);
             }
             free(infos);
@@ -377,10 +485,10 @@ static double run_mmap_perf_test(int job_n, size_t io_size, size_t file_size,
         infos[i].buf = malloc(io_size);
         if (!infos[i].buf) {
             printf("  [ERROR] malloc failed for mmap job %d\n", i);
-            close(infos[i].fd);
+            fs_close(infos[i].fd);
             for (int j = 0; j < i; j++) {
-                munmap(infos[j].map, infos[j].file_size);
-                close(infos[j].fd);
+                fs_munmap(infos[j].map, infos[j].file_size);
+                fs_close(infos[j].fd);
                 free(infos[j].buf);
             }
             free(infos);
@@ -389,16 +497,16 @@ static double run_mmap_perf_test(int job_n, size_t io_size, size_t file_size,
         }
 
         fill_rand_buffer(infos[i].buf, io_size);
-        infos[i].map = mmap(NULL, file_size, prot, MAP_SHARED,
+        infos[i].map = fs_mmap(NULL, file_size, prot, MAP_SHARED,
                             infos[i].fd, 0);
         if (infos[i].map == MAP_FAILED) {
             printf("  [ERROR] mmap failed for %s: %s\n",
                    perf_filenames[i], strerror(errno));
             free(infos[i].buf);
-            close(infos[i].fd);
+            fs_close(infos[i].fd);
             for (int j = 0; j < i; j++) {
-                munmap(infos[j].map, infos[j].file_size);
-                close(infos[j].fd);
+                fs_munmap(infos[j].map, infos[j].file_size);
+                fs_close(infos[j].fd);
                 free(infos[j].buf);
             }
             free(infos);
@@ -436,10 +544,10 @@ static double run_mmap_perf_test(int job_n, size_t io_size, size_t file_size,
                    perf_type_name(type), strerror(infos[i].error));
             for (int j = 0; j < job_n; j++) {
                 if (infos[j].map && infos[j].map != MAP_FAILED) {
-                    munmap(infos[j].map, infos[j].file_size);
+                    fs_munmap(infos[j].map, infos[j].file_size);
                 }
                 if (infos[j].fd >= 0) {
-                    close(infos[j].fd);
+                    fs_close(infos[j].fd);
                 }
                 free(infos[j].buf);
             }
@@ -454,21 +562,238 @@ static double run_mmap_perf_test(int job_n, size_t io_size, size_t file_size,
     double throughput_mbs =
         duration_s > 0.0 ? (total_bytes / (1024.0 * 1024.0)) / duration_s : 0.0;
 
-    char label[48];
-    snprintf(label, sizeof(label), "%s (mmap)", perf_type_name(type));
-    printf("  %-31s | IO: %6zuB | %2d jobs | %.2f MB/s | %.3f s\n",
-           label, io_size, job_n, throughput_mbs, duration_s);
-
     for (int i = 0; i < job_n; i++) {
-        munmap(infos[i].map, infos[i].file_size);
-        close(infos[i].fd);
+        fs_munmap(infos[i].map, infos[i].file_size);
+        fs_close(infos[i].fd);
         free(infos[i].buf);
     }
     free(infos);
     free(threads);
+    *secs_out = duration_s;
     return throughput_mbs;
 }
 
+/* 测试文件驻留页缓存的百分比，per_file 可为 NULL；无法统计时返回 -1 */
+static double perf_resident_pct(int job_n, size_t file_size,
+                                double *per_file) {
+    long page = sysconf(_SC_PAGESIZE);
+    long pages = (file_size + page - 1) / page;
+    long total = 0;
+    if (pages == 0) return -1.0;
+    for (int i = 0; i < job_n; i++) {
+        /* 直接调用 open，采样不计入系统调用剖析 */
+        int fd = open(perf_filenames[i], O_RDONLY);
+        long r = fd >= 0 ? page_cache_resident(fd, 0, file_size) : -1;
+        if (fd >= 0) close(fd);
+        if (r < 0) return -1.0;
+        if (per_file) per_file[i] = r * 100.0 / pages;
+        total += r;
+    }
+    return total * 100.0 / ((double)pages * job_n);
+}
+
+static void *residency_sampler_main(void *arg) {
+    struct residency_sampler *s = arg;
+    struct timespec ts = {s->interval_ms / 1000,
+                          (s->interval_ms % 1000) * 1000000L};
+    while (!atomic_load(&s->stop)) {
+        nanosleep(&ts, NULL);
+        if (atomic_load(&s->stop)) break;
+        double pct = perf_resident_pct(s->job_n, s->file_size, NULL);
+        if (pct < 0.0) continue;
+        struct perf_residency *r = s->res;
+        if (r->samples == 0 || pct < r->during_min) r->during_min = pct;
+        if (r->samples == 0 || pct > r->during_max) r->during_max = pct;
+        r->samples++;
+    }
+    return NULL;
+}
+
+static void print_residency(const char *label, int job_n,
+                            const struct perf_residency *r) {
+    if (r->before < 0.0 || r->after < 0.0) {
+        printf("  %31s | cache resident: n/a (mincore failed)\n", "");
+        return;
+    }
+    printf("  %31s | cache resident %5.1f%% -> %5.1f%%", "", r->before,
+           r->after);
+    if (r->samples > 0) {
+        printf(" | during %.1f-%.1f%% (%d samples)", r->during_min,
+               r->during_max, r->samples);
+    }
+    printf("\n");
+    if (job_n > 1) {
+        printf("  %31s | per file:", "");
+        for (int i = 0; i < job_n; i++) {
+            printf(" %.0f->%.0f%%", r->file_before[i], r->file_after[i]);
+        }
+        printf("\n");
+    }
+    if (perf_cfg->drop_caches && r->before > RESIDENCY_WARN_PCT) {
+        printf("  [WARN] %s: started %.1f%% resident despite "
+               "--drop-caches, cold numbers are warm\n",
+               label, r->before);
+    }
+}
+
+/* 以同线程数的 memcpy 和 tmpfs pread 基线折算吞吐 */
+static void print_calib_fraction(double mbs, int job_n) {
+    int mt = job_n > 1;
+    double mem = mt ? perf_calib.memcpy_mt_mbs : perf_calib.memcpy_mbs;
+    double tmpfs = mt ? perf_calib.pread_mt_mbs : perf_calib.pread_mbs;
+    printf("  %31s | %.1f%% of memcpy", "", mbs / mem * 100.0);
+    if (tmpfs > 0.0) {
+        printf(" | %.1f%% of tmpfs pread", mbs / tmpfs * 100.0);
+    }
+    printf("\n");
+}
+
+/* 试验之间逐出测试文件的页缓存：有权限时写 drop_caches (连同 dentry /
+   inode 缓存)，否则逐个文件 fdatasync 后 POSIX_FADV_DONTNEED */
+static void perf_evict_caches(int job_n) {
+    if (perf_evict_global) {
+        sync();
+        int fd = open("/proc/sys/vm/drop_caches", O_WRONLY);
+        if (fd >= 0) {
+            int ok = write(fd, "3", 1) == 1;
+            close(fd);
+            if (ok) return;
+        }
+    }
+    for (int i = 0; i < job_n; i++) {
+        int fd = fs_open(perf_filenames[i], O_RDONLY);
+        if (fd < 0) continue;
+        fs_fdatasync(fd);
+        posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        fs_close(fd);
+    }
+}
+
+struct perf_case {
+    int job_n;
+    size_t io_size;
+    size_t file_size;
+    int iter_count;
+    enum test_type type;
+    int use_direct_io;
+    int use_mmap;
+};
+
+/*
+    按 --trials 重复独立试验并打印结果，返回均值 MB/s (SKIP 返回 -1，出错
+    返回 0)。--cv-target 大于 0 时至少跑 3 次，之后变异系数仍高于目标则
+    继续追加试验，直到 --max-trials
+*/
+static double run_perf_case(const struct perf_case *c) {
+    double samples[MAX_TRIALS];
+    double secs_sum = 0.0;
+    int min_trials = perf_cfg->trials;
+    int max_trials = min_trials;
+    struct sample_stats st;
+    struct perf_residency res;
+    int track = perf_cfg->residency || perf_cfg->drop_caches;
+    int n = 0;
+
+    if (perf_cfg->cv_target > 0.0) {
+        if (min_trials < 3) min_trials = 3;
+        max_trials = perf_cfg->max_trials > min_trials ? perf_cfg->max_trials
+                                                       : min_trials;
+    }
+    memset(&st, 0, sizeof(st));
+    memset(&res, 0, sizeof(res));
+    while (n < max_trials) {
+        if (perf_cfg->drop_caches) perf_evict_caches(c->job_n);
+        struct residency_sampler sampler = {0};
+        double file_pct[MAX_JOBS];
+        if (track) {
+            double pct = perf_resident_pct(c->job_n, c->file_size, file_pct);
+            if (n == 0 || pct < 0.0 || pct > res.before) {
+                res.before = pct;
+                memcpy(res.file_before, file_pct, sizeof(file_pct));
+            }
+        }
+        if (perf_cfg->residency_interval > 0) {
+            sampler.job_n = c->job_n;
+            sampler.file_size = c->file_size;
+            sampler.interval_ms = perf_cfg->residency_interval;
+            sampler.res = &res;
+            if (pthread_create(&sampler.thread, NULL, residency_sampler_main,
+                               &sampler) != 0) {
+                sampler.res = NULL;
+            }
+        }
+        double secs = 0.0;
+        double mbs = c->use_mmap
+                         ? mmap_perf_trial(c->job_n, c->io_size, c->file_size,
+                                           c->iter_count, c->type, &secs)
+                         : perf_trial(c->job_n, c->io_size, c->file_size,
+                                      c->iter_count, c->type,
+                                      c->use_direct_io, &secs);
+        if (sampler.res) {
+            atomic_store(&sampler.stop, 1);
+            pthread_join(sampler.thread, NULL);
+        }
+        if (track) {
+            res.after = perf_resident_pct(c->job_n, c->file_size,
+                                          res.file_after);
+        }
+        if (mbs <= 0.0) return mbs;
+        samples[n++] = mbs;
+        secs_sum += secs;
+        if (n < min_trials) continue;
+        sample_stats_compute(samples, n, perf_cfg->reject_outliers, &st);
+        if (perf_cfg->cv_target <= 0.0 ||
+            st.cv * 100.0 <= perf_cfg->cv_target) {
+            break;
+        }
+    }
+
+    char label[48];
+    snprintf(label, sizeof(label), "%s%s", perf_type_name(c->type),
+             c->use_mmap ? " (mmap)" : c->use_direct_io ? " (O_DIRECT)" : "");
+    printf("  %-31s | IO: %6zuB | %2d %s | %.2f MB/s | %.3f s\n", label,
+           c->io_size, c->job_n,
+           perf_use_procs && !c->use_mmap ? "procs" : "jobs", st.mean,
+           secs_sum / n);
+    if (perf_calib_valid && !c->use_direct_io) {
+        print_calib_fraction(st.mean, c->job_n);
+    }
+    if (perf_cfg->residency ||
+        (perf_cfg->drop_caches && res.before > RESIDENCY_WARN_PCT)) {
+        print_residency(label, c->job_n, &res);
+    }
+    if (n == 1) return st.mean;
+
+    char trials[48];
+    snprintf(trials, sizeof(trials), "%d trials", n);
+    if (st.rejected > 0) {
+        snprintf(trials, sizeof(trials), "%d trials (%d outlier%s)", n,
+                 st.rejected, st.rejected > 1 ? "s" : "");
+    }
+    printf("  %31s | %s | median %.2f | sd %.2f | CV %.1f%% | "
+           "95%% CI ±%.2f MB/s\n",
+           "", trials, st.median, st.stddev, st.cv * 100.0, st.ci95);
+    if (perf_cfg->cv_target > 0.0 && st.cv * 100.0 > perf_cfg->cv_target) {
+        printf("  %31s | CV still above --cv-target %.1f%% after %d trials\n",
+               "", perf_cfg->cv_target, n);
+    }
+    return st.mean;
+}
+
+static double run_perf_test(int job_n, size_t io_size, size_t file_size,
+                            int iter_count, enum test_type type,
+                            int use_direct_io) {
+    struct perf_case c = {job_n, io_size, file_size, iter_count, type,
+                          use_direct_io, 0};
+    return run_perf_case(&c);
+}
+
+static double run_mmap_perf_test(int job_n, size_t io_size, size_t file_size,
+                                 int iter_count, enum test_type type) {
+    struct perf_case c = {job_n, io_size, file_size, iter_count, type, 0, 1};
+    return run_perf_case(&c);
+}
+
 static void test_direct_io_perf(const struct fstest_config *cfg, int job_n) {
     printf("\n  --- 绕过页缓存测试 (O_DIRECT) ---\n");
 
@@ -476,9 +801,22 @@ static void test_direct_io_perf(const struct fstest_config *cfg, int job_n) {
     TEST_SKIP("direct I/O throughput", "O_DIRECT is not available on this platform");
     return;
 #else
-    size_t direct_io_size = align_up(cfg->io_size, 4096);
+    size_t mem_align = 4096, off_align = 4096;
+    int src = dio_alignment(perf_filenames[0], &mem_align, &off_align);
+    if (src < 0) {
+        printf("  DIO alignment: unknown (%s), assuming 4096\n",
+               strerror(errno));
+        mem_align = off_align = 4096;
+    } else {
+        printf("  DIO alignment: memory %zuB, offset / length %zuB (%s)\n",
+               mem_align, off_align,
+               src == DIO_ALIGN_STATX ? "statx" : "probed");
+    }
+    perf_dio_mem_align = mem_align;
+
+    size_t direct_io_size = align_up(cfg->io_size, off_align);
     if (direct_io_size == 0) {
-        direct_io_size = 4096;
+        direct_io_size = off_align;
     }
     if (direct_io_size != cfg->io_size) {
         printf("  Requested IO size %zuB is not O_DIRECT-aligned; using %zuB instead.\n",
@@ -526,7 +864,7 @@ static void test_latency(const struct fstest_config *cfg) {
     make_test_path(path, sizeof(path), cfg->dir, "perf_latency.dat");
 
     /* 创建测试文件 */
-    int fd = open(path, O_CREAT | O_RDWR | O_TRUNC, 0644);
+    int fd = fs_open(path, O_CREAT | O_RDWR | O_TRUNC, 0644);
     if (fd < 0) {
         TEST_FAIL("latency test", strerror(errno));
         return;
@@ -537,21 +875,18 @@ static void test_latency(const struct fstest_config *cfg) {
 
     /* 先写入足够数据 */
     for (int i = 0; i < 100; i++) {
-        (void)!write(fd, buf, io_size);
+        (void)!fs_write(fd, buf, io_size);
     }
 
-    /* 测量写延迟 */
+    /* 测量写延迟：插桩开启 (默认) 时 fs_* 包装自身也要读两次计时器，
+       直接调用 pwrite / pread，区间内只有系统调用本身 */
     int samples = 1000;
     double *latencies = malloc(samples * sizeof(double));
-    struct timespec ts1, ts2;
 
-    lseek(fd, 0, SEEK_SET);
     for (int i = 0; i < samples; i++) {
-        clock_gettime(CLOCK_MONOTONIC, &ts1);
-        (void)!write(fd, buf, io_size);
-        clock_gettime(CLOCK_MONOTONIC, &ts2);
-        latencies[i] = calculate_time_diff_ns(&ts1, &ts2) / 1000.0;
-        lseek(fd, 0, SEEK_SET);
+        uint64_t t0 = timer_now();
+        (void)!pwrite(fd, buf, io_size, 0);
+        latencies[i] = timer_diff_ns(t0, timer_now()) / 1000.0;
     }
 
     /* 计算统计量 */
@@ -567,13 +902,10 @@ static void test_latency(const struct fstest_config *cfg) {
            io_size, avg_lat, min_lat, max_lat);
 
     /* 测量读延迟 */
-    lseek(fd, 0, SEEK_SET);
     for (int i = 0; i < samples; i++) {
-        clock_gettime(CLOCK_MONOTONIC, &ts1);
-        (void)!read(fd, buf, io_size);
-        clock_gettime(CLOCK_MONOTONIC, &ts2);
-        latencies[i] = calculate_time_diff_ns(&ts1, &ts2) / 1000.0;
-        lseek(fd, 0, SEEK_SET);
+        uint64_t t0 = timer_now();
+        (void)!pread(fd, buf, io_size, 0);
+        latencies[i] = timer_diff_ns(t0, timer_now()) / 1000.0;
     }
 
     min_lat = latencies[0];
@@ -588,11 +920,23 @@ static void test_latency(const struct fstest_config *cfg) {
     printf("  Read latency  (%zuB): avg=%.1f us, min=%.1f us, "
            "max=%.1f us\n",
            io_size, avg_lat, min_lat, max_lat);
+    /* 每个样本只有首尾两次 timer_now，区间内含一次读时钟的开销 */
+    printf("  Timer overhead: %s %.1f ns (%.1f%% of read avg)", timer_name(),
+           timer_overhead_ns(), timer_overhead_ns() / 10.0 / avg_lat);
+    if (perf_calib_valid) {
+        if (perf_calib.pread_ns > 0.0) {
+            printf(" | read avg = %.1fx tmpfs pread",
+                   avg_lat * 1000.0 / perf_calib.pread_ns);
+        }
+        printf(" | %.1fx null syscall",
+               avg_lat * 1000.0 / perf_calib.syscall_ns);
+    }
+    printf("\n");
 
     free(latencies);
     free(buf);
-    close(fd);
-    unlink(path);
+    fs_close(fd);
+    fs_unlink(path);
 }
 
 /* 测试：元数据操作性能 */
@@ -600,7 +944,7 @@ static void test_metadata_perf(const struct fstest_config *cfg) {
     printf("\n  --- 元数据操作性能 (Metadata) ---\n");
     char subdir[MAX_PATH_LEN];
     make_test_path(subdir, sizeof(subdir), cfg->dir, "perf_meta");
-    mkdir(subdir, 0755);
+    fs_mkdir(subdir, 0755);
 
     int ops = 1000;
     struct timespec start, end;
@@ -610,8 +954,8 @@ static void test_metadata_perf(const struct fstest_config *cfg) {
     for (int i = 0; i < ops; i++) {
         char p[MAX_PATH_LEN];
         snprintf(p, sizeof(p), "%s/meta_%d.dat", subdir, i);
-        int fd = open(p, O_CREAT | O_WRONLY | O_TRUNC, 0644);
-        if (fd >= 0) close(fd);
+        int fd = fs_open(p, O_CREAT | O_WRONLY | O_TRUNC, 0644);
+        if (fd >= 0) fs_close(fd);
     }
     clock_gettime(CLOCK_MONOTONIC, &end);
     double create_us =
@@ -624,7 +968,7 @@ static void test_metadata_perf(const struct fstest_config *cfg) {
     for (int i = 0; i < ops; i++) {
         char p[MAX_PATH_LEN];
         snprintf(p, sizeof(p), "%s/meta_%d.dat", subdir, i);
-        stat(p, &st);
+        fs_stat(p, &st);
     }
     clock_gettime(CLOCK_MONOTONIC, &end);
     double stat_us =
@@ -637,7 +981,7 @@ static void test_metadata_perf(const struct fstest_config *cfg) {
         char p1[MAX_PATH_LEN], p2[MAX_PATH_LEN];
         snprintf(p1, sizeof(p1), "%s/meta_%d.dat", subdir, i);
         snprintf(p2, sizeof(p2), "%s/meta_%d_r.dat", subdir, i);
-        rename(p1, p2);
+        fs_rename(p1, p2);
     }
     clock_gettime(CLOCK_MONOTONIC, &end);
     double rename_us =
@@ -649,14 +993,145 @@ static void test_metadata_perf(const struct fstest_config *cfg) {
     for (int i = 0; i < ops; i++) {
         char p[MAX_PATH_LEN];
         snprintf(p, sizeof(p), "%s/meta_%d_r.dat", subdir, i);
-        unlink(p);
+        fs_unlink(p);
     }
     clock_gettime(CLOCK_MONOTONIC, &end);
     double unlink_us =
         calculate_time_diff_ns(&start, &end) / 1000.0 / ops;
     printf("  unlink:  %.1f us/op (%d ops)\n", unlink_us, ops);
 
-    rmdir(subdir);
+    fs_rmdir(subdir);
+}
+
+static double run_shared_perf_test(const char *path, int job_n,
+                                   size_t io_size, size_t file_size,
+                                   int iter_count, enum shared_layout layout,
+                                   size_t stride, int is_write,
+                                   double base_mbs) {
+    struct shared_test_info *infos =
+        calloc(job_n, sizeof(struct shared_test_info));
+    pthread_t *threads = malloc(job_n * sizeof(pthread_t));
+    int opened = 0;
+
+    for (int i = 0; i < job_n; i++) {
+        infos[i].file_name = path;
+        infos[i].fd = fs_open(path, is_write ? O_WRONLY : O_RDONLY);
+        if (infos[i].fd < 0) {
+            printf("  [ERROR] Cannot open %s: %s\n", path, strerror(errno));
+            break;
+        }
+        opened++;
+        infos[i].buf = malloc(io_size);
+        fill_rand_buffer(infos[i].buf, io_size);
+        infos[i].job_id = i;
+        infos[i].job_n = job_n;
+        infos[i].file_size = file_size;
+        infos[i].io_size = io_size;
+        infos[i].stride = stride;
+        infos[i].iter_count = iter_count;
+        infos[i].layout = layout;
+        infos[i].is_write = is_write;
+    }
+
+    double throughput_mbs = 0.0;
+    if (opened == job_n) {
+        struct timespec start, end;
+        size_t total_bytes = 0;
+        int errors = 0;
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (int i = 0; i < job_n; i++) {
+            pthread_create(&threads[i], NULL, perf_shared_job, &infos[i]);
+        }
+        for (int i = 0; i < job_n; i++) {
+            pthread_join(threads[i], NULL);
+            total_bytes += infos[i].total_bytes;
+            errors += infos[i].errors;
+        }
+        clock_gettime(CLOCK_MONOTONIC, &end);
+
+        double duration_s =
+            calculate_time_diff_ns(&start, &end) / (double)NANOS_PER_SECOND;
+        throughput_mbs = duration_s > 0.0
+                             ? (total_bytes / (1024.0 * 1024.0)) / duration_s
+                             : 0.0;
+
+        char label[48];
+        snprintf(label, sizeof(label), "Shared %s (%s)",
+                 is_write ? "Write" : "Read",
+                 layout == LAYOUT_SEGMENTED ? "segmented" : "strided");
+        printf("  %-31s | IO: %6zuB | %2d jobs | %.2f MB/s | %.3f s | "
+               "scale %.2fx\n",
+               label, io_size, job_n, throughput_mbs, duration_s,
+               base_mbs > 0.0 ? throughput_mbs / base_mbs : 1.0);
+        if (errors > 0) {
+            TEST_FAIL(label, "short or failed I/O on shared file");
+        }
+    }
+
+    for (int i = 0; i < opened; i++) {
+        fs_close(infos[i].fd);
+        free(infos[i].buf);
+    }
+    free(infos);
+    free(threads);
+    return throughput_mbs;
+}
+
+/* 共享文件模式：1 到 N 个线程对同一个文件做 IO，观察 inode 级锁竞争 */
+void run_sharedfile_tests(const struct fstest_config *cfg) {
+    printf("\n");
+    printf("========================================\n");
+    printf("  11. 共享文件扩展性 (Shared File)\n");
+    printf("========================================\n");
+
+    /* 交错块由整数个 IO 组成，不是 IO 大小整数倍的 stride 向下取整 */
+    size_t stride = cfg->stride ? cfg->stride : cfg->io_size;
+    if (stride < cfg->io_size) stride = cfg->io_size;
+    stride -= stride % cfg->io_size;
+    printf("  Max Threads: %d\n", cfg->jobs);
+    printf("  IO Size:     %zu bytes\n", cfg->io_size);
+    if (cfg->stride && stride != cfg->stride) {
+        printf("  Stride:      %zu bytes (requested %zu, rounded to IO size)\n",
+               stride, cfg->stride);
+    } else {
+        printf("  Stride:      %zu bytes\n", stride);
+    }
+    printf("  File Size:   %zu MB (shared)\n", cfg->file_size / _1MB_BYTES);
+    printf("  Iterations:  %d\n", cfg->iter_count);
+
+    char path[MAX_PATH_LEN];
+    make_test_path(path, sizeof(path), cfg->dir, "perf_shared.dat");
+    printf("\n  Creating shared test file...\n");
+    create_perf_file(path, cfg->file_size);
+
+    /* 线程数按 1, 2, 4, ... 翻倍，最后一定包含 -j 指定的值 */
+    int counts[MAX_JOBS];
+    int count_n = 0;
+    for (int n = 1; n < cfg->jobs; n *= 2) {
+        counts[count_n++] = n;
+    }
+    counts[count_n++] = cfg->jobs;
+
+    for (int layout = LAYOUT_SEGMENTED; layout <= LAYOUT_STRIDED; layout++) {
+        for (int is_write = 1; is_write >= 0; is_write--) {
+            printf("\n  --- %s %s ---\n",
+                   layout == LAYOUT_SEGMENTED ? "分段布局 (Segmented)"
+                                              : "交错布局 (Strided)",
+                   is_write ? "Write" : "Read");
+            double base = 0.0;
+            for (int c = 0; c < count_n; c++) {
+                double mbs = run_shared_perf_test(
+                    path, counts[c], cfg->io_size, cfg->file_size,
+                    cfg->iter_count, (enum shared_layout)layout, stride,
+                    is_write, base);
+                if (c == 0) base = mbs;
+            }
+        }
+    }
+
+    fs_unlink(path);
+    printf("--- 共享文件扩展性测试完成 ---\n");
 }
 
 void run_performance_tests(const struct fstest_config *cfg) {
@@ -666,12 +1141,47 @@ void run_performance_tests(const struct fstest_config *cfg) {
     printf("========================================\n");
     printf("  Directory:  %s\n", cfg->dir);
     printf("  Threads:    %d\n", cfg->jobs);
+    printf("  Workers:    %s\n", worker_kind(cfg->procs));
     printf("  IO Size:    %zu bytes\n", cfg->io_size);
     printf("  File Size:  %zu MB\n", cfg->file_size / _1MB_BYTES);
     printf("  Iterations: %d\n", cfg->iter_count);
 
     int job_n = cfg->jobs;
     if (job_n > MAX_JOBS) job_n = MAX_JOBS;
+    perf_use_procs = cfg->procs;
+    perf_cfg = cfg;
+    perf_evict_global = access("/proc/sys/vm/drop_caches", W_OK) == 0;
+    if (cfg->trials > 1 || cfg->cv_target > 0.0) {
+        printf("  Trials:     %d", cfg->trials);
+        if (cfg->cv_target > 0.0) {
+            printf(" (at least 3, up to %d while CV > %.1f%%)",
+                   cfg->max_trials, cfg->cv_target);
+        }
+        printf("%s\n", cfg->reject_outliers ? ", outlier rejection" : "");
+    }
+    if (cfg->drop_caches) {
+        printf("  Evict:      %s between trials\n",
+               perf_evict_global ? "drop_caches" : "fdatasync + fadvise");
+    }
+    if (cfg->residency) {
+        printf("  Residency:  mincore before / after each test");
+        if (cfg->residency_interval > 0) {
+            printf(", every %d ms during", cfg->residency_interval);
+        }
+        printf("\n");
+    }
+
+    perf_calib_valid = 0;
+    if (cfg->calibrate) {
+        printf("\n  --- 基线校准 (Calibration) ---\n");
+        perf_calib_valid =
+            calibrate_measure(cfg->io_size, job_n, &perf_calib) == 0;
+        if (perf_calib_valid) {
+            calibrate_print(&perf_calib);
+        } else {
+            TEST_SKIP("calibration", "baseline measurement failed");
+        }
+    }
 
     init_perf_filenames(cfg->dir, job_n);
 
@@ -716,7 +1226,7 @@ void run_performance_tests(const struct fstest_config *cfg) {
     /* 清理测试文件 */
     printf("\n  Cleaning up test files...\n");
     for (int i = 0; i < job_n; i++) {
-        unlink(perf_filenames[i]);
+        fs_unlink(perf_filenames[i]);
     }
     free_perf_filenames();
 
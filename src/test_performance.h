@@ -9,5 +9,6 @@
 #include "common.h"
 
 void run_performance_tests(const struct fstest_config *cfg);
+void run_sharedfile_tests(const struct fstest_config *cfg);
 
 #endif /* FSTEST_TEST_PERFORMANCE_H */
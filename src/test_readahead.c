@@ -0,0 +1,281 @@
+/*
+    预读与 fadvise 效果模块实现
+    在 -f 大小的文件上以 -s 大小做缓冲顺序读，每个变体开始前用
+    fdatasync + POSIX_FADV_DONTNEED 逐出该文件的页缓存：
+    - default / SEQUENTIAL / RANDOM / WILLNEED / NOREUSE：打开后施加对应建议
+    - readahead(2)：读指针进入上一个窗口的后半段时显式预读下一个
+      --ra-window 窗口
+    - DONTNEED behind：每读完一个 --ra-window 就丢弃身后的页，流式读取
+    每个变体报告吞吐、单次读延迟、慢读 (超过 p50 的 10 倍，即同步等待设备)
+    的次数和平均间隔，以及结束时文件驻留页缓存的比例
+    预读窗口探测：冷缓存下读首个块后用 mincore 统计已进入页缓存的范围
+    (初始窗口)，继续顺序读时每 1MB 采样读指针前方的驻留量 (稳定窗口)，
+    并与块设备 / BDI 配置的 read_ahead_kb 对照
+*/
+
+#include "test_readahead.h"
+
+#include "timed_io.h"
+#include "timer.h"
+
+#include <sys/sysmacros.h>
+
+#define RA_PROBE_SPAN (64 * _1MB_BYTES)
+#define RA_SLOW_FACTOR 10
+
+enum ra_variant {
+    RA_DEFAULT,
+    RA_SEQUENTIAL,
+    RA_RANDOM,
+    RA_WILLNEED,
+    RA_NOREUSE,
+    RA_EXPLICIT,
+    RA_DROP_BEHIND,
+    RA_COUNT
+};
+
+static const char *ra_variant_name(enum ra_variant v) {
+    switch (v) {
+        case RA_DEFAULT: return "default";
+        case RA_SEQUENTIAL: return "FADV_SEQUENTIAL";
+        case RA_RANDOM: return "FADV_RANDOM";
+        case RA_WILLNEED: return "FADV_WILLNEED";
+        case RA_NOREUSE: return "FADV_NOREUSE";
+        case RA_EXPLICIT: return "readahead(2)";
+        case RA_DROP_BEHIND: return "DONTNEED behind";
+        default: return "unknown";
+    }
+}
+
+/* 逐出文件的页缓存，返回逐出后仍驻留的页数 */
+static long ra_evict(const char *path, size_t size) {
+    int fd = open(path, O_RDWR);
+    if (fd < 0) return -1;
+    fdatasync(fd);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    long resident = page_cache_resident(fd, 0, size);
+    close(fd);
+    return resident;
+}
+
+/* 依次尝试 BDI、设备和所属整盘的 read_ahead_kb，都读不到返回 -1 */
+static long ra_configured_kb(const char *path) {
+    struct stat st;
+    if (stat(path, &st) != 0) return -1;
+    unsigned int maj = major(st.st_dev), min = minor(st.st_dev);
+    const char *fmts[] = {
+        "/sys/class/bdi/%u:%u/read_ahead_kb",
+        "/sys/dev/block/%u:%u/queue/read_ahead_kb",
+        "/sys/dev/block/%u:%u/../queue/read_ahead_kb",
+    };
+    for (size_t i = 0; i < sizeof(fmts) / sizeof(fmts[0]); i++) {
+        char sys[MAX_PATH_LEN];
+        snprintf(sys, sizeof(sys), fmts[i], maj, min);
+        FILE *fp = fopen(sys, "r");
+        if (!fp) continue;
+        long kb = -1;
+        if (fscanf(fp, "%ld", &kb) != 1) kb = -1;
+        fclose(fp);
+        if (kb >= 0) return kb;
+    }
+    return -1;
+}
+
+static int ra_apply_advice(int fd, enum ra_variant v, size_t window) {
+    switch (v) {
+        case RA_SEQUENTIAL:
+            return posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+        case RA_RANDOM:
+            return posix_fadvise(fd, 0, 0, POSIX_FADV_RANDOM);
+        case RA_WILLNEED:
+            return posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+        case RA_NOREUSE:
+            return posix_fadvise(fd, 0, 0, POSIX_FADV_NOREUSE);
+        case RA_EXPLICIT:
+            return readahead(fd, 0, window) == 0 ? 0 : errno;
+        default:
+            return 0;
+    }
+}
+
+static void ra_run_variant(const char *path, enum ra_variant v, size_t size,
+                           const struct fstest_config *cfg, char *buf,
+                           uint64_t *lat) {
+    const char *name = ra_variant_name(v);
+    long left = ra_evict(path, size);
+    if (left < 0) {
+        TEST_FAIL(name, strerror(errno));
+        return;
+    }
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        TEST_FAIL(name, strerror(errno));
+        return;
+    }
+
+    size_t io = cfg->io_size;
+    size_t window = cfg->ra_window;
+    size_t reads = size / io;
+    struct lat_hist hist;
+    struct timespec start, end;
+    uint64_t t0, t1;
+    off_t ra_next = (off_t)window;
+    off_t dropped = 0;
+    int errors = 0;
+
+    lat_hist_init(&hist);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    int ret = ra_apply_advice(fd, v, window);
+    if (ret != 0) {
+        TEST_SKIP(name, strerror(ret));
+        close(fd);
+        return;
+    }
+    for (size_t i = 0; i < reads; i++) {
+        off_t off = (off_t)(i * io);
+        if (v == RA_EXPLICIT && off + (off_t)window / 2 >= ra_next &&
+            ra_next < (off_t)size) {
+            readahead(fd, ra_next, window);
+            ra_next += window;
+        }
+        t0 = timer_now();
+        ssize_t r = pread(fd, buf, io, off);
+        t1 = timer_now();
+        if (r != (ssize_t)io) {
+            errors++;
+            lat[i] = 0;
+            continue;
+        }
+        lat[i] = timer_diff_ns(t0, t1);
+        lat_hist_add(&hist, lat[i]);
+        if (v == RA_DROP_BEHIND && off + (off_t)io - dropped >=
+                                        (off_t)window) {
+            posix_fadvise(fd, dropped, off + io - dropped,
+                          POSIX_FADV_DONTNEED);
+            dropped = off + io;
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    uint64_t slow_ns = lat_hist_percentile(&hist, 50.0) * RA_SLOW_FACTOR;
+    long slow = 0;
+    for (size_t i = 0; i < reads; i++) {
+        if (lat[i] > slow_ns) slow++;
+    }
+    long resident = page_cache_resident(fd, 0, size);
+    long pages = (size + sysconf(_SC_PAGESIZE) - 1) / sysconf(_SC_PAGESIZE);
+    double secs =
+        calculate_time_diff_ns(&start, &end) / (double)NANOS_PER_SECOND;
+    char gap[32] = "-";
+    if (slow > 0) {
+        snprintf(gap, sizeof(gap), "%.0f KB",
+                 size / (double)slow / _1KB_BYTES);
+    }
+    printf("  %-16s | %9.2f MB/s | avg %7.1f us | p99 %8.1f us | slow %6ld "
+           "| gap %9s | resident %5.1f%%%s\n",
+           name, secs > 0.0 ? hist.count * io / (double)_1MB_BYTES / secs
+                            : 0.0,
+           hist.count ? hist.sum_ns / 1000.0 / hist.count : 0.0,
+           lat_hist_percentile(&hist, 99.0) / 1000.0, slow, gap,
+           resident >= 0 ? resident * 100.0 / pages : 0.0,
+           left * 20 > pages ? "  (eviction incomplete)" : "");
+    if (errors > 0) {
+        char msg[64];
+        snprintf(msg, sizeof(msg), "%d failed reads", errors);
+        TEST_FAIL(name, msg);
+    }
+    close(fd);
+}
+
+/* 冷缓存顺序读，用 mincore 观察读指针前方已预读的范围 */
+static void ra_probe(const char *path, size_t size,
+                     const struct fstest_config *cfg, char *buf) {
+    printf("\n  --- 预读窗口探测 (Readahead Window Probe) ---\n");
+    long kb = ra_configured_kb(path);
+    if (kb >= 0) {
+        printf("  %-16s | %ld KB\n", "read_ahead_kb", kb);
+    } else {
+        printf("  %-16s | n/a\n", "read_ahead_kb");
+    }
+    if (ra_evict(path, size) < 0) {
+        TEST_FAIL("readahead probe", strerror(errno));
+        return;
+    }
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        TEST_FAIL("readahead probe", strerror(errno));
+        return;
+    }
+
+    long page = sysconf(_SC_PAGESIZE);
+    size_t io = cfg->io_size;
+    size_t span = size < RA_PROBE_SPAN ? size : RA_PROBE_SPAN;
+    if (pread(fd, buf, io, 0) != (ssize_t)io) {
+        TEST_FAIL("readahead probe", "first read failed");
+        close(fd);
+        return;
+    }
+    long initial = page_cache_resident(fd, 0, span);
+
+    /* 读到文件一半为止，每 1MB 采样一次前方驻留量 */
+    long ahead_max = 0;
+    size_t step = io < _1MB_BYTES ? _1MB_BYTES / io : 1;
+    size_t reads = size / 2 / io;
+    for (size_t i = 1; i < reads; i++) {
+        off_t off = (off_t)(i * io);
+        if (pread(fd, buf, io, off) != (ssize_t)io) break;
+        if (i % step != 0) continue;
+        size_t len = size - (off + io) < span ? size - (off + io) : span;
+        long ahead = page_cache_resident(fd, off + io, len);
+        if (ahead > ahead_max) ahead_max = ahead;
+    }
+    close(fd);
+
+    if (initial < 0) {
+        TEST_SKIP("readahead probe", "mincore not supported");
+        return;
+    }
+    printf("  %-16s | %ld KB (resident after first %zu B read)\n",
+           "initial window", initial * page / _1KB_BYTES, io);
+    printf("  %-16s | %ld KB (max resident ahead of reader)\n",
+           "steady window", ahead_max * page / _1KB_BYTES);
+}
+
+void run_readahead_tests(const struct fstest_config *cfg) {
+    printf("\n");
+    printf("========================================\n");
+    printf("  24. 预读与 fadvise 效果 (Readahead & fadvise)\n");
+    printf("========================================\n");
+
+    size_t io = cfg->io_size;
+    size_t size = cfg->file_size / io * io;
+    if (size < io) size = io;
+    printf("  File:         %zu MB | read size %zu B | window %zu KB\n",
+           size / _1MB_BYTES, io, cfg->ra_window / _1KB_BYTES);
+
+    char path[MAX_PATH_LEN];
+    make_test_path(path, sizeof(path), cfg->dir, "readahead.dat");
+    char *buf = malloc(io);
+    uint64_t *lat = calloc(size / io, sizeof(uint64_t));
+    if (!buf || !lat) {
+        TEST_FAIL("readahead", strerror(ENOMEM));
+        goto out;
+    }
+    if (timed_io_prefill(path, size) != 0) {
+        TEST_FAIL("readahead prefill", strerror(errno));
+        goto out;
+    }
+
+    printf("\n  --- 冷缓存顺序读 (Cold Sequential Read) ---\n");
+    for (int v = 0; v < RA_COUNT; v++) {
+        ra_run_variant(path, (enum ra_variant)v, size, cfg, buf, lat);
+        fflush(stdout);
+    }
+    ra_probe(path, size, cfg, buf);
+
+out:
+    free(lat);
+    free(buf);
+    unlink(path);
+    printf("--- 预读与 fadvise 效果测试完成 ---\n");
+}
@@ -0,0 +1,14 @@
+/*
+    预读与 fadvise 效果模块
+    冷缓存下对比内核默认预读、各种 posix_fadvise 建议、显式 readahead(2)
+    和读后丢弃的缓冲顺序读性能，并探测实际生效的预读窗口
+*/
+
+#ifndef FSTEST_TEST_READAHEAD_H
+#define FSTEST_TEST_READAHEAD_H
+
+#include "common.h"
+
+void run_readahead_tests(const struct fstest_config *cfg);
+
+#endif /* FSTEST_TEST_READAHEAD_H */
@@ -0,0 +1,267 @@
+/*
+    原子替换基准模块实现
+    每个线程反复用 -s 大小的新内容持久地替换自己的目标文件 (同一目录下)
+    替换方式：
+    - rename:   写临时文件 -> fsync -> rename 覆盖目标 -> fsync 父目录
+    - O_TMPFILE: O_TMPFILE 匿名文件 -> fsync -> linkat 命名 -> rename
+                 覆盖目标 -> fsync 父目录
+    - exchange: 写暂存文件 -> fsync -> renameat2(RENAME_EXCHANGE) 与目标
+                互换 -> fsync 父目录 (旧内容留在暂存文件中供下次复用)
+    单线程和 -j 线程各运行一次，报告每秒替换次数和每个步骤的延迟分解
+*/
+
+#include "test_replace.h"
+
+#include "timer.h"
+
+#define REPLACE_MAX_STEPS 8
+
+enum replace_variant { REPLACE_RENAME, REPLACE_TMPFILE, REPLACE_EXCHANGE };
+
+static const char *const replace_steps[][REPLACE_MAX_STEPS] = {
+    [REPLACE_RENAME] = {"open tmp", "write", "fsync", "close", "rename",
+                        "fsync dir", NULL},
+    [REPLACE_TMPFILE] = {"open O_TMPFILE", "write", "fsync", "linkat",
+                         "close", "rename", "fsync dir", NULL},
+    [REPLACE_EXCHANGE] = {"open staging", "write", "fsync", "close",
+                          "RENAME_EXCHANGE", "fsync dir", NULL},
+};
+
+static const char *replace_variant_name(enum replace_variant v) {
+    switch (v) {
+        case REPLACE_RENAME: return "tmp + rename";
+        case REPLACE_TMPFILE: return "O_TMPFILE + linkat";
+        case REPLACE_EXCHANGE: return "RENAME_EXCHANGE";
+        default: return "unknown";
+    }
+}
+
+struct replace_job_args {
+    int dirfd;
+    int thread_id;
+    int ops;
+    size_t io_size;
+    enum replace_variant variant;
+    struct lat_hist steps[REPLACE_MAX_STEPS];
+    struct lat_hist total;
+    int errors;
+    int first_errno; /* 第一次失败的 errno */
+    int unsupported; /* 不支持时记录 errno */
+};
+
+/* 记录从 *mark 到现在的耗时为第 step 步，并推进 *mark */
+static void step_done(struct replace_job_args *a, int step, uint64_t *mark) {
+    uint64_t now = timer_now();
+    lat_hist_add(&a->steps[step], timer_diff_ns(*mark, now));
+    *mark = now;
+}
+
+static int is_replace_unsupported(int err) {
+    return err == EOPNOTSUPP || err == ENOTSUP || err == EINVAL ||
+           err == EISDIR || err == ENOSYS;
+}
+
+static int replace_once(struct replace_job_args *a, const char *buf) {
+    char target[64], tmp[64], fdpath[64];
+    uint64_t mark;
+    int fd, s = 0;
+
+    snprintf(target, sizeof(target), "replace_%d.dat", a->thread_id);
+    snprintf(tmp, sizeof(tmp), "replace_%d.%s", a->thread_id,
+             a->variant == REPLACE_EXCHANGE ? "new" : "tmp");
+    mark = timer_now();
+
+    if (a->variant == REPLACE_TMPFILE) {
+        fd = openat(a->dirfd, ".", O_TMPFILE | O_WRONLY, 0644);
+    } else {
+        fd = openat(a->dirfd, tmp, O_CREAT | O_WRONLY | O_TRUNC, 0644);
+    }
+    if (fd < 0) return -1;
+    step_done(a, s++, &mark);
+
+    if (write(fd, buf, a->io_size) != (ssize_t)a->io_size) goto fail;
+    step_done(a, s++, &mark);
+    if (fsync(fd) != 0) goto fail;
+    step_done(a, s++, &mark);
+
+    if (a->variant == REPLACE_TMPFILE) {
+        snprintf(fdpath, sizeof(fdpath), "/proc/self/fd/%d", fd);
+        if (linkat(AT_FDCWD, fdpath, a->dirfd, tmp, AT_SYMLINK_FOLLOW) != 0) {
+            goto fail;
+        }
+        step_done(a, s++, &mark);
+    }
+    close(fd);
+    step_done(a, s++, &mark);
+
+    if (a->variant == REPLACE_EXCHANGE) {
+        if (renameat2(a->dirfd, tmp, a->dirfd, target, RENAME_EXCHANGE) != 0) {
+            return -1;
+        }
+    } else if (renameat(a->dirfd, tmp, a->dirfd, target) != 0) {
+        return -1;
+    }
+    step_done(a, s++, &mark);
+
+    if (fsync(a->dirfd) != 0) return -1;
+    step_done(a, s++, &mark);
+    return 0;
+
+fail:
+    close(fd);
+    return -1;
+}
+
+static void *replace_job(void *arg) {
+    struct replace_job_args *a = (struct replace_job_args *)arg;
+    char *buf = malloc(a->io_size);
+    uint64_t t0, t1;
+
+    for (int i = 0; i < REPLACE_MAX_STEPS; i++) {
+        lat_hist_init(&a->steps[i]);
+    }
+    lat_hist_init(&a->total);
+    if (!buf) {
+        a->errors++;
+        a->first_errno = ENOMEM;
+        return NULL;
+    }
+    fill_rand_buffer(buf, a->io_size);
+
+    for (int i = 0; i < a->ops; i++) {
+        t0 = timer_now();
+        if (replace_once(a, buf) != 0) {
+            if (is_replace_unsupported(errno)) {
+                a->unsupported = errno;
+                break;
+            }
+            if (a->errors++ == 0) a->first_errno = errno;
+            continue;
+        }
+        t1 = timer_now();
+        lat_hist_add(&a->total, timer_diff_ns(t0, t1));
+    }
+    free(buf);
+    return NULL;
+}
+
+static void run_replace_variant(const struct fstest_config *cfg, int dirfd,
+                                enum replace_variant variant, int nthreads) {
+    pthread_t *threads = malloc(nthreads * sizeof(pthread_t));
+    struct replace_job_args *args =
+        calloc(nthreads, sizeof(struct replace_job_args));
+
+    /* 预先建立目标文件；暂存文件由 replace_once 每次自行创建 */
+    for (int i = 0; i < nthreads; i++) {
+        char name[64];
+        snprintf(name, sizeof(name), "replace_%d.dat", i);
+        int fd = openat(dirfd, name, O_CREAT | O_WRONLY | O_TRUNC, 0644);
+        if (fd >= 0) close(fd);
+    }
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < nthreads; i++) {
+        args[i].dirfd = dirfd;
+        args[i].thread_id = i;
+        args[i].ops = cfg->replace_ops;
+        args[i].io_size = cfg->io_size;
+        args[i].variant = variant;
+        pthread_create(&threads[i], NULL, replace_job, &args[i]);
+    }
+    for (int i = 0; i < nthreads; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    struct lat_hist total, steps[REPLACE_MAX_STEPS];
+    lat_hist_init(&total);
+    for (int s = 0; s < REPLACE_MAX_STEPS; s++) {
+        lat_hist_init(&steps[s]);
+    }
+    int errors = 0, first_errno = 0, unsupported = 0;
+    for (int i = 0; i < nthreads; i++) {
+        lat_hist_merge(&total, &args[i].total);
+        for (int s = 0; s < REPLACE_MAX_STEPS; s++) {
+            lat_hist_merge(&steps[s], &args[i].steps[s]);
+        }
+        if (errors == 0 && args[i].errors > 0) {
+            first_errno = args[i].first_errno;
+        }
+        errors += args[i].errors;
+        if (args[i].unsupported) unsupported = args[i].unsupported;
+    }
+
+    if (unsupported && total.count == 0) {
+        TEST_SKIP(replace_variant_name(variant), strerror(unsupported));
+    } else {
+        double duration_s =
+            calculate_time_diff_ns(&start, &end) / (double)NANOS_PER_SECOND;
+        char lat[160];
+        lat_hist_format(&total, lat, sizeof(lat));
+        printf("  %-20s | %2d jobs | %7.0f replaces/s | %s\n",
+               replace_variant_name(variant), nthreads,
+               duration_s > 0.0 ? total.count / duration_s : 0.0, lat);
+        for (int s = 0; replace_steps[variant][s]; s++) {
+            printf("      %-18s avg %9.1f us | p99 %9.1f us\n",
+                   replace_steps[variant][s],
+                   steps[s].count ? steps[s].sum_ns / 1000.0 / steps[s].count
+                                  : 0.0,
+                   lat_hist_percentile(&steps[s], 99.0) / 1000.0);
+        }
+    }
+    if (errors > 0) {
+        char msg[128];
+        snprintf(msg, sizeof(msg), "%d failed replaces: %s", errors,
+                 strerror(first_errno));
+        TEST_FAIL(replace_variant_name(variant), msg);
+    }
+
+    for (int i = 0; i < nthreads; i++) {
+        char name[64];
+        snprintf(name, sizeof(name), "replace_%d.dat", i);
+        unlinkat(dirfd, name, 0);
+        snprintf(name, sizeof(name), "replace_%d.tmp", i);
+        unlinkat(dirfd, name, 0);
+        snprintf(name, sizeof(name), "replace_%d.new", i);
+        unlinkat(dirfd, name, 0);
+    }
+    free(args);
+    free(threads);
+}
+
+void run_replace_tests(const struct fstest_config *cfg) {
+    printf("\n");
+    printf("========================================\n");
+    printf("  15. 原子替换基准 (Atomic Replace)\n");
+    printf("========================================\n");
+    printf("  Payload:      %zu bytes\n", cfg->io_size);
+    printf("  Replaces:     %d per thread\n", cfg->replace_ops);
+
+    char dir[MAX_PATH_LEN];
+    make_test_path(dir, sizeof(dir), cfg->dir, "replace");
+    if (mkdir(dir, 0755) != 0 && errno != EEXIST) {
+        TEST_FAIL("atomic replace", strerror(errno));
+        return;
+    }
+    int dirfd = open(dir, O_RDONLY | O_DIRECTORY);
+    if (dirfd < 0) {
+        TEST_FAIL("atomic replace", strerror(errno));
+        rmdir(dir);
+        return;
+    }
+
+    int counts[2] = {1, cfg->jobs};
+    int count_n = cfg->jobs > 1 ? 2 : 1;
+    for (int c = 0; c < count_n; c++) {
+        printf("\n  --- %d 线程 (%d jobs) ---\n", counts[c], counts[c]);
+        for (int v = REPLACE_RENAME; v <= REPLACE_EXCHANGE; v++) {
+            run_replace_variant(cfg, dirfd, (enum replace_variant)v,
+                                counts[c]);
+        }
+    }
+
+    close(dirfd);
+    remove_dir_recursive(dir);
+    printf("--- 原子替换基准完成 ---\n");
+}
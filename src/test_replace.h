@@ -0,0 +1,13 @@
+/*
+    原子替换基准模块
+    比较几种持久化原子替换文件内容的惯用方式的开销
+*/
+
+#ifndef FSTEST_TEST_REPLACE_H
+#define FSTEST_TEST_REPLACE_H
+
+#include "common.h"
+
+void run_replace_tests(const struct fstest_config *cfg);
+
+#endif /* FSTEST_TEST_REPLACE_H */
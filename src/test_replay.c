@@ -0,0 +1,358 @@
+/*
+    跟踪回放模块实现
+    把 --trace 指定的二进制跟踪 (或由 --strace 转换得到的跟踪) 在测试目录下
+    重新执行：
+    - 每个 file_id 映射为 replay/f<id>，回放前按跟踪中读过的最大范围预填数据
+    - 原始线程 t 由回放线程 t % N 执行 (N 取 -j)，同一原始线程内保持顺序
+    - 默认按原始时间间隔发起 (报告相对计划的发起滞后)，--replay-afap 时
+      不等待、尽快发起
+    - 每个回放线程各自持有 fd，读写前若文件未打开则隐式打开
+    报告每种操作的次数、错误、数据量和延迟分位数以及总吞吐
+*/
+
+#include "test_replay.h"
+
+#include "timer.h"
+#include "trace.h"
+
+#define REPLAY_MAX_BUF (16 * _1MB_BYTES)
+
+struct replay_job_args {
+    const struct trace *trace;
+    const char *dir;
+    int thread_id;
+    int nthreads;
+    int afap;
+    struct timespec start;     /* 所有线程共同的回放起点 */
+    size_t buf_size;
+    struct lat_hist lat[TRACE_OP_COUNT];
+    uint64_t bytes[TRACE_OP_COUNT];
+    long errors[TRACE_OP_COUNT];
+    struct lat_hist lag;       /* 实际发起时刻落后于计划的时间 */
+};
+
+static void replay_file_path(char *buf, size_t size, const char *dir,
+                             uint32_t id) {
+    snprintf(buf, size, "%s/f%u", dir, id);
+}
+
+static int replay_fd(struct replay_job_args *a, int *fds, uint32_t id) {
+    if (fds[id] < 0) {
+        char path[MAX_PATH_LEN];
+        replay_file_path(path, sizeof(path), a->dir, id);
+        fds[id] = open(path, O_RDWR | O_CREAT, 0644);
+    }
+    return fds[id];
+}
+
+/* 大于缓冲区的读写分块执行，返回总字节数或 -1 */
+static ssize_t replay_rw(int fd, char *buf, size_t buf_size, size_t len,
+                         off_t off, int is_write) {
+    size_t done = 0;
+    while (done < len) {
+        size_t chunk = len - done < buf_size ? len - done : buf_size;
+        ssize_t ret = is_write ? pwrite(fd, buf, chunk, off + done)
+                               : pread(fd, buf, chunk, off + done);
+        if (ret < 0) return -1;
+        if (ret == 0) break;
+        done += ret;
+    }
+    return (ssize_t)done;
+}
+
+static void *replay_job(void *arg) {
+    struct replay_job_args *a = (struct replay_job_args *)arg;
+    const struct trace *t = a->trace;
+    int *fds = malloc(t->file_count * sizeof(int));
+    char *buf = malloc(a->buf_size);
+    char path[MAX_PATH_LEN];
+    struct timespec target, now;
+    uint64_t t0, t1;
+
+    for (int i = 0; i < TRACE_OP_COUNT; i++) lat_hist_init(&a->lat[i]);
+    lat_hist_init(&a->lag);
+    if (!fds || !buf) {
+        a->errors[TRACE_OP_OPEN]++;
+        free(fds);
+        free(buf);
+        return NULL;
+    }
+    for (uint32_t i = 0; i < t->file_count; i++) fds[i] = -1;
+    fill_rand_buffer(buf, a->buf_size);
+
+    for (size_t i = 0; i < t->count; i++) {
+        const struct trace_record *r = &t->records[i];
+        if (r->thread % a->nthreads != a->thread_id) continue;
+
+        if (!a->afap) {
+            uint64_t ns = a->start.tv_nsec + r->ts_ns;
+            target.tv_sec = a->start.tv_sec + ns / NANOS_PER_SECOND;
+            target.tv_nsec = ns % NANOS_PER_SECOND;
+            clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &target, NULL);
+        }
+        ssize_t ret = 0;
+        int fd = -1;
+        if (r->op != TRACE_OP_OPEN && r->op != TRACE_OP_CLOSE &&
+            r->op != TRACE_OP_UNLINK && r->op != TRACE_OP_STAT) {
+            fd = replay_fd(a, fds, r->file_id);
+        }
+        replay_file_path(path, sizeof(path), a->dir, r->file_id);
+
+        /* 滞后要和计划时刻对照，仍取单调时钟；单次延迟用 timer */
+        if (!a->afap) clock_gettime(CLOCK_MONOTONIC, &now);
+        t0 = timer_now();
+        switch (r->op) {
+            case TRACE_OP_OPEN:
+                if (fds[r->file_id] >= 0) close(fds[r->file_id]);
+                fds[r->file_id] =
+                    open(path, O_RDWR | O_CREAT |
+                                   (r->flags & TRACE_F_TRUNC ? O_TRUNC : 0),
+                         0644);
+                ret = fds[r->file_id];
+                break;
+            case TRACE_OP_CLOSE:
+                if (fds[r->file_id] < 0) continue;
+                ret = close(fds[r->file_id]);
+                fds[r->file_id] = -1;
+                break;
+            case TRACE_OP_READ:
+            case TRACE_OP_WRITE:
+                ret = fd < 0 ? -1
+                             : replay_rw(fd, buf, a->buf_size, r->length,
+                                         (off_t)r->offset,
+                                         r->op == TRACE_OP_WRITE);
+                break;
+            case TRACE_OP_FSYNC:
+                ret = fd < 0 ? -1 : fsync(fd);
+                break;
+            case TRACE_OP_FDATASYNC:
+                ret = fd < 0 ? -1 : fdatasync(fd);
+                break;
+            case TRACE_OP_TRUNCATE:
+                ret = fd < 0 ? -1 : ftruncate(fd, (off_t)r->offset);
+                break;
+            case TRACE_OP_UNLINK:
+                ret = unlink(path);
+                break;
+            case TRACE_OP_STAT: {
+                struct stat st;
+                ret = stat(path, &st);
+                break;
+            }
+        }
+        t1 = timer_now();
+
+        if (!a->afap) {
+            int64_t lag = calculate_time_diff_ns(&target, &now);
+            lat_hist_add(&a->lag, lag > 0 ? (uint64_t)lag : 0);
+        }
+        if (ret < 0) {
+            a->errors[r->op]++;
+            continue;
+        }
+        lat_hist_add(&a->lat[r->op], timer_diff_ns(t0, t1));
+        if (r->op == TRACE_OP_READ || r->op == TRACE_OP_WRITE) {
+            a->bytes[r->op] += (uint64_t)ret;
+        }
+    }
+
+    for (uint32_t i = 0; i < t->file_count; i++) {
+        if (fds[i] >= 0) close(fds[i]);
+    }
+    free(fds);
+    free(buf);
+    return NULL;
+}
+
+/* 按跟踪中读过的最大范围预填文件，使回放的读取命中真实数据 */
+static int replay_prefill(const struct trace *t, const char *dir,
+                          uint64_t *total_out) {
+    uint64_t *extent = calloc(t->file_count, sizeof(uint64_t));
+    char *buf = malloc(_1MB_BYTES);
+    char path[MAX_PATH_LEN];
+    int ret = 0;
+
+    *total_out = 0;
+    if (!extent || !buf) {
+        free(extent);
+        free(buf);
+        return -1;
+    }
+    for (size_t i = 0; i < t->count; i++) {
+        const struct trace_record *r = &t->records[i];
+        uint64_t end = r->offset + r->length;
+        if (r->op == TRACE_OP_READ && end > extent[r->file_id]) {
+            extent[r->file_id] = end;
+        }
+    }
+    fill_rand_buffer(buf, _1MB_BYTES);
+    for (uint32_t id = 0; id < t->file_count && ret == 0; id++) {
+        replay_file_path(path, sizeof(path), dir, id);
+        int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) {
+            ret = -1;
+            break;
+        }
+        for (uint64_t off = 0; off < extent[id]; off += _1MB_BYTES) {
+            size_t len = extent[id] - off < (uint64_t)_1MB_BYTES
+                             ? (size_t)(extent[id] - off)
+                             : _1MB_BYTES;
+            if (pwrite(fd, buf, len, (off_t)off) != (ssize_t)len) {
+                ret = -1;
+                break;
+            }
+        }
+        *total_out += extent[id];
+        close(fd);
+    }
+    free(extent);
+    free(buf);
+    return ret;
+}
+
+void run_replay_tests(const struct fstest_config *cfg) {
+    printf("\n");
+    printf("========================================\n");
+    printf("  18. 跟踪回放 (Trace Replay)\n");
+    printf("========================================\n");
+
+    struct trace trace;
+    if (strlen(cfg->strace_file) > 0) {
+        long skipped = 0;
+        if (trace_from_strace(cfg->strace_file, &trace, &skipped) != 0) {
+            TEST_FAIL("strace convert", strerror(errno));
+            return;
+        }
+        printf("  Strace:       %s (%zu records, %ld lines ignored)\n",
+               cfg->strace_file, trace.count, skipped);
+        if (trace_save(cfg->trace_file, &trace) != 0) {
+            TEST_FAIL("trace save", strerror(errno));
+            trace_free(&trace);
+            return;
+        }
+    } else if (trace_load(cfg->trace_file, &trace) != 0) {
+        TEST_FAIL("trace load", strerror(errno));
+        return;
+    }
+    if (trace.count == 0) {
+        TEST_SKIP("replay", "trace has no records");
+        trace_free(&trace);
+        return;
+    }
+
+    uint32_t max_len = 0;
+    for (size_t i = 0; i < trace.count; i++) {
+        if (trace.records[i].length > max_len) {
+            max_len = trace.records[i].length;
+        }
+    }
+    size_t buf_size = max_len < 4096 ? 4096 : max_len;
+    if (buf_size > (size_t)REPLAY_MAX_BUF) buf_size = REPLAY_MAX_BUF;
+    int nthreads = cfg->jobs;
+
+    printf("  Trace:        %s\n", cfg->trace_file);
+    printf("  Records:      %zu (%u files, %u threads, %.3f s)\n",
+           trace.count, trace.file_count, trace.thread_count,
+           trace.records[trace.count - 1].ts_ns / (double)NANOS_PER_SECOND);
+    printf("  Replay:       %d threads, %s\n", nthreads,
+           cfg->replay_afap ? "as fast as possible" : "original timing");
+
+    char dir[MAX_PATH_LEN];
+    make_test_path(dir, sizeof(dir), cfg->dir, "replay");
+    if (mkdir(dir, 0755) != 0 && errno != EEXIST) {
+        TEST_FAIL("replay", strerror(errno));
+        trace_free(&trace);
+        return;
+    }
+    uint64_t prefill = 0;
+    if (replay_prefill(&trace, dir, &prefill) != 0) {
+        TEST_FAIL("replay prefill", strerror(errno));
+        remove_dir_recursive(dir);
+        trace_free(&trace);
+        return;
+    }
+    printf("  Prefill:      %.1f MB\n", prefill / (double)_1MB_BYTES);
+
+    pthread_t *threads = malloc(nthreads * sizeof(pthread_t));
+    struct replay_job_args *args =
+        calloc(nthreads, sizeof(struct replay_job_args));
+
+    /* 按原始时间回放时起点稍微推后，让所有线程在第一条记录之前就绪 */
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    if (!cfg->replay_afap) {
+        start.tv_nsec += 20 * 1000 * 1000;
+        if (start.tv_nsec >= NANOS_PER_SECOND) {
+            start.tv_sec++;
+            start.tv_nsec -= NANOS_PER_SECOND;
+        }
+    }
+    for (int i = 0; i < nthreads; i++) {
+        args[i].trace = &trace;
+        args[i].dir = dir;
+        args[i].thread_id = i;
+        args[i].nthreads = nthreads;
+        args[i].afap = cfg->replay_afap;
+        args[i].start = start;
+        args[i].buf_size = buf_size;
+        pthread_create(&threads[i], NULL, replay_job, &args[i]);
+    }
+    for (int i = 0; i < nthreads; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    struct lat_hist lat[TRACE_OP_COUNT], lag;
+    uint64_t bytes[TRACE_OP_COUNT] = {0}, total_ops = 0;
+    long errors[TRACE_OP_COUNT] = {0}, total_errors = 0;
+    for (int op = 0; op < TRACE_OP_COUNT; op++) lat_hist_init(&lat[op]);
+    lat_hist_init(&lag);
+    for (int i = 0; i < nthreads; i++) {
+        for (int op = 0; op < TRACE_OP_COUNT; op++) {
+            lat_hist_merge(&lat[op], &args[i].lat[op]);
+            bytes[op] += args[i].bytes[op];
+            errors[op] += args[i].errors[op];
+        }
+        lat_hist_merge(&lag, &args[i].lag);
+    }
+
+    double duration_s =
+        calculate_time_diff_ns(&start, &end) / (double)NANOS_PER_SECOND;
+    printf("\n  %-9s | %9s | %6s | %10s | latency\n", "op", "count", "errors",
+           "MB");
+    for (int op = 0; op < TRACE_OP_COUNT; op++) {
+        if (lat[op].count == 0 && errors[op] == 0) continue;
+        char buf[160];
+        lat_hist_format(&lat[op], buf, sizeof(buf));
+        printf("  %-9s | %9llu | %6ld | %10.1f | %s\n",
+               trace_op_name((enum trace_op)op),
+               (unsigned long long)lat[op].count, errors[op],
+               bytes[op] / (double)_1MB_BYTES, buf);
+        total_ops += lat[op].count;
+        total_errors += errors[op];
+    }
+    printf("\n  Duration:     %.3f s\n", duration_s);
+    if (duration_s > 0.0) {
+        printf("  Throughput:   %.0f ops/s | read %.2f MB/s | "
+               "write %.2f MB/s\n",
+               total_ops / duration_s,
+               bytes[TRACE_OP_READ] / (double)_1MB_BYTES / duration_s,
+               bytes[TRACE_OP_WRITE] / (double)_1MB_BYTES / duration_s);
+    }
+    if (!cfg->replay_afap) {
+        char buf[160];
+        lat_hist_format(&lag, buf, sizeof(buf));
+        printf("  Issue lag:    %s\n", buf);
+    }
+    if (total_errors > 0) {
+        char msg[64];
+        snprintf(msg, sizeof(msg), "%ld replayed ops failed", total_errors);
+        TEST_FAIL("replay", msg);
+    }
+
+    free(args);
+    free(threads);
+    remove_dir_recursive(dir);
+    trace_free(&trace);
+    printf("--- 跟踪回放完成 ---\n");
+}
@@ -0,0 +1,13 @@
+/*
+    跟踪回放模块
+    按原始时间间隔或尽快回放二进制 I/O 跟踪，报告每种操作的延迟和吞吐
+*/
+
+#ifndef FSTEST_TEST_REPLAY_H
+#define FSTEST_TEST_REPLAY_H
+
+#include "common.h"
+
+void run_replay_tests(const struct fstest_config *cfg);
+
+#endif /* FSTEST_TEST_REPLAY_H */
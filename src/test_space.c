@@ -0,0 +1,493 @@
+/*
+    空间管理基准模块实现
+    以 --falloc-size 为粒度在 -f 大小的文件上依次执行：
+    - fallocate 默认模式 (扩展文件) / KEEP_SIZE (EOF 之后预分配)
+    - ZERO_RANGE / PUNCH_HOLE (隔块打洞) / COLLAPSE_RANGE
+    - ftruncate 逐步收缩到 0 再逐步扩展
+    - 在 --sparse-size 大小的稀疏文件中做 --sparse-writes 次随机小写 (-s)
+    - 按 --sparse-map 的数据 / 空洞模式构造 --sparse-extents 段稀疏文件，
+      对比 SEEK_DATA / SEEK_HOLE 与 FIEMAP 遍历整个映射的耗时，以及跳过
+      空洞读取与全量读取的耗时 (各取 -i 次的平均)
+    每个阶段报告单次调用延迟、吞吐，以及阶段结束后 FIEMAP 得到的 extent 数
+*/
+
+#include "test_space.h"
+
+#include "timer.h"
+
+#include <linux/falloc.h>
+#include <linux/fiemap.h>
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+
+#define SPARSE_MAP_MAX 16
+#define FIEMAP_BATCH 256
+#define SPARSE_READ_BUF _1MB_BYTES
+
+enum space_op {
+    SPACE_FALLOC,
+    SPACE_FALLOC_KEEP,
+    SPACE_ZERO_RANGE,
+    SPACE_PUNCH_HOLE,
+    SPACE_COLLAPSE,
+    SPACE_TRUNC_SHRINK,
+    SPACE_TRUNC_GROW,
+};
+
+static const char *space_op_name(enum space_op op) {
+    switch (op) {
+        case SPACE_FALLOC: return "fallocate";
+        case SPACE_FALLOC_KEEP: return "fallocate KEEP_SIZE";
+        case SPACE_ZERO_RANGE: return "ZERO_RANGE";
+        case SPACE_PUNCH_HOLE: return "PUNCH_HOLE";
+        case SPACE_COLLAPSE: return "COLLAPSE_RANGE";
+        case SPACE_TRUNC_SHRINK: return "ftruncate shrink";
+        case SPACE_TRUNC_GROW: return "ftruncate grow";
+        default: return "unknown";
+    }
+}
+
+static int is_space_op_unsupported(int err) {
+    return err == EOPNOTSUPP || err == ENOTSUP || err == ENOSYS;
+}
+
+static void print_extents(int fd) {
+    long extents = fiemap_extent_count(fd);
+    if (extents < 0) {
+        printf(" | extents %8s\n", "n/a");
+    } else {
+        printf(" | extents %8ld\n", extents);
+    }
+}
+
+/* 输出稀疏文件实际占用的空间和 extent 数 */
+static void print_allocated(int fd) {
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        printf("  %-20s | allocated %s", "sparse file", "n/a");
+    } else {
+        printf("  %-20s | allocated %.1f MB", "sparse file",
+               st.st_blocks * 512.0 / _1MB_BYTES);
+    }
+    print_extents(fd);
+}
+
+/* 对第 i 次调用执行一次空间操作，chunks 为文件当前的块数 */
+static int do_space_op(int fd, enum space_op op, size_t chunk, size_t chunks,
+                       size_t i, unsigned int *seed) {
+    off_t off;
+    switch (op) {
+        case SPACE_FALLOC:
+            return fallocate(fd, 0, (off_t)(i * chunk), chunk);
+        case SPACE_FALLOC_KEEP:
+            /* 在 EOF 之后的区域预分配，不改变文件大小 */
+            return fallocate(fd, FALLOC_FL_KEEP_SIZE,
+                             (off_t)((chunks + i) * chunk), chunk);
+        case SPACE_ZERO_RANGE:
+            off = (off_t)(rand_r(seed) % chunks) * chunk;
+            return fallocate(fd, FALLOC_FL_ZERO_RANGE, off, chunk);
+        case SPACE_PUNCH_HOLE:
+            /* 隔块打洞，制造最大程度的碎片 */
+            return fallocate(fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE,
+                             (off_t)(2 * i * chunk), chunk);
+        case SPACE_COLLAPSE:
+            /* 每次去掉一块后文件变短，偏移须落在当前文件内且不含末块 */
+            off = (off_t)(rand_r(seed) % (chunks - i - 1)) * chunk;
+            return fallocate(fd, FALLOC_FL_COLLAPSE_RANGE, off, chunk);
+        case SPACE_TRUNC_SHRINK:
+            return ftruncate(fd, (off_t)((chunks - i - 1) * chunk));
+        case SPACE_TRUNC_GROW:
+            return ftruncate(fd, (off_t)((i + 1) * chunk));
+        default:
+            return -1;
+    }
+}
+
+static void run_space_phase(int fd, enum space_op op, size_t chunk,
+                            size_t chunks, size_t calls) {
+    struct lat_hist hist;
+    struct timespec start, end;
+    uint64_t t0, t1;
+    unsigned int seed = 20240601u + op;
+    int err = 0;
+
+    /* collapse 后可能已没有剩余块，不输出空行 */
+    if (calls == 0) return;
+    lat_hist_init(&hist);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (size_t i = 0; i < calls; i++) {
+        t0 = timer_now();
+        int ret = do_space_op(fd, op, chunk, chunks, i, &seed);
+        t1 = timer_now();
+        if (ret != 0) {
+            err = errno;
+            break;
+        }
+        lat_hist_add(&hist, timer_diff_ns(t0, t1));
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    if (err != 0 && hist.count == 0) {
+        if (is_space_op_unsupported(err)) {
+            TEST_SKIP(space_op_name(op), strerror(err));
+        } else {
+            TEST_FAIL(space_op_name(op), strerror(err));
+        }
+        return;
+    }
+
+    double duration_s =
+        calculate_time_diff_ns(&start, &end) / (double)NANOS_PER_SECOND;
+    printf("  %-20s | %6llu calls | avg %8.1f us | p99 %8.1f us | "
+           "%9.1f MB/s",
+           space_op_name(op), (unsigned long long)hist.count,
+           hist.sum_ns / 1000.0 / hist.count,
+           lat_hist_percentile(&hist, 99.0) / 1000.0,
+           duration_s > 0.0 ? hist.count * chunk / (double)_1MB_BYTES /
+                                  duration_s
+                            : 0.0);
+    print_extents(fd);
+    if (err != 0) {
+        TEST_FAIL(space_op_name(op), strerror(err));
+    }
+}
+
+static void test_falloc_phases(const struct fstest_config *cfg) {
+    char path[MAX_PATH_LEN];
+    make_test_path(path, sizeof(path), cfg->dir, "space_falloc.dat");
+    int fd = open(path, O_CREAT | O_RDWR | O_TRUNC, 0644);
+    if (fd < 0) {
+        TEST_FAIL("space management", strerror(errno));
+        return;
+    }
+
+    size_t chunk = cfg->falloc_size;
+    size_t chunks = cfg->file_size / chunk;
+    if (chunks < 4) chunks = 4;
+
+    printf("\n  --- 预分配与回收 (fallocate / truncate, %zu x %zuKB) ---\n",
+           chunks, chunk / _1KB_BYTES);
+    run_space_phase(fd, SPACE_FALLOC, chunk, chunks, chunks);
+    run_space_phase(fd, SPACE_FALLOC_KEEP, chunk, chunks, chunks);
+    run_space_phase(fd, SPACE_ZERO_RANGE, chunk, chunks, chunks / 2);
+    run_space_phase(fd, SPACE_PUNCH_HOLE, chunk, chunks, chunks / 2);
+    run_space_phase(fd, SPACE_COLLAPSE, chunk, chunks, chunks / 4);
+
+    /* collapse 之后按实际大小计算剩余块数再截断 */
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        TEST_FAIL(space_op_name(SPACE_TRUNC_SHRINK), strerror(errno));
+    } else {
+        size_t remain = (size_t)st.st_size / chunk;
+        run_space_phase(fd, SPACE_TRUNC_SHRINK, chunk, remain, remain);
+    }
+    run_space_phase(fd, SPACE_TRUNC_GROW, chunk, chunks, chunks);
+
+    close(fd);
+    unlink(path);
+}
+
+/* VM 镜像式负载：在巨大的稀疏文件中随机写小块 */
+static void test_sparse_random_writes(const struct fstest_config *cfg) {
+    char path[MAX_PATH_LEN];
+    make_test_path(path, sizeof(path), cfg->dir, "space_sparse.dat");
+    int fd = open(path, O_CREAT | O_RDWR | O_TRUNC, 0644);
+    if (fd < 0) {
+        TEST_FAIL("sparse random write", strerror(errno));
+        return;
+    }
+
+    printf("\n  --- 稀疏文件随机写 (Sparse %zu GB, %zuB writes) ---\n",
+           cfg->sparse_size / _1GB_BYTES, cfg->io_size);
+    if (ftruncate(fd, (off_t)cfg->sparse_size) != 0) {
+        TEST_SKIP("sparse random write", strerror(errno));
+        close(fd);
+        unlink(path);
+        return;
+    }
+
+    char *buf = malloc(cfg->io_size);
+    if (!buf) {
+        TEST_FAIL("sparse random write", strerror(ENOMEM));
+        close(fd);
+        unlink(path);
+        return;
+    }
+    fill_rand_buffer(buf, cfg->io_size);
+    /* -s 大于 --sparse-size 时只有一个块 */
+    uint64_t blocks = cfg->sparse_size / cfg->io_size;
+    if (blocks == 0) blocks = 1;
+    unsigned int seed = 777;
+    struct lat_hist hist;
+    struct timespec start, end;
+    uint64_t t0, t1;
+    int errors = 0;
+
+    lat_hist_init(&hist);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < cfg->sparse_writes; i++) {
+        uint64_t r = ((uint64_t)rand_r(&seed) << 31) ^ (uint64_t)rand_r(&seed);
+        off_t off = (off_t)((r % blocks) * cfg->io_size);
+        t0 = timer_now();
+        ssize_t w = pwrite(fd, buf, cfg->io_size, off);
+        t1 = timer_now();
+        if (w != (ssize_t)cfg->io_size) {
+            errors++;
+            continue;
+        }
+        lat_hist_add(&hist, timer_diff_ns(t0, t1));
+    }
+    fsync(fd);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    double duration_s =
+        calculate_time_diff_ns(&start, &end) / (double)NANOS_PER_SECOND;
+    char lat[160];
+    lat_hist_format(&hist, lat, sizeof(lat));
+    printf("  %-20s | %6llu calls | %.0f IOPS (incl. fsync) | %s\n",
+           "random pwrite", (unsigned long long)hist.count,
+           duration_s > 0.0 ? hist.count / duration_s : 0.0, lat);
+    print_allocated(fd);
+    if (errors > 0) {
+        char msg[128];
+        snprintf(msg, sizeof(msg), "%d failed writes", errors);
+        TEST_FAIL("sparse random write", msg);
+    }
+
+    free(buf);
+    close(fd);
+    unlink(path);
+}
+
+/* SEEK_DATA / SEEK_HOLE 走完整个文件，返回数据段数，出错返回 -1 */
+static long seek_map_pass(int fd, long *calls) {
+    long segs = 0;
+    off_t off = 0;
+    *calls = 0;
+    for (;;) {
+        off_t data = lseek(fd, off, SEEK_DATA);
+        (*calls)++;
+        if (data < 0) return errno == ENXIO ? segs : -1;
+        off_t hole = lseek(fd, data, SEEK_HOLE);
+        (*calls)++;
+        if (hole < 0) return -1;
+        segs++;
+        off = hole;
+    }
+}
+
+/* 按 FIEMAP_BATCH 分批取 extent 直到 LAST 标志，返回 extent 数 */
+static long fiemap_map_pass(int fd, struct fiemap *fm, long *calls) {
+    long extents = 0;
+    uint64_t start = 0;
+    *calls = 0;
+    for (;;) {
+        memset(fm, 0, sizeof(*fm));
+        fm->fm_start = start;
+        fm->fm_length = FIEMAP_MAX_OFFSET - start;
+        fm->fm_extent_count = FIEMAP_BATCH;
+        if (ioctl(fd, FS_IOC_FIEMAP, fm) != 0) return -1;
+        (*calls)++;
+        uint32_t n = fm->fm_mapped_extents;
+        if (n == 0) return extents;
+        extents += n;
+        struct fiemap_extent *last = &fm->fm_extents[n - 1];
+        if (last->fe_flags & FIEMAP_EXTENT_LAST) return extents;
+        start = last->fe_logical + last->fe_length;
+    }
+}
+
+/* 只读 SEEK_DATA 报告的数据段，返回读到的字节数 */
+static int64_t read_skip_holes(int fd, char *buf) {
+    int64_t total = 0;
+    off_t off = 0;
+    for (;;) {
+        off_t data = lseek(fd, off, SEEK_DATA);
+        if (data < 0) return errno == ENXIO ? total : -1;
+        off_t hole = lseek(fd, data, SEEK_HOLE);
+        if (hole < 0) return -1;
+        for (off = data; off < hole;) {
+            size_t len = hole - off < SPARSE_READ_BUF ? (size_t)(hole - off)
+                                                      : SPARSE_READ_BUF;
+            ssize_t r = pread(fd, buf, len, off);
+            if (r <= 0) return -1;
+            total += r;
+            off += r;
+        }
+    }
+}
+
+static int64_t read_full(int fd, char *buf) {
+    int64_t total = 0;
+    ssize_t r;
+    while ((r = pread(fd, buf, SPARSE_READ_BUF, total)) > 0) total += r;
+    return r < 0 ? -1 : total;
+}
+
+static void print_map_line(const char *name, long segs, long calls,
+                           int64_t ns, int passes) {
+    double per_pass = ns / (double)passes;
+    printf("  %-20s | %8ld segs | %8ld calls | %9.3f ms/pass | "
+           "%8.3f us/call\n",
+           name, segs, calls, per_pass / 1e6,
+           calls > 0 ? per_pass / calls / 1000.0 : 0.0);
+}
+
+static void test_sparse_map_pattern(const struct fstest_config *cfg,
+                                    size_t data, size_t hole) {
+    long n = cfg->sparse_extents;
+    size_t logical = (size_t)n * (data + hole);
+    int passes = cfg->iter_count > 0 ? cfg->iter_count : 1;
+    printf("\n  --- 稀疏映射 (data %zuK / hole %zuK x %ld, %.1f MB logical)"
+           " ---\n",
+           data / _1KB_BYTES, hole / _1KB_BYTES, n,
+           logical / (double)_1MB_BYTES);
+
+    char path[MAX_PATH_LEN];
+    make_test_path(path, sizeof(path), cfg->dir, "space_map.dat");
+    int fd = open(path, O_CREAT | O_RDWR | O_TRUNC, 0644);
+    char *buf = malloc(SPARSE_READ_BUF);
+    struct fiemap *fm = calloc(1, sizeof(struct fiemap) +
+                                      FIEMAP_BATCH *
+                                          sizeof(struct fiemap_extent));
+    if (fd < 0 || !buf || !fm) {
+        TEST_FAIL("sparse map", strerror(fd < 0 ? errno : ENOMEM));
+        goto out;
+    }
+
+    /* 每段数据位于段首，末尾留一个空洞后截断到逻辑大小 */
+    fill_rand_buffer(buf, SPARSE_READ_BUF);
+    for (long i = 0; i < n; i++) {
+        off_t base = (off_t)i * (data + hole);
+        for (size_t done = 0; done < data;) {
+            size_t len = data - done < SPARSE_READ_BUF ? data - done
+                                                       : SPARSE_READ_BUF;
+            if (pwrite(fd, buf, len, base + done) != (ssize_t)len) {
+                TEST_FAIL("sparse map build", strerror(errno));
+                goto out;
+            }
+            done += len;
+        }
+    }
+    if (ftruncate(fd, (off_t)logical) != 0 || fsync(fd) != 0) {
+        TEST_FAIL("sparse map build", strerror(errno));
+        goto out;
+    }
+    print_allocated(fd);
+
+    struct timespec t0, t1;
+    long segs = 0, calls = 0;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (int p = 0; p < passes && segs >= 0; p++) {
+        segs = seek_map_pass(fd, &calls);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    if (segs < 0) {
+        TEST_SKIP("SEEK_DATA/SEEK_HOLE", strerror(errno));
+    } else {
+        print_map_line("SEEK_DATA/SEEK_HOLE", segs, calls,
+                       calculate_time_diff_ns(&t0, &t1), passes);
+        if (segs < n) {
+            /* 没有真正打洞的文件系统把整个文件报告为一段数据 */
+            TEST_SKIP("SEEK_DATA/SEEK_HOLE", "holes not reported");
+        }
+    }
+
+    long extents = 0;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (int p = 0; p < passes && extents >= 0; p++) {
+        extents = fiemap_map_pass(fd, fm, &calls);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    if (extents < 0) {
+        TEST_SKIP("FIEMAP", strerror(errno));
+    } else {
+        print_map_line("FIEMAP", extents, calls,
+                       calculate_time_diff_ns(&t0, &t1), passes);
+    }
+
+    int64_t skip_bytes = 0, full_bytes = 0, skip_ns = 0, full_ns = 0;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (int p = 0; p < passes && skip_bytes >= 0; p++) {
+        skip_bytes = read_skip_holes(fd, buf);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    skip_ns = calculate_time_diff_ns(&t0, &t1) / passes;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (int p = 0; p < passes && full_bytes >= 0; p++) {
+        full_bytes = read_full(fd, buf);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    full_ns = calculate_time_diff_ns(&t0, &t1) / passes;
+    if (skip_bytes < 0 || full_bytes < 0) {
+        TEST_FAIL("sparse map read", strerror(errno));
+        goto out;
+    }
+    printf("  %-20s | %9.1f MB read | %9.3f ms/pass | %9.1f MB/s logical\n",
+           "read skipping holes", skip_bytes / (double)_1MB_BYTES,
+           skip_ns / 1e6,
+           skip_ns > 0 ? logical / (double)_1MB_BYTES * 1e9 / skip_ns : 0.0);
+    printf("  %-20s | %9.1f MB read | %9.3f ms/pass | %9.1f MB/s logical"
+           " | skip speedup %.1fx\n",
+           "read full", full_bytes / (double)_1MB_BYTES, full_ns / 1e6,
+           full_ns > 0 ? logical / (double)_1MB_BYTES * 1e9 / full_ns : 0.0,
+           skip_ns > 0 ? full_ns / (double)skip_ns : 0.0);
+    if (full_bytes != (int64_t)logical) {
+        TEST_FAIL("sparse map read", "full read size mismatch");
+    }
+
+out:
+    free(fm);
+    free(buf);
+    if (fd >= 0) close(fd);
+    unlink(path);
+}
+
+/* 解析 "data:hole[,data:hole...]"，返回模式个数，出错返回 -1 */
+static int parse_sparse_map(const char *str, size_t *data, size_t *hole,
+                            int max_count) {
+    char buf[MAX_PATH_LEN];
+    snprintf(buf, sizeof(buf), "%s", str);
+    int count = 0;
+    char *save = NULL;
+    for (char *tok = strtok_r(buf, ",", &save); tok;
+         tok = strtok_r(NULL, ",", &save)) {
+        char *colon = strchr(tok, ':');
+        if (!colon || count >= max_count) return -1;
+        *colon = '\0';
+        if (parse_size(tok, &data[count]) != 0 ||
+            parse_size(colon + 1, &hole[count]) != 0 || data[count] == 0 ||
+            hole[count] == 0) {
+            return -1;
+        }
+        count++;
+    }
+    return count;
+}
+
+static void test_sparse_map(const struct fstest_config *cfg) {
+    size_t data[SPARSE_MAP_MAX], hole[SPARSE_MAP_MAX];
+    int n = parse_sparse_map(cfg->sparse_map, data, hole, SPARSE_MAP_MAX);
+    if (n <= 0) {
+        TEST_FAIL("sparse map", "invalid --sparse-map");
+        return;
+    }
+    for (int i = 0; i < n; i++) {
+        test_sparse_map_pattern(cfg, data[i], hole[i]);
+    }
+}
+
+void run_space_tests(const struct fstest_config *cfg) {
+    printf("\n");
+    printf("========================================\n");
+    printf("  13. 空间管理基准 (Space Management)\n");
+    printf("========================================\n");
+    printf("  Region:       %zu MB\n", cfg->file_size / _1MB_BYTES);
+    printf("  Granularity:  %zu bytes\n", cfg->falloc_size);
+
+    test_falloc_phases(cfg);
+    test_sparse_random_writes(cfg);
+    test_sparse_map(cfg);
+
+    printf("--- 空间管理基准完成 ---\n");
+}
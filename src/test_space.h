@@ -0,0 +1,13 @@
+/*
+    空间管理基准模块
+    衡量 fallocate / 打洞 / 截断 / 稀疏随机写的开销以及 extent 碎片化程度
+*/
+
+#ifndef FSTEST_TEST_SPACE_H
+#define FSTEST_TEST_SPACE_H
+
+#include "common.h"
+
+void run_space_tests(const struct fstest_config *cfg);
+
+#endif /* FSTEST_TEST_SPACE_H */
@@ -0,0 +1,234 @@
+/*
+    稳态检测模块实现
+    -j 个 worker 各自对一个预填好的 -f 大小文件持续执行 --ss-op 负载，
+    按 --ss-round 秒切分为测量轮次。参照 SNIA PTS 的稳态判据，最近
+    --ss-window 轮同时满足以下条件时认为进入稳态：
+    - 数据偏移：窗口内最大值与最小值之差不超过窗口均值的 --ss-tolerance %
+    - 趋势偏移：窗口内最小二乘拟合直线在整个窗口上的变化量不超过窗口均值的
+      --ss-slope %
+    判据同时作用于吞吐 (MB/s) 和平均延迟；运行总时长超过 --ss-max-time
+    仍未收敛时报告失败。只报告稳态窗口内的结果和收敛耗时
+*/
+
+#include "test_steady.h"
+
+#include "timed_io.h"
+#include "worker.h"
+
+#include <math.h>
+
+struct ss_round {
+    double secs;
+    uint64_t bytes;
+    uint64_t ops;
+    long errors;
+    double mbs;
+    double avg_us;
+    struct lat_hist hist;
+};
+
+/* 窗口内数据偏移和趋势偏移，均以窗口均值的百分比表示 */
+static void ss_excursion(const double *y, int n, double *range_pct,
+                         double *slope_pct) {
+    double sum = 0.0, lo = y[0], hi = y[0];
+    for (int i = 0; i < n; i++) {
+        sum += y[i];
+        if (y[i] < lo) lo = y[i];
+        if (y[i] > hi) hi = y[i];
+    }
+    double avg = sum / n;
+    double xm = (n - 1) / 2.0, sxy = 0.0, sxx = 0.0;
+    for (int i = 0; i < n; i++) {
+        sxy += (i - xm) * (y[i] - avg);
+        sxx += (i - xm) * (i - xm);
+    }
+    double slope = sxx > 0.0 ? sxy / sxx : 0.0;
+    if (avg <= 0.0) {
+        *range_pct = hi > lo ? 100.0 : 0.0;
+        *slope_pct = slope != 0.0 ? 100.0 : 0.0;
+        return;
+    }
+    *range_pct = (hi - lo) / avg * 100.0;
+    *slope_pct = fabs(slope) * (n - 1) / avg * 100.0;
+}
+
+struct ss_verdict {
+    double tput_range, tput_slope;
+    double lat_range, lat_slope;
+    int steady;
+};
+
+static struct ss_verdict ss_evaluate(const struct ss_round *rounds, int last,
+                                     const struct fstest_config *cfg) {
+    struct ss_verdict v;
+    int w = cfg->ss_window;
+    double tput[w], lat[w];
+    for (int i = 0; i < w; i++) {
+        tput[i] = rounds[last - w + 1 + i].mbs;
+        lat[i] = rounds[last - w + 1 + i].avg_us;
+    }
+    ss_excursion(tput, w, &v.tput_range, &v.tput_slope);
+    ss_excursion(lat, w, &v.lat_range, &v.lat_slope);
+    v.steady = v.tput_range <= cfg->ss_tolerance &&
+               v.tput_slope <= cfg->ss_slope &&
+               v.lat_range <= cfg->ss_tolerance &&
+               v.lat_slope <= cfg->ss_slope;
+    return v;
+}
+
+static void print_window(const struct ss_round *rounds, int first, int last,
+                         const struct ss_verdict *v,
+                         const struct fstest_config *cfg) {
+    struct lat_hist hist;
+    uint64_t bytes = 0, ops = 0;
+    double secs = 0.0;
+    lat_hist_init(&hist);
+    for (int r = first; r <= last; r++) {
+        bytes += rounds[r].bytes;
+        ops += rounds[r].ops;
+        secs += rounds[r].secs;
+        lat_hist_merge(&hist, &rounds[r].hist);
+    }
+    char lat[160];
+    lat_hist_format(&hist, lat, sizeof(lat));
+    printf("  Rounds:       %d-%d (%.1f s)\n", first + 1, last + 1, secs);
+    if (secs > 0.0) {
+        printf("  Throughput:   %.2f MB/s | %.0f IOPS\n",
+               bytes / (double)_1MB_BYTES / secs, ops / secs);
+    }
+    printf("  Latency:      %s\n", lat);
+    printf("  MB/s check:   range %.1f%% (<= %d%%), slope %.1f%% (<= %d%%)\n",
+           v->tput_range, cfg->ss_tolerance, v->tput_slope, cfg->ss_slope);
+    printf("  Lat check:    range %.1f%% (<= %d%%), slope %.1f%% (<= %d%%)\n",
+           v->lat_range, cfg->ss_tolerance, v->lat_slope, cfg->ss_slope);
+}
+
+void run_steady_tests(const struct fstest_config *cfg) {
+    printf("\n");
+    printf("========================================\n");
+    printf("  21. 稳态检测 (Steady-State Detection)\n");
+    printf("========================================\n");
+
+    int jobs = cfg->jobs;
+    int window = cfg->ss_window;
+    int max_rounds = cfg->ss_max_time / cfg->ss_round;
+    if (max_rounds < window) max_rounds = window;
+    size_t file_size = cfg->file_size < cfg->io_size ? cfg->io_size
+                                                      : cfg->file_size;
+
+    printf("  Workload:     %s | %d %s | IO %zu B | file %zu MB each\n",
+           test_type_key(cfg->ss_op), jobs, worker_kind(cfg->procs),
+           cfg->io_size, file_size / _1MB_BYTES);
+    printf("  Rounds:       %d s each, window %d, max %d rounds (%d s)\n",
+           cfg->ss_round, window, max_rounds, max_rounds * cfg->ss_round);
+    printf("  Criteria:     range <= %d%%, slope <= %d%% of window mean "
+           "(MB/s and avg latency)\n",
+           cfg->ss_tolerance, cfg->ss_slope);
+
+    char dir[MAX_PATH_LEN];
+    make_test_path(dir, sizeof(dir), cfg->dir, "steady");
+    if (mkdir(dir, 0755) != 0 && errno != EEXIST) {
+        TEST_FAIL("steady", strerror(errno));
+        return;
+    }
+    struct timed_io_args *args =
+        worker_args_alloc(jobs, sizeof(struct timed_io_args), cfg->procs);
+    struct ss_round *rounds = calloc(max_rounds, sizeof(struct ss_round));
+    if (!args || !rounds) {
+        TEST_FAIL("steady", strerror(ENOMEM));
+        goto out;
+    }
+    for (int i = 0; i < jobs; i++) {
+        snprintf(args[i].path, sizeof(args[i].path), "%s/f%02d", dir, i);
+        if (timed_io_prefill(args[i].path, file_size) != 0) {
+            TEST_FAIL("steady prefill", strerror(errno));
+            goto out;
+        }
+        args[i].type = (enum test_type)cfg->ss_op;
+        args[i].io_size = cfg->io_size;
+        args[i].file_size = file_size;
+        args[i].duration_ns = (uint64_t)cfg->ss_round * NANOS_PER_SECOND;
+        args[i].seed = (unsigned int)(i + 1);
+    }
+    printf("  Prefill:      %.1f MB\n",
+           jobs * (double)file_size / _1MB_BYTES);
+
+    printf("\n  %5s | %8s | %9s | %9s | %9s | %9s | %13s | %13s\n", "round",
+           "time s", "MB/s", "IOPS", "avg us", "p99 us", "MB/s rng/slp",
+           "lat rng/slp");
+
+    struct ss_verdict v = {0};
+    double elapsed_s = 0.0;
+    int last = -1;
+    long errors = 0;
+    for (int r = 0; r < max_rounds; r++) {
+        int64_t ns = run_workers(jobs, cfg->procs, timed_io_job, args,
+                                 sizeof(struct timed_io_args));
+        if (ns <= 0) {
+            TEST_FAIL("steady", worker_strerror(ns));
+            goto out;
+        }
+        struct ss_round *rd = &rounds[r];
+        lat_hist_init(&rd->hist);
+        rd->secs = ns / (double)NANOS_PER_SECOND;
+        for (int i = 0; i < jobs; i++) {
+            rd->bytes += args[i].bytes;
+            rd->ops += args[i].ops;
+            rd->errors += args[i].errors;
+            lat_hist_merge(&rd->hist, &args[i].hist);
+        }
+        rd->mbs = rd->bytes / (double)_1MB_BYTES / rd->secs;
+        rd->avg_us = rd->hist.count
+                         ? rd->hist.sum_ns / (double)rd->hist.count / 1000.0
+                         : 0.0;
+        elapsed_s += rd->secs;
+        errors += rd->errors;
+        last = r;
+
+        char tput_col[16] = "-", lat_col[16] = "-";
+        if (r + 1 >= window) {
+            v = ss_evaluate(rounds, r, cfg);
+            snprintf(tput_col, sizeof(tput_col), "%5.1f/%5.1f",
+                     v.tput_range, v.tput_slope);
+            snprintf(lat_col, sizeof(lat_col), "%5.1f/%5.1f", v.lat_range,
+                     v.lat_slope);
+        }
+        printf("  %5d | %8.1f | %9.2f | %9.0f | %9.1f | %9.1f | %13s | "
+               "%13s%s\n",
+               r + 1, elapsed_s, rd->mbs, rd->ops / rd->secs, rd->avg_us,
+               lat_hist_percentile(&rd->hist, 99.0) / 1000.0, tput_col,
+               lat_col, v.steady ? "  steady" : "");
+        fflush(stdout);
+        if (v.steady) break;
+    }
+
+    if (last + 1 >= window) {
+        int first = last - window + 1;
+        if (v.steady) {
+            printf("\n  --- 稳态窗口 (Steady-State Window) ---\n");
+            printf("  Converged:    after %d rounds, %.1f s "
+                   "(steady from round %d)\n",
+                   last + 1, elapsed_s, first + 1);
+        } else {
+            printf("\n  --- 最后窗口 (Last Window, not steady) ---\n");
+        }
+        print_window(rounds, first, last, &v, cfg);
+    }
+    if (!v.steady) {
+        char msg[96];
+        snprintf(msg, sizeof(msg), "not reached within %d rounds (%.1f s)",
+                 last + 1, elapsed_s);
+        TEST_FAIL("steady state", msg);
+    }
+    if (errors > 0) {
+        char msg[64];
+        snprintf(msg, sizeof(msg), "%ld failed IOs", errors);
+        TEST_FAIL("steady", msg);
+    }
+
+out:
+    free(rounds);
+    worker_args_free(args, jobs, sizeof(struct timed_io_args), cfg->procs);
+    remove_dir_recursive(dir);
+    printf("--- 稳态检测完成 ---\n");
+}
@@ -0,0 +1,14 @@
+/*
+    稳态检测模块
+    按测量轮次持续运行负载，直到吞吐和延迟按 SNIA 判据进入稳态，
+    只报告稳态窗口的结果和收敛耗时
+*/
+
+#ifndef FSTEST_TEST_STEADY_H
+#define FSTEST_TEST_STEADY_H
+
+#include "common.h"
+
+void run_steady_tests(const struct fstest_config *cfg);
+
+#endif /* FSTEST_TEST_STEADY_H */
@@ -9,6 +9,7 @@
 */
 
 #include "test_stress.h"
+#include "fsop.h"
 
 #include <sys/stat.h>
 
@@ -16,7 +17,7 @@
 static void test_mass_small_files(const struct fstest_config *cfg) {
     char subdir[MAX_PATH_LEN];
     make_test_path(subdir, sizeof(subdir), cfg->dir, "stress_small_files");
-    mkdir(subdir, 0755);
+    fs_mkdir(subdir, 0755);
 
     int file_count = 1000;
     struct timespec start, end;
@@ -30,12 +31,12 @@ static void test_mass_small_files(const struct fstest_config *cfg) {
     for (int i = 0; i < file_count; i++) {
         char path[MAX_PATH_LEN];
         snprintf(path, sizeof(path), "%s/file_%05d.dat", subdir, i);
-        int fd = open(path, O_CREAT | O_WRONLY | O_TRUNC, 0644);
+        int fd = fs_open(path, O_CREAT | O_WRONLY | O_TRUNC, 0644);
         if (fd < 0) break;
         char data[64];
         snprintf(data, sizeof(data), "small file %d", i);
-        (void)!write(fd, data, strlen(data));
-        close(fd);
+        (void)!fs_write(fd, data, strlen(data));
+        fs_close(fd);
         created++;
     }
 
@@ -65,7 +66,7 @@ static void test_mass_small_files(const struct fstest_config *cfg) {
     for (int i = 0; i < created; i++) {
         char path[MAX_PATH_LEN];
         snprintf(path, sizeof(path), "%s/file_%05d.dat", subdir, i);
-        unlink(path);
+        fs_unlink(path);
     }
     clock_gettime(CLOCK_MONOTONIC, &end);
     duration_ms = calculate_time_diff_ns(&start, &end) / 1000000.0;
@@ -74,7 +75,7 @@ static void test_mass_small_files(const struct fstest_config *cfg) {
            created, duration_ms,
            created / (duration_ms / 1000.0));
 
-    rmdir(subdir);
+    fs_rmdir(subdir);
 }
 
 /* 测试：超大文件 */
@@ -89,7 +90,7 @@ static void test_large_file(const struct fstest_config *cfg) {
     struct timespec start, end;
     clock_gettime(CLOCK_MONOTONIC, &start);
 
-    int fd = open(path, O_CREAT | O_WRONLY | O_TRUNC, 0644);
+    int fd = fs_open(path, O_CREAT | O_WRONLY | O_TRUNC, 0644);
     if (fd < 0) {
         TEST_FAIL("large file write", strerror(errno));
         return;
@@ -98,7 +99,7 @@ static void test_large_file(const struct fstest_config *cfg) {
     char *buf = malloc(block_size);
     if (!buf) {
         TEST_FAIL("large file write", "malloc failed");
-        close(fd);
+        fs_close(fd);
         return;
     }
     fill_rand_buffer(buf, block_size);
@@ -109,13 +110,13 @@ static void test_large_file(const struct fstest_config *cfg) {
         if (written + to_write > target_size) {
             to_write = target_size - written;
         }
-        ssize_t w = write(fd, buf, to_write);
+        ssize_t w = fs_write(fd, buf, to_write);
         if (w <= 0) {
             break;
         }
         written += w;
     }
-    close(fd);
+    fs_close(fd);
 
     clock_gettime(CLOCK_MONOTONIC, &end);
     double duration_s =
@@ -137,14 +138,14 @@ static void test_large_file(const struct fstest_config *cfg) {
 
     /* 读回验证 */
     clock_gettime(CLOCK_MONOTONIC, &start);
-    fd = open(path, O_RDONLY);
+    fd = fs_open(path, O_RDONLY);
     size_t total_read = 0;
     while (total_read < written) {
-        ssize_t r = read(fd, buf, block_size);
+        ssize_t r = fs_read(fd, buf, block_size);
         if (r <= 0) break;
         total_read += r;
     }
-    close(fd);
+    fs_close(fd);
     clock_gettime(CLOCK_MONOTONIC, &end);
 
     duration_s =
@@ -162,7 +163,7 @@ static void test_large_file(const struct fstest_config *cfg) {
     }
 
     free(buf);
-    unlink(path);
+    fs_unlink(path);
 }
 
 /* 测试：深层目录结构 */
@@ -178,7 +179,7 @@ static void test_deep_directory(const struct fstest_config *cfg) {
 
     int created_depth = 0;
     for (int i = 0; i < depth; i++) {
-        if (mkdir(current, 0755) != 0 && errno != EEXIST) {
+        if (fs_mkdir(current, 0755) != 0 && errno != EEXIST) {
             break;
         }
         created_depth++;
@@ -192,23 +193,23 @@ static void test_deep_directory(const struct fstest_config *cfg) {
     /* 在最深层创建文件 */
     char fpath[MAX_PATH_LEN];
     snprintf(fpath, sizeof(fpath), "%s/deep_file.txt", current);
-    int fd = open(fpath, O_CREAT | O_WRONLY, 0644);
+    int fd = fs_open(fpath, O_CREAT | O_WRONLY, 0644);
     int file_ok = 0;
     if (fd >= 0) {
-        (void)!write(fd, "deep!", 5);
-        close(fd);
+        (void)!fs_write(fd, "deep!", 5);
+        fs_close(fd);
 
         /* 读回验证 */
-        fd = open(fpath, O_RDONLY);
+        fd = fs_open(fpath, O_RDONLY);
         if (fd >= 0) {
             char buf[16] = {0};
-            (void)!read(fd, buf, sizeof(buf) - 1);
-            close(fd);
+            (void)!fs_read(fd, buf, sizeof(buf) - 1);
+            fs_close(fd);
             if (strcmp(buf, "deep!") == 0) {
                 file_ok = 1;
             }
         }
-        unlink(fpath);
+        fs_unlink(fpath);
     }
 
     if (created_depth == depth && file_ok) {
@@ -234,7 +235,7 @@ static void test_deep_directory(const struct fstest_config *cfg) {
 static void test_high_freq_metadata(const struct fstest_config *cfg) {
     char subdir[MAX_PATH_LEN];
     make_test_path(subdir, sizeof(subdir), cfg->dir, "stress_freq");
-    mkdir(subdir, 0755);
+    fs_mkdir(subdir, 0755);
 
     int ops = 500;
     struct timespec start, end;
@@ -249,23 +250,23 @@ static void test_high_freq_metadata(const struct fstest_config *cfg) {
                  subdir, i);
 
         /* 创建 */
-        int fd = open(path1, O_CREAT | O_WRONLY | O_TRUNC, 0644);
+        int fd = fs_open(path1, O_CREAT | O_WRONLY | O_TRUNC, 0644);
         if (fd < 0) {
             errors++;
             continue;
         }
-        (void)!write(fd, "x", 1);
-        close(fd);
+        (void)!fs_write(fd, "x", 1);
+        fs_close(fd);
 
         /* 重命名 */
-        if (rename(path1, path2) != 0) {
+        if (fs_rename(path1, path2) != 0) {
             errors++;
-            unlink(path1);
+            fs_unlink(path1);
             continue;
         }
 
         /* 删除 */
-        if (unlink(path2) != 0) {
+        if (fs_unlink(path2) != 0) {
             errors++;
         }
     }
@@ -290,7 +291,7 @@ static void test_high_freq_metadata(const struct fstest_config *cfg) {
         TEST_FAIL("high freq metadata", msg);
     }
 
-    rmdir(subdir);
+    fs_rmdir(subdir);
 }
 
 /* 测试：循环读写 */
@@ -298,7 +299,7 @@ static void test_loop_rw(const struct fstest_config *cfg) {
     char path[MAX_PATH_LEN];
     make_test_path(path, sizeof(path), cfg->dir, "stress_loop.dat");
 
-    int fd = open(path, O_CREAT | O_RDWR | O_TRUNC, 0644);
+    int fd = fs_open(path, O_CREAT | O_RDWR | O_TRUNC, 0644);
     if (fd < 0) {
         TEST_FAIL("loop rw", strerror(errno));
         return;
@@ -311,7 +312,7 @@ static void test_loop_rw(const struct fstest_config *cfg) {
         TEST_FAIL("loop rw", "malloc failed");
         free(wbuf);
         free(rbuf);
-        close(fd);
+        fs_close(fd);
         return;
     }
 
@@ -325,14 +326,14 @@ static void test_loop_rw(const struct fstest_config *cfg) {
         srand(i);
         fill_rand_buffer(wbuf, io_size);
 
-        lseek(fd, 0, SEEK_SET);
-        if (write(fd, wbuf, io_size) != (ssize_t)io_size) {
+        fs_lseek(fd, 0, SEEK_SET);
+        if (fs_write(fd, wbuf, io_size) != (ssize_t)io_size) {
             errors++;
             continue;
         }
 
-        lseek(fd, 0, SEEK_SET);
-        if (read(fd, rbuf, io_size) != (ssize_t)io_size) {
+        fs_lseek(fd, 0, SEEK_SET);
+        if (fs_read(fd, rbuf, io_size) != (ssize_t)io_size) {
             errors++;
             continue;
         }
@@ -346,7 +347,7 @@ static void test_loop_rw(const struct fstest_config *cfg) {
     double duration_s =
         calculate_time_diff_ns(&start, &end) / (double)NANOS_PER_SECOND;
 
-    close(fd);
+    fs_close(fd);
 
     if (errors == 0) {
         char msg[128];
@@ -362,7 +363,7 @@ static void test_loop_rw(const struct fstest_config *cfg) {
 
     free(wbuf);
     free(rbuf);
-    unlink(path);
+    fs_unlink(path);
 }
 
 void run_stress_tests(const struct fstest_config *cfg) {
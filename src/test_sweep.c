@@ -0,0 +1,244 @@
+/*
+    参数扫描模块实现
+    --sweep-bs / --sweep-jobs / --sweep-qd / --sweep-ops 各给出一组取值，
+    按 模式 → IO 大小 → worker 数 → 队列深度 的顺序跑完整矩阵，每个点运行
+    --sweep-time 秒。文件只预填一次 (max(jobs) 个 -f 大小的文件)，各点复用
+    前 jobs 个文件，写负载原地覆盖，避免每个点重新分配块
+    每个点输出一行：吞吐、IOPS、平均和分位延迟、失败 IO 数
+*/
+
+#include "test_sweep.h"
+
+#include "timed_io.h"
+#include "worker.h"
+
+struct sweep_axes {
+    size_t bs[MAX_SWEEP_VALUES];
+    size_t jobs[MAX_SWEEP_VALUES];
+    size_t qd[MAX_SWEEP_VALUES];
+    enum test_type ops[MAX_SWEEP_VALUES];
+    int n_bs, n_jobs, n_qd, n_ops;
+};
+
+static int parse_ops(const char *str, enum test_type *out, int max_count) {
+    char buf[MAX_PATH_LEN];
+    snprintf(buf, sizeof(buf), "%s", str);
+    int count = 0;
+    char *save = NULL;
+    for (char *tok = strtok_r(buf, ",", &save); tok;
+         tok = strtok_r(NULL, ",", &save)) {
+        int type = test_type_parse(tok);
+        if (count >= max_count || type < 0) return -1;
+        out[count++] = (enum test_type)type;
+    }
+    return count;
+}
+
+static int parse_axes(const struct fstest_config *cfg, struct sweep_axes *ax) {
+    ax->n_bs = parse_range_list(cfg->sweep_bs, ax->bs, MAX_SWEEP_VALUES);
+    ax->n_jobs = parse_range_list(cfg->sweep_jobs, ax->jobs, MAX_SWEEP_VALUES);
+    ax->n_qd = parse_range_list(cfg->sweep_qd, ax->qd, MAX_SWEEP_VALUES);
+    ax->n_ops = parse_ops(cfg->sweep_ops, ax->ops, MAX_SWEEP_VALUES);
+    if (ax->n_bs <= 0) {
+        TEST_FAIL("sweep", "invalid --sweep-bs");
+        return -1;
+    }
+    if (ax->n_jobs <= 0) {
+        TEST_FAIL("sweep", "invalid --sweep-jobs");
+        return -1;
+    }
+    if (ax->n_qd <= 0) {
+        TEST_FAIL("sweep", "invalid --sweep-qd");
+        return -1;
+    }
+    if (ax->n_ops <= 0) {
+        TEST_FAIL("sweep", "invalid --sweep-ops");
+        return -1;
+    }
+    for (int i = 0; i < ax->n_bs; i++) {
+        if (ax->bs[i] == 0) {
+            TEST_FAIL("sweep", "--sweep-bs values must be > 0");
+            return -1;
+        }
+    }
+    for (int i = 0; i < ax->n_jobs; i++) {
+        if (ax->jobs[i] < 1 || ax->jobs[i] > MAX_JOBS) {
+            TEST_FAIL("sweep", "--sweep-jobs values must be 1-64");
+            return -1;
+        }
+    }
+    for (int i = 0; i < ax->n_qd; i++) {
+        if (ax->qd[i] < 1 || ax->qd[i] > MAX_SWEEP_QD) {
+            TEST_FAIL("sweep", "--sweep-qd values must be 1-256");
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static size_t max_of(const size_t *v, int n) {
+    size_t m = 0;
+    for (int i = 0; i < n; i++) {
+        if (v[i] > m) m = v[i];
+    }
+    return m;
+}
+
+void run_sweep_tests(const struct fstest_config *cfg) {
+    printf("\n");
+    printf("========================================\n");
+    printf("  22. 参数扫描 (Parameter Sweep)\n");
+    printf("========================================\n");
+
+    struct sweep_axes ax;
+    if (parse_axes(cfg, &ax) != 0) return;
+
+    int max_jobs = (int)max_of(ax.jobs, ax.n_jobs);
+    size_t max_bs = max_of(ax.bs, ax.n_bs);
+    size_t file_size = cfg->file_size < max_bs ? max_bs : cfg->file_size;
+    int points = ax.n_ops * ax.n_bs * ax.n_jobs * ax.n_qd;
+
+    printf("  Matrix:       %d ops x %d bs x %d jobs x %d qd = %d points\n",
+           ax.n_ops, ax.n_bs, ax.n_jobs, ax.n_qd, points);
+    printf("  Per point:    %d s | %s | %s | file %zu MB each\n",
+           cfg->sweep_time, worker_kind(cfg->procs),
+           cfg->sweep_direct ? "O_DIRECT" : "buffered",
+           file_size / _1MB_BYTES);
+    printf("  Estimated:    %d s\n", points * cfg->sweep_time);
+
+    char dir[MAX_PATH_LEN];
+    make_test_path(dir, sizeof(dir), cfg->dir, "sweep");
+    if (mkdir(dir, 0755) != 0 && errno != EEXIST) {
+        TEST_FAIL("sweep", strerror(errno));
+        return;
+    }
+    FILE *csv = NULL;
+    struct timed_io_args *args = worker_args_alloc(
+        max_jobs, sizeof(struct timed_io_args), cfg->procs);
+    if (!args) {
+        TEST_FAIL("sweep", strerror(ENOMEM));
+        goto out;
+    }
+    for (int i = 0; i < max_jobs; i++) {
+        snprintf(args[i].path, sizeof(args[i].path), "%s/f%02d", dir, i);
+        if (timed_io_prefill(args[i].path, file_size) != 0) {
+            TEST_FAIL("sweep prefill", strerror(errno));
+            goto out;
+        }
+    }
+    printf("  Prefill:      %.1f MB\n",
+           max_jobs * (double)file_size / _1MB_BYTES);
+    /* 部分文件系统 (如 tmpfs) 不支持 O_DIRECT，提前探测避免整张表都是错误 */
+    size_t mem_align = 0, off_align = 0;
+    if (cfg->sweep_direct &&
+        dio_alignment(args[0].path, &mem_align, &off_align) < 0) {
+        TEST_SKIP("sweep", "O_DIRECT not supported on this filesystem");
+        goto out;
+    }
+    if (cfg->sweep_csv[0]) {
+        csv = fopen(cfg->sweep_csv, "w");
+        if (!csv) {
+            TEST_FAIL("sweep csv", strerror(errno));
+            goto out;
+        }
+        fprintf(csv, "op,bs,jobs,qd,mbs,iops,avg_us,p50_us,p99_us,"
+                     "p999_us,errors\n");
+    }
+
+    printf("\n  %-9s | %7s | %4s | %4s | %9s | %9s | %9s | %9s | %9s | "
+           "%9s | %6s\n",
+           "op", "bs", "jobs", "qd", "MB/s", "IOPS", "avg us", "p50 us",
+           "p99 us", "p99.9 us", "errors");
+
+    long total_errors = 0;
+    int done = 0;
+    for (int o = 0; o < ax.n_ops; o++) {
+        for (int b = 0; b < ax.n_bs; b++) {
+            if (cfg->sweep_direct && ax.bs[b] % off_align != 0) {
+                char msg[64];
+                snprintf(msg, sizeof(msg), "bs %zu not %zuB aligned",
+                         ax.bs[b], off_align);
+                TEST_SKIP("sweep O_DIRECT", msg);
+                continue;
+            }
+            for (int j = 0; j < ax.n_jobs; j++) {
+                for (int q = 0; q < ax.n_qd; q++) {
+                    int jobs = (int)ax.jobs[j];
+                    for (int i = 0; i < jobs; i++) {
+                        args[i].type = ax.ops[o];
+                        args[i].io_size = ax.bs[b];
+                        args[i].file_size = file_size;
+                        args[i].start_ns = 0;
+                        args[i].duration_ns =
+                            (uint64_t)cfg->sweep_time * NANOS_PER_SECOND;
+                        args[i].seed = (unsigned int)(i + 1);
+                        args[i].qd = (int)ax.qd[q];
+                        args[i].direct = cfg->sweep_direct;
+                        args[i].mem_align = mem_align;
+                        args[i].next_block = 0;
+                    }
+                    int64_t ns =
+                        run_workers(jobs, cfg->procs, timed_io_job, args,
+                                    sizeof(struct timed_io_args));
+                    if (ns <= 0) {
+                        TEST_FAIL("sweep", worker_strerror(ns));
+                        goto out;
+                    }
+
+                    struct lat_hist hist;
+                    uint64_t bytes = 0, ops = 0;
+                    long errors = 0;
+                    lat_hist_init(&hist);
+                    for (int i = 0; i < jobs; i++) {
+                        bytes += args[i].bytes;
+                        ops += args[i].ops;
+                        errors += args[i].errors;
+                        lat_hist_merge(&hist, &args[i].hist);
+                    }
+                    double secs = ns / (double)NANOS_PER_SECOND;
+                    double mbs = bytes / (double)_1MB_BYTES / secs;
+                    double iops = ops / secs;
+                    double avg = hist.count ? hist.sum_ns / 1000.0 /
+                                                  hist.count
+                                            : 0.0;
+                    double p50 = lat_hist_percentile(&hist, 50.0) / 1000.0;
+                    double p99 = lat_hist_percentile(&hist, 99.0) / 1000.0;
+                    double p999 = lat_hist_percentile(&hist, 99.9) / 1000.0;
+                    total_errors += errors;
+                    done++;
+
+                    printf("  %-9s | %7zu | %4d | %4zu | %9.2f | %9.0f | "
+                           "%9.1f | %9.1f | %9.1f | %9.1f | %6ld\n",
+                           test_type_key(ax.ops[o]), ax.bs[b], jobs,
+                           ax.qd[q], mbs, iops, avg, p50, p99, p999, errors);
+                    fflush(stdout);
+                    if (csv) {
+                        fprintf(csv,
+                                "%s,%zu,%d,%zu,%.2f,%.0f,%.1f,%.1f,%.1f,"
+                                "%.1f,%ld\n",
+                                test_type_key(ax.ops[o]), ax.bs[b], jobs,
+                                ax.qd[q], mbs, iops, avg, p50, p99, p999,
+                                errors);
+                    }
+                }
+            }
+        }
+    }
+
+    printf("\n  Points:       %d run\n", done);
+    if (csv) printf("  CSV:          %s\n", cfg->sweep_csv);
+    if (total_errors > 0) {
+        char msg[64];
+        snprintf(msg, sizeof(msg), "%ld failed IOs", total_errors);
+        TEST_FAIL("sweep", msg);
+    } else if (done > 0) {
+        TEST_PASS("sweep");
+    }
+
+out:
+    if (csv) fclose(csv);
+    worker_args_free(args, max_jobs, sizeof(struct timed_io_args),
+                     cfg->procs);
+    remove_dir_recursive(dir);
+    printf("--- 参数扫描完成 ---\n");
+}
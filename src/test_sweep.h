@@ -0,0 +1,14 @@
+/*
+    参数扫描模块
+    对 IO 大小 × worker 数 × 队列深度 × 访问模式的全组合逐点运行定时负载，
+    输出扩展曲线表格，可另存为 CSV
+*/
+
+#ifndef FSTEST_TEST_SWEEP_H
+#define FSTEST_TEST_SWEEP_H
+
+#include "common.h"
+
+void run_sweep_tests(const struct fstest_config *cfg);
+
+#endif /* FSTEST_TEST_SWEEP_H */
@@ -0,0 +1,221 @@
+/*
+    WAL 提交延迟基准模块实现
+    所有线程向同一个日志文件提交 -s 大小的记录，每个线程提交 --wal-commits 次
+    提交方式：
+    - 逐条提交 (per-commit)：原子地预留尾部偏移，pwrite 后立即 fdatasync
+    - 组提交 (group commit)：记录先进入共享缓冲区；没有刷盘进行中时，到达的
+      线程成为 leader，把所有待提交记录合并为一次 pwrite + fdatasync，
+      其他线程等待自己的记录变为持久；批次写入失败时，批内每条记录都算失败
+    线程数从 1 翻倍到 -j，报告 commits/s、平均批大小和提交延迟分位数
+*/
+
+#include "test_wal.h"
+
+#include "timer.h"
+
+enum wal_mode { WAL_PER_COMMIT, WAL_GROUP_COMMIT };
+
+struct wal_log {
+    int fd;
+    enum wal_mode mode;
+    size_t record_size;
+    _Atomic int64_t tail;   /* 逐条提交模式下的下一个写入偏移 */
+
+    /* 组提交状态，受 lock 保护 */
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    char *pending;          /* 等待刷盘的记录 */
+    char *flushing_buf;     /* leader 正在写的批次 */
+    int **pending_status;   /* 每条待提交记录所属线程的结果槽 */
+    int **flushing_status;
+    size_t pending_len;
+    uint64_t next_seq;      /* 最后一个进入缓冲区的记录序号 */
+    uint64_t durable_seq;   /* 已持久的最大记录序号 */
+    int flushing;
+    uint64_t batches;
+    int errors;
+};
+
+struct wal_job_args {
+    struct wal_log *log;
+    int thread_id;
+    int commits;
+    struct lat_hist hist;
+};
+
+static int wal_commit_single(struct wal_log *log, const char *rec) {
+    off_t off = (off_t)atomic_fetch_add(&log->tail,
+                                        (int64_t)log->record_size);
+    if (pwrite(log->fd, rec, log->record_size, off) !=
+        (ssize_t)log->record_size) {
+        return -1;
+    }
+    return fdatasync(log->fd);
+}
+
+static int wal_commit_group(struct wal_log *log, const char *rec) {
+    int status = 0;
+    pthread_mutex_lock(&log->lock);
+    log->pending_status[log->pending_len / log->record_size] = &status;
+    memcpy(log->pending + log->pending_len, rec, log->record_size);
+    log->pending_len += log->record_size;
+    uint64_t my_seq = ++log->next_seq;
+
+    while (log->durable_seq < my_seq) {
+        if (log->flushing) {
+            pthread_cond_wait(&log->cond, &log->lock);
+            continue;
+        }
+
+        /* 成为 leader：取走当前所有待提交记录 */
+        char *batch = log->pending;
+        int **waiters = log->pending_status;
+        size_t len = log->pending_len;
+        uint64_t batch_end = log->next_seq;
+        off_t off = (off_t)log->tail;
+        log->tail += (int64_t)len;
+        log->pending = log->flushing_buf;
+        log->flushing_buf = batch;
+        log->pending_status = log->flushing_status;
+        log->flushing_status = waiters;
+        log->pending_len = 0;
+        log->flushing = 1;
+        pthread_mutex_unlock(&log->lock);
+
+        int err = pwrite(log->fd, batch, len, off) != (ssize_t)len ||
+                  fdatasync(log->fd) != 0;
+
+        pthread_mutex_lock(&log->lock);
+        if (err) log->errors++;
+        /* 批内的记录 (包括 leader 自己的) 共享同一个结果 */
+        for (size_t i = 0; i < len / log->record_size; i++) {
+            *waiters[i] = err ? -1 : 0;
+        }
+        log->durable_seq = batch_end;
+        log->flushing = 0;
+        log->batches++;
+        pthread_cond_broadcast(&log->cond);
+    }
+    pthread_mutex_unlock(&log->lock);
+    return status;
+}
+
+static void *wal_job(void *arg) {
+    struct wal_job_args *a = (struct wal_job_args *)arg;
+    struct wal_log *log = a->log;
+    char *rec = malloc(log->record_size);
+    uint64_t t0, t1;
+
+    memset(rec, 'a' + a->thread_id % 26, log->record_size);
+    lat_hist_init(&a->hist);
+    for (int i = 0; i < a->commits; i++) {
+        memcpy(rec, &i, sizeof(i));
+        t0 = timer_now();
+        int ret = log->mode == WAL_GROUP_COMMIT ? wal_commit_group(log, rec)
+                                                : wal_commit_single(log, rec);
+        t1 = timer_now();
+        if (ret == 0) {
+            lat_hist_add(&a->hist, timer_diff_ns(t0, t1));
+        }
+    }
+    free(rec);
+    return NULL;
+}
+
+static void run_wal_point(const char *path, enum wal_mode mode, int nthreads,
+                          const struct fstest_config *cfg) {
+    struct wal_log log;
+    memset(&log, 0, sizeof(log));
+    log.fd = open(path, O_CREAT | O_WRONLY | O_TRUNC, 0644);
+    if (log.fd < 0) {
+        TEST_FAIL("wal", strerror(errno));
+        return;
+    }
+    log.mode = mode;
+    log.record_size = cfg->io_size;
+    atomic_init(&log.tail, 0);
+    pthread_mutex_init(&log.lock, NULL);
+    pthread_cond_init(&log.cond, NULL);
+    /* 每个线程同一时刻最多有一条未提交记录 */
+    log.pending = malloc(nthreads * cfg->io_size);
+    log.flushing_buf = malloc(nthreads * cfg->io_size);
+    log.pending_status = calloc(nthreads, sizeof(int *));
+    log.flushing_status = calloc(nthreads, sizeof(int *));
+
+    pthread_t *threads = malloc(nthreads * sizeof(pthread_t));
+    struct wal_job_args *args = calloc(nthreads, sizeof(struct wal_job_args));
+    struct timespec start, end;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < nthreads; i++) {
+        args[i].log = &log;
+        args[i].thread_id = i;
+        args[i].commits = cfg->wal_commits;
+        pthread_create(&threads[i], NULL, wal_job, &args[i]);
+    }
+    for (int i = 0; i < nthreads; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    struct lat_hist total;
+    lat_hist_init(&total);
+    for (int i = 0; i < nthreads; i++) {
+        lat_hist_merge(&total, &args[i].hist);
+    }
+    double duration_s =
+        calculate_time_diff_ns(&start, &end) / (double)NANOS_PER_SECOND;
+    uint64_t syncs = mode == WAL_GROUP_COMMIT ? log.batches : total.count;
+    char lat[160];
+    lat_hist_format(&total, lat, sizeof(lat));
+    printf("  %-12s | %2d jobs | %8.0f commits/s | batch %5.1f | %s\n",
+           mode == WAL_GROUP_COMMIT ? "group" : "per-commit", nthreads,
+           duration_s > 0.0 ? total.count / duration_s : 0.0,
+           syncs > 0 ? (double)total.count / syncs : 0.0, lat);
+
+    uint64_t expected = (uint64_t)nthreads * cfg->wal_commits;
+    if (total.count != expected || log.errors > 0) {
+        char msg[128];
+        snprintf(msg, sizeof(msg), "%llu of %llu commits failed",
+                 (unsigned long long)(expected - total.count),
+                 (unsigned long long)expected);
+        TEST_FAIL("wal commit", msg);
+    }
+
+    free(args);
+    free(threads);
+    free(log.pending);
+    free(log.flushing_buf);
+    free(log.pending_status);
+    free(log.flushing_status);
+    pthread_cond_destroy(&log.cond);
+    pthread_mutex_destroy(&log.lock);
+    close(log.fd);
+    unlink(path);
+}
+
+void run_wal_tests(const struct fstest_config *cfg) {
+    printf("\n");
+    printf("========================================\n");
+    printf("  14. WAL 提交延迟 (Write-Ahead Log)\n");
+    printf("========================================\n");
+    printf("  Record size:  %zu bytes\n", cfg->io_size);
+    printf("  Commits:      %d per thread\n", cfg->wal_commits);
+    printf("  Max threads:  %d\n", cfg->jobs);
+
+    char path[MAX_PATH_LEN];
+    make_test_path(path, sizeof(path), cfg->dir, "wal.log");
+
+    for (int mode = WAL_PER_COMMIT; mode <= WAL_GROUP_COMMIT; mode++) {
+        printf("\n  --- %s ---\n", mode == WAL_PER_COMMIT
+                                      ? "逐条提交 (pwrite + fdatasync)"
+                                      : "组提交 (Group Commit)");
+        for (int n = 1;; n *= 2) {
+            if (n > cfg->jobs) n = cfg->jobs;
+            run_wal_point(path, (enum wal_mode)mode, n, cfg);
+            if (n == cfg->jobs) break;
+        }
+    }
+
+    printf("--- WAL 提交延迟测试完成 ---\n");
+}
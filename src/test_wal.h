@@ -0,0 +1,13 @@
+/*
+    WAL 提交延迟基准模块
+    小记录顺序追加 + fdatasync，比较逐条提交与组提交
+*/
+
+#ifndef FSTEST_TEST_WAL_H
+#define FSTEST_TEST_WAL_H
+
+#include "common.h"
+
+void run_wal_tests(const struct fstest_config *cfg);
+
+#endif /* FSTEST_TEST_WAL_H */
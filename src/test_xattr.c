@@ -0,0 +1,258 @@
+/*
+    扩展属性性能基准模块实现
+    在 --xattr-files 个文件上，对每种 (值大小, 每文件属性数) 组合依次执行：
+    - set:    setxattr(XATTR_CREATE) 写入每个属性
+    - get:    getxattr 读回每个属性并校验内容
+    - list:   每个文件一次 listxattr
+    - remove: removexattr 删除每个属性
+    值大小覆盖 inode 内联存储和外部块 / 独立 inode 存储两种情况；
+    超过文件系统单 inode 属性空间的组合输出 SKIP
+    单线程和 -j 线程各运行一次，文件按线程均分
+*/
+
+#include "test_xattr.h"
+
+#include "timer.h"
+
+#include <sys/xattr.h>
+
+#define XATTR_MAX_POINTS 16
+#define XATTR_NAME_LEN 32
+
+enum xattr_phase { XATTR_SET, XATTR_GET, XATTR_LIST, XATTR_REMOVE };
+
+static const char *xattr_phase_name(enum xattr_phase phase) {
+    switch (phase) {
+        case XATTR_SET: return "set";
+        case XATTR_GET: return "get";
+        case XATTR_LIST: return "list";
+        case XATTR_REMOVE: return "remove";
+        default: return "unknown";
+    }
+}
+
+struct xattr_job_args {
+    const char *dir;
+    int first_file;
+    int last_file;             /* 不含 */
+    size_t value_size;
+    int count;
+    enum xattr_phase phase;
+    struct lat_hist lat;
+    int errors;
+    int limit_errno;           /* set 阶段超出属性空间时记录 errno */
+};
+
+static void xattr_file_path(char *buf, size_t size, const char *dir, int i) {
+    snprintf(buf, size, "%s/f%06d", dir, i);
+}
+
+static void xattr_name(char *buf, size_t size, int j) {
+    snprintf(buf, size, "user.fstest.%03d", j);
+}
+
+static int is_xattr_limit(int err) {
+    return err == ENOSPC || err == E2BIG || err == ERANGE || err == EDQUOT;
+}
+
+static void *xattr_job(void *arg) {
+    struct xattr_job_args *a = (struct xattr_job_args *)arg;
+    size_t list_size = (size_t)a->count * XATTR_NAME_LEN + 4096;
+    char *value = malloc(a->value_size ? a->value_size : 1);
+    char *list = malloc(list_size);
+    char path[MAX_PATH_LEN], name[XATTR_NAME_LEN];
+    uint64_t t0, t1;
+
+    lat_hist_init(&a->lat);
+    if (!value || !list) {
+        a->errors++;
+        goto out;
+    }
+    for (int i = a->first_file; i < a->last_file; i++) {
+        xattr_file_path(path, sizeof(path), a->dir, i);
+        int n = a->phase == XATTR_LIST ? 1 : a->count;
+        for (int j = 0; j < n; j++) {
+            char fill = (char)('a' + (i + j) % 26);
+            ssize_t ret = 0;
+            xattr_name(name, sizeof(name), j);
+            if (a->phase == XATTR_SET) memset(value, fill, a->value_size);
+
+            t0 = timer_now();
+            switch (a->phase) {
+                case XATTR_SET:
+                    ret = setxattr(path, name, value, a->value_size,
+                                   XATTR_CREATE);
+                    break;
+                case XATTR_GET:
+                    ret = getxattr(path, name, value, a->value_size);
+                    break;
+                case XATTR_LIST:
+                    ret = listxattr(path, list, list_size);
+                    break;
+                case XATTR_REMOVE:
+                    ret = removexattr(path, name);
+                    break;
+            }
+            t1 = timer_now();
+
+            if (ret < 0) {
+                if (a->phase == XATTR_SET && is_xattr_limit(errno)) {
+                    a->limit_errno = errno;
+                    goto out;
+                }
+                /* set 阶段提前停止时 remove 会遇到不存在的属性 */
+                if (a->phase == XATTR_REMOVE && errno == ENODATA) continue;
+                a->errors++;
+                continue;
+            }
+            lat_hist_add(&a->lat, timer_diff_ns(t0, t1));
+            if (a->phase == XATTR_GET &&
+                ((size_t)ret != a->value_size ||
+                 (a->value_size > 0 &&
+                  (value[0] != fill || value[a->value_size - 1] != fill)))) {
+                a->errors++;
+            }
+        }
+    }
+out:
+    free(value);
+    free(list);
+    return NULL;
+}
+
+/* 运行一个阶段并打印一行结果；返回超出属性空间时的 errno，否则 0 */
+static int run_xattr_phase(const char *dir, int files, int nthreads,
+                           size_t value_size, int count,
+                           enum xattr_phase phase, int quiet) {
+    pthread_t *threads = malloc(nthreads * sizeof(pthread_t));
+    struct xattr_job_args *args =
+        calloc(nthreads, sizeof(struct xattr_job_args));
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < nthreads; i++) {
+        args[i].dir = dir;
+        args[i].first_file = (int)((long)files * i / nthreads);
+        args[i].last_file = (int)((long)files * (i + 1) / nthreads);
+        args[i].value_size = value_size;
+        args[i].count = count;
+        args[i].phase = phase;
+        pthread_create(&threads[i], NULL, xattr_job, &args[i]);
+    }
+    for (int i = 0; i < nthreads; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    struct lat_hist lat;
+    int errors = 0, limit_errno = 0;
+    lat_hist_init(&lat);
+    for (int i = 0; i < nthreads; i++) {
+        lat_hist_merge(&lat, &args[i].lat);
+        errors += args[i].errors;
+        if (args[i].limit_errno) limit_errno = args[i].limit_errno;
+    }
+
+    char label[64];
+    snprintf(label, sizeof(label), "xattr %s %zuB x %d",
+             xattr_phase_name(phase), value_size, count);
+    if (limit_errno) {
+        char msg[96];
+        snprintf(msg, sizeof(msg), "exceeds per-inode xattr space (%s)",
+                 strerror(limit_errno));
+        TEST_SKIP(label, msg);
+    } else if (!quiet) {
+        double duration_s =
+            calculate_time_diff_ns(&start, &end) / (double)NANOS_PER_SECOND;
+        char buf[160];
+        lat_hist_format(&lat, buf, sizeof(buf));
+        printf("  %8zu | %5d | %7d | %-6s | %10.0f | %s\n", value_size, count,
+               nthreads, xattr_phase_name(phase),
+               duration_s > 0.0 ? lat.count / duration_s : 0.0, buf);
+    }
+    if (errors > 0) {
+        char msg[64];
+        snprintf(msg, sizeof(msg), "%d failed or mismatched ops", errors);
+        TEST_FAIL(label, msg);
+    }
+
+    free(args);
+    free(threads);
+    return limit_errno;
+}
+
+void run_xattr_tests(const struct fstest_config *cfg) {
+    printf("\n");
+    printf("========================================\n");
+    printf("  17. 扩展属性性能 (Extended Attributes)\n");
+    printf("========================================\n");
+
+    size_t sizes[XATTR_MAX_POINTS], counts[XATTR_MAX_POINTS];
+    int size_n = parse_size_list(cfg->xattr_sizes, sizes, XATTR_MAX_POINTS);
+    int count_n = parse_size_list(cfg->xattr_counts, counts, XATTR_MAX_POINTS);
+    if (size_n <= 0 || count_n <= 0) {
+        TEST_FAIL("xattr", "invalid --xattr-sizes or --xattr-counts list");
+        return;
+    }
+    printf("  Files:        %d\n", cfg->xattr_files);
+    printf("  Value sizes:  %s\n", cfg->xattr_sizes);
+    printf("  Counts:       %s per file\n", cfg->xattr_counts);
+
+    char dir[MAX_PATH_LEN], path[MAX_PATH_LEN];
+    make_test_path(dir, sizeof(dir), cfg->dir, "xattr_bench");
+    if (mkdir(dir, 0755) != 0 && errno != EEXIST) {
+        TEST_FAIL("xattr", strerror(errno));
+        return;
+    }
+    for (int i = 0; i < cfg->xattr_files; i++) {
+        xattr_file_path(path, sizeof(path), dir, i);
+        int fd = open(path, O_CREAT | O_WRONLY, 0644);
+        if (fd < 0) {
+            TEST_FAIL("xattr", strerror(errno));
+            remove_dir_recursive(dir);
+            return;
+        }
+        close(fd);
+    }
+
+    /* 探测文件系统是否支持 user.* 属性 */
+    xattr_file_path(path, sizeof(path), dir, 0);
+    if (setxattr(path, "user.fstest.probe", "1", 1, 0) != 0) {
+        if (errno == ENOTSUP || errno == EOPNOTSUPP) {
+            TEST_SKIP("xattr", "user xattrs not supported by filesystem");
+        } else {
+            TEST_FAIL("xattr", strerror(errno));
+        }
+        remove_dir_recursive(dir);
+        return;
+    }
+    removexattr(path, "user.fstest.probe");
+
+    int threads[2] = {1, cfg->jobs};
+    int thread_n = cfg->jobs > 1 ? 2 : 1;
+    printf("\n  %8s | %5s | %7s | %-6s | %10s | latency\n", "value B",
+           "count", "threads", "op", "ops/s");
+    for (int s = 0; s < size_n; s++) {
+        for (int c = 0; c < count_n; c++) {
+            int count = counts[c] > 0 ? (int)counts[c] : 1;
+            for (int t = 0; t < thread_n; t++) {
+                int limited = run_xattr_phase(dir, cfg->xattr_files,
+                                              threads[t], sizes[s], count,
+                                              XATTR_SET, 0);
+                if (!limited) {
+                    run_xattr_phase(dir, cfg->xattr_files, threads[t],
+                                    sizes[s], count, XATTR_GET, 0);
+                    run_xattr_phase(dir, cfg->xattr_files, threads[t],
+                                    sizes[s], count, XATTR_LIST, 0);
+                }
+                /* 超限时也要清理已写入的部分属性 */
+                run_xattr_phase(dir, cfg->xattr_files, threads[t], sizes[s],
+                                count, XATTR_REMOVE, limited);
+                if (limited) break;
+            }
+        }
+    }
+
+    remove_dir_recursive(dir);
+    printf("--- 扩展属性性能测试完成 ---\n");
+}
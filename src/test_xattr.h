@@ -0,0 +1,13 @@
+/*
+    扩展属性性能基准模块
+    衡量 user.* xattr 的 set/get/list/remove 开销随值大小和数量的变化
+*/
+
+#ifndef FSTEST_TEST_XATTR_H
+#define FSTEST_TEST_XATTR_H
+
+#include "common.h"
+
+void run_xattr_tests(const struct fstest_config *cfg);
+
+#endif /* FSTEST_TEST_XATTR_H */
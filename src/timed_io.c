@@ -0,0 +1,251 @@
+/*
+    定时 I/O 负载实现
+    顺序模式在文件末尾回绕，游标保存在参数中，多轮调用 (稳态检测) 接续
+    上一轮的位置；随机模式按 IO 大小对齐取块；每次 IO 用 timer
+    单独计时，运行时长复用同一组时间戳判断，起止时刻按实时时钟记录以便跨
+    节点换算。
+    队列深度大于 1 时使用 POSIX AIO
+*/
+
+#include "timed_io.h"
+
+#include <aio.h>
+
+#include "timer.h"
+
+static const char *const test_type_keys[] = {
+    [SEQ_READ] = "seqread",
+    [SEQ_WRITE] = "seqwrite",
+    [RAND_READ] = "randread",
+    [RAND_WRITE] = "randwrite",
+};
+
+#define TEST_TYPE_COUNT \
+    ((int)(sizeof(test_type_keys) / sizeof(test_type_keys[0])))
+
+const char *test_type_key(enum test_type type) {
+    if ((int)type < 0 || (int)type >= TEST_TYPE_COUNT) return "unknown";
+    return test_type_keys[type];
+}
+
+int test_type_parse(const char *str) {
+    for (int i = 0; i < TEST_TYPE_COUNT; i++) {
+        if (strcmp(str, test_type_keys[i]) == 0) return i;
+    }
+    return -1;
+}
+
+uint64_t realtime_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (uint64_t)ts.tv_sec * NANOS_PER_SECOND + ts.tv_nsec;
+}
+
+static void timed_io_next(struct timed_io_args *a, size_t *block,
+                          size_t blocks, int is_rand, off_t *off) {
+    if (is_rand) {
+        *block = rand_r(&a->seed) % blocks;
+    } else if (*block >= blocks) {
+        *block = 0;
+    }
+    *off = (off_t)(*block * a->io_size);
+    (*block)++;
+}
+
+static void timed_io_done(struct timed_io_args *a, ssize_t ret, uint64_t t0,
+                          uint64_t t1) {
+    if (ret == (ssize_t)a->io_size) {
+        lat_hist_add(&a->hist, timer_diff_ns(t0, t1));
+        a->bytes += ret;
+        a->ops++;
+    } else {
+        a->errors++;
+    }
+}
+
+static int64_t timed_io_sync(struct timed_io_args *a, int fd, char *buf,
+                             size_t blocks, int is_write, int is_rand,
+                             uint64_t m0) {
+    size_t block = a->next_block;
+    int64_t elapsed = 0;
+    while (elapsed < (int64_t)a->duration_ns) {
+        off_t off;
+        timed_io_next(a, &block, blocks, is_rand, &off);
+        uint64_t t0 = timer_now();
+        ssize_t ret = is_write ? pwrite(fd, buf, a->io_size, off)
+                               : pread(fd, buf, a->io_size, off);
+        uint64_t t1 = timer_now();
+        timed_io_done(a, ret, t0, t1);
+        elapsed = (int64_t)timer_diff_ns(m0, t1);
+    }
+    a->next_block = block;
+    return elapsed;
+}
+
+/*
+    队列深度 > 1：POSIX AIO 保持 qd 个请求在途，完成一个补发一个，到时后
+    排空。glibc 的 AIO 在同一个 fd 上串行执行请求，所以每个槽位使用 dup
+    出的独立 fd；延迟为提交到观察到完成的时间
+*/
+static int64_t timed_io_async(struct timed_io_args *a, int fd, char *bufs,
+                              size_t blocks, int is_write, int is_rand,
+                              uint64_t m0) {
+    int qd = a->qd;
+    struct aiocb *cbs = calloc(qd, sizeof(struct aiocb));
+    const struct aiocb **list = calloc(qd, sizeof(struct aiocb *));
+    uint64_t *issued = calloc(qd, sizeof(uint64_t));
+    int *fds = calloc(qd, sizeof(int));
+    uint64_t now;
+    size_t block = a->next_block;
+    int64_t elapsed = 0;
+    int inflight = 0;
+
+    if (!cbs || !list || !issued || !fds) {
+        a->errors++;
+        goto out;
+    }
+    for (int i = 0; i < qd; i++) {
+        fds[i] = i == 0 ? fd : dup(fd);
+        if (fds[i] < 0) fds[i] = fd;
+    }
+
+    for (int i = 0; i < qd; i++) {
+        off_t off;
+        timed_io_next(a, &block, blocks, is_rand, &off);
+        cbs[i].aio_fildes = fds[i];
+        cbs[i].aio_buf = bufs + (size_t)i * a->io_size;
+        cbs[i].aio_nbytes = a->io_size;
+        cbs[i].aio_offset = off;
+        issued[i] = timer_now();
+        if ((is_write ? aio_write(&cbs[i]) : aio_read(&cbs[i])) == 0) {
+            list[i] = &cbs[i];
+            inflight++;
+        } else {
+            a->errors++;
+        }
+    }
+    while (inflight > 0) {
+        if (aio_suspend(list, qd, NULL) != 0 && errno != EINTR) {
+            a->errors++;
+            break;
+        }
+        now = timer_now();
+        elapsed = (int64_t)timer_diff_ns(m0, now);
+        for (int i = 0; i < qd; i++) {
+            if (!list[i] || aio_error(&cbs[i]) == EINPROGRESS) continue;
+            timed_io_done(a, aio_return(&cbs[i]), issued[i], now);
+            list[i] = NULL;
+            inflight--;
+            if (elapsed >= (int64_t)a->duration_ns) continue;
+            off_t off;
+            timed_io_next(a, &block, blocks, is_rand, &off);
+            cbs[i].aio_offset = off;
+            issued[i] = now;
+            if ((is_write ? aio_write(&cbs[i]) : aio_read(&cbs[i])) == 0) {
+                list[i] = &cbs[i];
+                inflight++;
+            } else {
+                a->errors++;
+            }
+        }
+    }
+    /* aio_suspend 出错时取消剩余请求再释放缓冲区 */
+    for (int i = 0; i < qd && inflight > 0; i++) {
+        if (!list[i]) continue;
+        aio_cancel(fds[i], &cbs[i]);
+        while (aio_error(&cbs[i]) == EINPROGRESS) {
+            aio_suspend(&list[i], 1, NULL);
+        }
+    }
+
+out:
+    for (int i = 1; fds && i < qd; i++) {
+        if (fds[i] != fd) close(fds[i]);
+    }
+    free(cbs);
+    free(list);
+    free(issued);
+    free(fds);
+    a->next_block = block;
+    return elapsed;
+}
+
+void *timed_io_job(void *arg) {
+    struct timed_io_args *a = (struct timed_io_args *)arg;
+    int is_write = a->type == SEQ_WRITE || a->type == RAND_WRITE;
+    int is_rand = a->type == RAND_READ || a->type == RAND_WRITE;
+    size_t blocks = a->file_size / a->io_size;
+    int qd = a->qd > 1 ? a->qd : 1;
+    int flags = is_write ? O_RDWR : O_RDONLY;
+    size_t align = sizeof(void *);
+    void *buf = NULL;
+
+    a->bytes = 0;
+    a->ops = 0;
+    a->errors = 0;
+    a->t_start = 0;
+    a->t_end = 0;
+    lat_hist_init(&a->hist);
+    if (blocks == 0) blocks = 1;
+    if (a->direct) {
+        flags |= O_DIRECT;
+        align = a->mem_align ? a->mem_align : 4096;
+        if (align < sizeof(void *)) align = sizeof(void *);
+    }
+    int fd = open(a->path, flags);
+    if (fd < 0 || posix_memalign(&buf, align, qd * a->io_size) != 0) {
+        a->errors++;
+        if (fd >= 0) close(fd);
+        return NULL;
+    }
+    fill_rand_buffer(buf, qd * a->io_size);
+
+    if (a->start_ns) {
+        struct timespec wake = {
+            .tv_sec = a->start_ns / NANOS_PER_SECOND,
+            .tv_nsec = a->start_ns % NANOS_PER_SECOND,
+        };
+        while (clock_nanosleep(CLOCK_REALTIME, TIMER_ABSTIME, &wake, NULL) ==
+               EINTR) {
+        }
+    }
+    a->t_start = realtime_ns();
+    uint64_t m0 = timer_now();
+
+    int64_t elapsed =
+        qd > 1 ? timed_io_async(a, fd, buf, blocks, is_write, is_rand, m0)
+               : timed_io_sync(a, fd, buf, blocks, is_write, is_rand, m0);
+    a->t_end = a->t_start + elapsed;
+
+    close(fd);
+    free(buf);
+    return NULL;
+}
+
+int timed_io_prefill(const char *path, size_t file_size) {
+    size_t chunk = _1MB_BYTES;
+    char *buf = malloc(chunk);
+    if (!buf) return -1;
+    fill_rand_buffer(buf, chunk);
+    int fd = open(path, O_CREAT | O_WRONLY | O_TRUNC, 0644);
+    if (fd < 0) {
+        free(buf);
+        return -1;
+    }
+    size_t done = 0;
+    int ret = 0;
+    while (done < file_size) {
+        size_t len = file_size - done < chunk ? file_size - done : chunk;
+        if (write(fd, buf, len) != (ssize_t)len) {
+            ret = -1;
+            break;
+        }
+        done += len;
+    }
+    if (ret == 0 && fsync(fd) != 0) ret = -1;
+    int saved = errno;
+    close(fd);
+    free(buf);
+    errno = saved;
+    return ret;
+}
@@ -0,0 +1,47 @@
+/*
+    定时 I/O 负载
+    每个 worker 对自己的文件按 enum test_type 的模式做定长 IO，运行固定时长，
+    记录字节数、操作数、错误数、起止时刻和延迟直方图；可指定绝对出发时刻和
+    队列深度，供多节点运行、稳态检测和参数扫描使用
+*/
+
+#ifndef FSTEST_TIMED_IO_H
+#define FSTEST_TIMED_IO_H
+
+#include "common.h"
+
+struct timed_io_args {
+    char path[MAX_PATH_LEN];
+    enum test_type type;
+    size_t io_size;
+    size_t file_size;
+    uint64_t start_ns;         /* 计划出发时刻 (CLOCK_REALTIME)，0 为立即 */
+    uint64_t duration_ns;
+    unsigned int seed;
+    int qd;                    /* 队列深度，<= 1 为同步 pread / pwrite */
+    int direct;                /* O_DIRECT 打开，缓冲区按 mem_align 对齐 */
+    size_t mem_align;          /* dio_alignment 探测的内存对齐，0 按 4K */
+    size_t next_block;         /* 顺序模式的游标，跨次调用保留，置 0 从头开始 */
+    /* 结果 */
+    uint64_t bytes;
+    uint64_t ops;
+    long errors;
+    uint64_t t_start;          /* 实际出发 / 结束时刻 (CLOCK_REALTIME) */
+    uint64_t t_end;
+    struct lat_hist hist;
+};
+
+/* worker 函数，参数为 struct timed_io_args；每次调用前清零结果字段 */
+void *timed_io_job(void *arg);
+
+/* 把文件写满 file_size 字节随机数据并 fsync，失败返回 -1 并保留 errno */
+int timed_io_prefill(const char *path, size_t file_size);
+
+/* 负载名 "seqread" / "seqwrite" / "randread" / "randwrite" 与枚举互转 */
+const char *test_type_key(enum test_type type);
+int test_type_parse(const char *str);   /* 未知名称返回 -1 */
+
+/* CLOCK_REALTIME 纳秒，跨节点比较的时间基准 */
+uint64_t realtime_ns(void);
+
+#endif /* FSTEST_TIMED_IO_H */
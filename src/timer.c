@@ -0,0 +1,163 @@
+/*
+    低开销计时实现
+    TSC 可用的条件：
+    - CPUID 0x80000007 EDX[8]：不变 TSC，频率不随调频和 C 状态变化
+    - CPUID 0x80000001 EDX[27]：支持 rdtscp (等待之前的指令完成后再读)
+    - 内核当前时钟源为 tsc：内核发现 TSC 跨核不同步或漂移时会切换时钟源，
+      以此作为 TSC 不稳定的判断
+    校准时忙等 TIMER_CALIB_ROUNDS 次，每次 TIMER_CALIB_NS，同时读 TSC 和
+    CLOCK_MONOTONIC 求每 tick 的纳秒数；各次结果相差超过
+    TIMER_CALIB_TOLERANCE 视为不稳定，回退到 clock_gettime
+*/
+
+#include "timer.h"
+
+#ifdef TIMER_HAVE_TSC
+#include <cpuid.h>
+#endif
+
+#define TIMER_CALIB_ROUNDS 3
+#define TIMER_CALIB_NS (10 * 1000000L)
+#define TIMER_CALIB_TOLERANCE 0.001
+#define TIMER_OVERHEAD_LOOPS 100000
+#define TIMER_CLOCKSOURCE \
+    "/sys/devices/system/clocksource/clocksource0/current_clocksource"
+
+int timer_use_tsc = 0;
+double timer_ns_per_tick = 1.0;
+
+static double timer_overhead = 0.0;
+static char timer_reason[128] = "";
+
+int timer_mode_parse(const char *str) {
+    if (strcmp(str, "auto") == 0) return TIMER_AUTO;
+    if (strcmp(str, "tsc") == 0) return TIMER_TSC;
+    if (strcmp(str, "clock") == 0) return TIMER_CLOCK;
+    return -1;
+}
+
+#ifdef TIMER_HAVE_TSC
+static int tsc_cpu_ok(void) {
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx) ||
+        !(edx & (1u << 8))) {
+        snprintf(timer_reason, sizeof(timer_reason), "no invariant TSC");
+        return 0;
+    }
+    if (!__get_cpuid(0x80000001, &eax, &ebx, &ecx, &edx) ||
+        !(edx & (1u << 27))) {
+        snprintf(timer_reason, sizeof(timer_reason), "no rdtscp");
+        return 0;
+    }
+    return 1;
+}
+
+/* 读不到时钟源 (如容器中未挂载 sysfs) 时不作为否决条件 */
+static int tsc_clocksource_ok(void) {
+    FILE *fp = fopen(TIMER_CLOCKSOURCE, "r");
+    if (!fp) return 1;
+    char src[64] = "";
+    int ok = fscanf(fp, "%63s", src) != 1 || strcmp(src, "tsc") == 0;
+    fclose(fp);
+    if (!ok) {
+        snprintf(timer_reason, sizeof(timer_reason),
+                 "kernel clocksource is %s", src);
+    }
+    return ok;
+}
+
+/* 忙等 TIMER_CALIB_NS，返回这段时间内每 tick 的纳秒数 */
+static double tsc_calibrate_once(void) {
+    struct timespec c0, c1;
+    unsigned int aux;
+    clock_gettime(CLOCK_MONOTONIC, &c0);
+    uint64_t t0 = __rdtscp(&aux);
+    int64_t ns;
+    do {
+        clock_gettime(CLOCK_MONOTONIC, &c1);
+        ns = calculate_time_diff_ns(&c0, &c1);
+    } while (ns < TIMER_CALIB_NS);
+    uint64_t t1 = __rdtscp(&aux);
+    return t1 > t0 ? ns / (double)(t1 - t0) : 0.0;
+}
+
+static int tsc_calibrate(void) {
+    double lo = 0.0, hi = 0.0, sum = 0.0;
+    for (int i = 0; i < TIMER_CALIB_ROUNDS; i++) {
+        double r = tsc_calibrate_once();
+        if (r <= 0.0) {
+            snprintf(timer_reason, sizeof(timer_reason),
+                     "TSC not advancing");
+            return -1;
+        }
+        if (i == 0 || r < lo) lo = r;
+        if (i == 0 || r > hi) hi = r;
+        sum += r;
+    }
+    double mean = sum / TIMER_CALIB_ROUNDS;
+    if ((hi - lo) / mean > TIMER_CALIB_TOLERANCE) {
+        snprintf(timer_reason, sizeof(timer_reason),
+                 "TSC rate unstable (%.2f%% spread)",
+                 (hi - lo) / mean * 100.0);
+        return -1;
+    }
+    timer_ns_per_tick = mean;
+    return 0;
+}
+#endif
+
+static double measure_overhead(void) {
+    struct timespec c0, c1;
+    volatile uint64_t sink = 0;
+    clock_gettime(CLOCK_MONOTONIC, &c0);
+    for (int i = 0; i < TIMER_OVERHEAD_LOOPS; i++) sink += timer_now();
+    clock_gettime(CLOCK_MONOTONIC, &c1);
+    (void)sink;
+    return calculate_time_diff_ns(&c0, &c1) / (double)TIMER_OVERHEAD_LOOPS;
+}
+
+int timer_init(int mode) {
+    int ret = 0;
+    timer_use_tsc = 0;
+    timer_ns_per_tick = 1.0;
+    timer_reason[0] = '\0';
+    if (mode == TIMER_CLOCK) {
+        snprintf(timer_reason, sizeof(timer_reason), "--timer clock");
+    } else {
+#ifdef TIMER_HAVE_TSC
+        /* 强制 tsc 时跳过时钟源检查，但 CPU 能力和校准仍然必须通过 */
+        if (tsc_cpu_ok() && (mode == TIMER_TSC || tsc_clocksource_ok()) &&
+            tsc_calibrate() == 0) {
+            timer_use_tsc = 1;
+        }
+#else
+        snprintf(timer_reason, sizeof(timer_reason), "not x86");
+#endif
+        if (mode == TIMER_TSC && !timer_use_tsc) ret = -1;
+    }
+    timer_overhead = measure_overhead();
+    return ret;
+}
+
+const char *timer_name(void) {
+    return timer_use_tsc ? "tsc" : "clock_gettime";
+}
+
+const char *timer_fallback_reason(void) { return timer_reason; }
+
+double timer_overhead_ns(void) { return timer_overhead; }
+
+double timer_tsc_ghz(void) {
+    return timer_use_tsc ? 1.0 / timer_ns_per_tick : 0.0;
+}
+
+void timer_print(void) {
+    if (timer_use_tsc) {
+        printf("  Timer:        tsc (rdtscp, %.3f GHz) | %.1f ns per read\n",
+               timer_tsc_ghz(), timer_overhead);
+    } else {
+        printf("  Timer:        clock_gettime | %.1f ns per read%s%s%s\n",
+               timer_overhead, timer_reason[0] ? " (" : "", timer_reason,
+               timer_reason[0] ? ")" : "");
+    }
+}
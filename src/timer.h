@@ -0,0 +1,62 @@
+/*
+    低开销计时
+    单次 IO 只有几百纳秒时，两次 clock_gettime 本身就占了可观的比例。
+    x86-64 上 CPU 支持不变 TSC (invariant TSC) 和 rdtscp、且内核仍以 TSC
+    作为时钟源时，用 rdtscp 读时间戳计数器，启动时对照 CLOCK_MONOTONIC
+    换算成纳秒；任一条件不满足或校准不稳定时回退到 clock_gettime
+    只用于测量短区间 (单次操作延迟)，运行时长和绝对时刻仍然用 clock_gettime
+*/
+
+#ifndef FSTEST_TIMER_H
+#define FSTEST_TIMER_H
+
+#include "common.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define TIMER_HAVE_TSC 1
+#endif
+
+enum timer_mode { TIMER_AUTO = 0, TIMER_TSC, TIMER_CLOCK };
+
+/* timer_init 之后只读，fork 出的子进程直接继承 */
+extern int timer_use_tsc;
+extern double timer_ns_per_tick;
+
+/* 解析 auto / tsc / clock，无效返回 -1 */
+int timer_mode_parse(const char *str);
+
+/* 选择计时源并校准，返回 0；强制 tsc 但不可用时回退并返回 -1 */
+int timer_init(int mode);
+
+/* 计时源名称 ("tsc" / "clock_gettime") 和回退原因 (无则为空串) */
+const char *timer_name(void);
+const char *timer_fallback_reason(void);
+
+/* 一次 timer_now 的平均开销 (ns) 和 TSC 频率 (GHz，未使用 TSC 时为 0) */
+double timer_overhead_ns(void);
+double timer_tsc_ghz(void);
+
+/* 一行计时源说明，供测试输出 */
+void timer_print(void);
+
+static inline uint64_t timer_now(void) {
+#ifdef TIMER_HAVE_TSC
+    if (timer_use_tsc) {
+        unsigned int aux;
+        return __rdtscp(&aux);
+    }
+#endif
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * NANOS_PER_SECOND + ts.tv_nsec;
+}
+
+/* t0 到 t1 的纳秒数，t1 早于 t0 时 (跨核 TSC 微小偏差) 返回 0 */
+static inline uint64_t timer_diff_ns(uint64_t t0, uint64_t t1) {
+    if (t1 <= t0) return 0;
+    if (timer_use_tsc) return (uint64_t)((t1 - t0) * timer_ns_per_tick);
+    return t1 - t0;
+}
+
+#endif /* FSTEST_TIMER_H */
@@ -0,0 +1,623 @@
+/*
+    I/O 跟踪格式实现
+    - 二进制跟踪的读写
+    - strace 文本转换：支持 strace -f -ttt (或 -tt / 无时间戳) 的输出，
+      处理 <unfinished ...> / <... resumed> 拆分行；按 fd 号跟踪打开的
+      文件和文件位置，把 read/write 换算成带偏移的记录。fd 表按单个
+      进程 (可多线程) 建模，失败的调用不转换
+*/
+
+#include "trace.h"
+
+#include <ctype.h>
+
+#define STRACE_MAX_FD 65536
+#define STRACE_MAX_ARGS 8
+#define STRACE_MAX_PENDING 256
+
+static const char *const trace_op_names[TRACE_OP_COUNT] = {
+    [TRACE_OP_OPEN] = "open",
+    [TRACE_OP_CLOSE] = "close",
+    [TRACE_OP_READ] = "read",
+    [TRACE_OP_WRITE] = "write",
+    [TRACE_OP_FSYNC] = "fsync",
+    [TRACE_OP_FDATASYNC] = "fdatasync",
+    [TRACE_OP_TRUNCATE] = "truncate",
+    [TRACE_OP_UNLINK] = "unlink",
+    [TRACE_OP_STAT] = "stat",
+};
+
+const char *trace_op_name(enum trace_op op) {
+    if ((unsigned)op >= TRACE_OP_COUNT) return "unknown";
+    return trace_op_names[op];
+}
+
+int trace_append(struct trace *t, const struct trace_record *rec) {
+    if (rec->file_id >= TRACE_MAX_FILES) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (t->count == t->capacity) {
+        size_t cap = t->capacity ? t->capacity * 2 : 1024;
+        struct trace_record *p = realloc(t->records, cap * sizeof(*p));
+        if (!p) return -1;
+        t->records = p;
+        t->capacity = cap;
+    }
+    t->records[t->count++] = *rec;
+    if (rec->file_id >= t->file_count) t->file_count = rec->file_id + 1;
+    if (rec->thread >= t->thread_count) t->thread_count = rec->thread + 1;
+    return 0;
+}
+
+void trace_free(struct trace *t) {
+    free(t->records);
+    memset(t, 0, sizeof(*t));
+}
+
+int trace_load(const char *path, struct trace *t) {
+    memset(t, 0, sizeof(*t));
+    FILE *fp = fopen(path, "rb");
+    if (!fp) return -1;
+
+    struct trace_header hdr;
+    if (fread(&hdr, sizeof(hdr), 1, fp) != 1 ||
+        memcmp(hdr.magic, TRACE_MAGIC, sizeof(hdr.magic)) != 0 ||
+        hdr.version != TRACE_VERSION ||
+        hdr.record_size != sizeof(struct trace_record)) {
+        fclose(fp);
+        errno = EINVAL;
+        return -1;
+    }
+    struct trace_record rec;
+    for (uint64_t i = 0; i < hdr.record_count; i++) {
+        if (fread(&rec, sizeof(rec), 1, fp) != 1 ||
+            rec.op >= TRACE_OP_COUNT || rec.file_id >= TRACE_MAX_FILES) {
+            fclose(fp);
+            trace_free(t);
+            errno = EINVAL;
+            return -1;
+        }
+        if (trace_append(t, &rec) != 0) {
+            fclose(fp);
+            trace_free(t);
+            errno = ENOMEM;
+            return -1;
+        }
+    }
+    fclose(fp);
+    return 0;
+}
+
+int trace_save(const char *path, const struct trace *t) {
+    FILE *fp = fopen(path, "wb");
+    if (!fp) return -1;
+
+    struct trace_header hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    memcpy(hdr.magic, TRACE_MAGIC, sizeof(hdr.magic));
+    hdr.version = TRACE_VERSION;
+    hdr.record_size = sizeof(struct trace_record);
+    hdr.record_count = t->count;
+    if (fwrite(&hdr, sizeof(hdr), 1, fp) != 1 ||
+        fwrite(t->records, sizeof(struct trace_record), t->count, fp) !=
+            t->count) {
+        fclose(fp);
+        return -1;
+    }
+    return fclose(fp);
+}
+
+/* ===== strace 转换 ===== */
+
+struct strace_pending {
+    long tid;
+    int64_t ts_ns;
+    char *text;
+};
+
+struct strace_state {
+    struct trace *t;
+    /* 路径 -> 文件编号 (开放寻址哈希表，槽内存 id + 1) */
+    char **paths;
+    uint64_t *sizes;           /* 按写入 / 截断跟踪的文件长度 */
+    uint32_t path_count;
+    uint32_t path_cap;
+    uint32_t *slots;
+    uint32_t slot_count;
+    /* fd 表 */
+    int32_t fd_file[STRACE_MAX_FD];
+    uint64_t fd_pos[STRACE_MAX_FD];
+    uint8_t fd_append[STRACE_MAX_FD];
+    /* tid -> 连续线程编号 */
+    long *tids;
+    uint32_t tid_count;
+    uint32_t tid_cap;
+    struct strace_pending pending[STRACE_MAX_PENDING];
+    int pending_count;
+    int64_t first_ts;
+    uint32_t seq;
+};
+
+static uint32_t path_hash(const char *s) {
+    uint32_t h = 2166136261u;
+    while (*s) {
+        h ^= (uint8_t)*s++;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static int path_slots_grow(struct strace_state *st) {
+    uint32_t count = st->slot_count ? st->slot_count * 2 : 1024;
+    uint32_t *slots = calloc(count, sizeof(uint32_t));
+    if (!slots) return -1;
+    for (uint32_t id = 0; id < st->path_count; id++) {
+        uint32_t idx = path_hash(st->paths[id]) & (count - 1);
+        while (slots[idx]) idx = (idx + 1) & (count - 1);
+        slots[idx] = id + 1;
+    }
+    free(st->slots);
+    st->slots = slots;
+    st->slot_count = count;
+    return 0;
+}
+
+static int path_id(struct strace_state *st, const char *path) {
+    if ((st->path_count + 1) * 2 > st->slot_count &&
+        path_slots_grow(st) != 0) {
+        return -1;
+    }
+    uint32_t mask = st->slot_count - 1;
+    uint32_t idx = path_hash(path) & mask;
+    while (st->slots[idx]) {
+        if (strcmp(st->paths[st->slots[idx] - 1], path) == 0) {
+            return (int)(st->slots[idx] - 1);
+        }
+        idx = (idx + 1) & mask;
+    }
+    if (st->path_count == st->path_cap) {
+        uint32_t cap = st->path_cap ? st->path_cap * 2 : 256;
+        char **paths = realloc(st->paths, cap * sizeof(char *));
+        if (!paths) return -1;
+        st->paths = paths;
+        uint64_t *sizes = realloc(st->sizes, cap * sizeof(uint64_t));
+        if (!sizes) return -1;
+        st->sizes = sizes;
+        st->path_cap = cap;
+    }
+    st->paths[st->path_count] = strdup(path);
+    if (!st->paths[st->path_count]) return -1;
+    st->sizes[st->path_count] = 0;
+    st->slots[idx] = st->path_count + 1;
+    return (int)st->path_count++;
+}
+
+static int thread_index(struct strace_state *st, long tid) {
+    for (uint32_t i = 0; i < st->tid_count; i++) {
+        if (st->tids[i] == tid) return (int)i;
+    }
+    if (st->tid_count >= UINT16_MAX) return UINT16_MAX - 1;
+    if (st->tid_count == st->tid_cap) {
+        uint32_t cap = st->tid_cap ? st->tid_cap * 2 : 16;
+        long *tids = realloc(st->tids, cap * sizeof(long));
+        if (!tids) return 0;
+        st->tids = tids;
+        st->tid_cap = cap;
+    }
+    st->tids[st->tid_count] = tid;
+    return (int)st->tid_count++;
+}
+
+/* 解析带引号的字符串参数 (处理 \" \\ \n \t \ooo \xhh 转义) */
+static int unquote(const char *arg, char *out, size_t size) {
+    if (*arg != '"') return -1;
+    size_t n = 0;
+    for (const char *p = arg + 1; *p && *p != '"'; p++) {
+        int c = (unsigned char)*p;
+        if (c == '\\' && p[1]) {
+            p++;
+            if (*p >= '0' && *p <= '7') {
+                c = 0;
+                for (int i = 0; i < 3 && *p >= '0' && *p <= '7'; i++, p++) {
+                    c = c * 8 + (*p - '0');
+                }
+                p--;
+            } else if (*p == 'x' && isxdigit((unsigned char)p[1])) {
+                char hex[3] = {p[1], isxdigit((unsigned char)p[2]) ? p[2] : 0,
+                               0};
+                c = (int)strtol(hex, NULL, 16);
+                p += strlen(hex);
+            } else if (*p == 'n') {
+                c = '\n';
+            } else if (*p == 't') {
+                c = '\t';
+            } else {
+                c = (unsigned char)*p;
+            }
+        }
+        if (n + 1 >= size) return -1;
+        out[n++] = (char)c;
+    }
+    out[n] = '\0';
+    return 0;
+}
+
+/* 按顶层逗号就地切分参数 */
+static int split_args(char *s, char **argv, int max) {
+    int argc = 0, depth = 0, inq = 0;
+    while (*s == ' ') s++;
+    if (*s == '\0') return 0;
+    argv[argc++] = s;
+    for (; *s; s++) {
+        if (inq) {
+            if (*s == '\\' && s[1]) {
+                s++;
+            } else if (*s == '"') {
+                inq = 0;
+            }
+            continue;
+        }
+        if (*s == '"') {
+            inq = 1;
+        } else if (*s == '{' || *s == '[' || *s == '(') {
+            depth++;
+        } else if (*s == '}' || *s == ']' || *s == ')') {
+            depth--;
+        } else if (*s == ',' && depth == 0 && argc < max) {
+            *s = '\0';
+            s++;
+            while (*s == ' ') s++;
+            argv[argc++] = s;
+            s--;
+        }
+    }
+    return argc;
+}
+
+/* fd 参数对应的文件编号；strace -y 形式 "3</path>" 可补全跟踪前打开的 fd */
+static int fd_file_id(struct strace_state *st, const char *arg, long *fd_out) {
+    char *end;
+    long fd = strtol(arg, &end, 10);
+    if (end == arg || fd < 0 || fd >= STRACE_MAX_FD) return -1;
+    *fd_out = fd;
+    if (st->fd_file[fd] < 0 && *end == '<') {
+        char path[MAX_PATH_LEN];
+        const char *close = strrchr(end, '>');
+        size_t len = close ? (size_t)(close - end - 1) : 0;
+        if (len == 0 || len >= sizeof(path) || end[1] != '/') return -1;
+        memcpy(path, end + 1, len);
+        path[len] = '\0';
+        int id = path_id(st, path);
+        if (id < 0) return -1;
+        st->fd_file[fd] = id;
+        st->fd_pos[fd] = 0;
+        st->fd_append[fd] = 0;
+    }
+    return st->fd_file[fd];
+}
+
+static int emit(struct strace_state *st, long tid, int64_t ts_ns,
+                enum trace_op op, int file_id, uint64_t offset,
+                uint64_t length, uint8_t flags) {
+    struct trace_record rec;
+    memset(&rec, 0, sizeof(rec));
+    if (ts_ns >= 0 && st->first_ts >= 0 && ts_ns > st->first_ts) {
+        rec.ts_ns = (uint64_t)(ts_ns - st->first_ts);
+    }
+    rec.offset = offset;
+    rec.length = length > UINT32_MAX ? UINT32_MAX : (uint32_t)length;
+    rec.file_id = (uint32_t)file_id;
+    rec.thread = (uint16_t)thread_index(st, tid);
+    rec.op = (uint8_t)op;
+    rec.flags = flags;
+    rec.seq = st->seq++;
+    return trace_append(st->t, &rec) == 0 ? 0 : -1;
+}
+
+/* 按路径参数产生记录 (unlink / stat / truncate) */
+static int emit_path(struct strace_state *st, long tid, int64_t ts_ns,
+                     enum trace_op op, const char *arg, uint64_t offset) {
+    char path[MAX_PATH_LEN];
+    if (unquote(arg, path, sizeof(path)) != 0) return 1;
+    int id = path_id(st, path);
+    if (id < 0) return -1;
+    if (op == TRACE_OP_TRUNCATE) st->sizes[id] = offset;
+    return emit(st, tid, ts_ns, op, id, offset, 0, 0);
+}
+
+#define IS(s) (strcmp(name, (s)) == 0)
+
+/* 返回 0 已转换或无需转换，1 不支持，-1 内存不足 */
+static int handle_call(struct strace_state *st, long tid, int64_t ts_ns,
+                       const char *name, char **argv, int argc,
+                       long long ret) {
+    long fd = -1;
+    int id;
+
+    if (IS("open") || IS("openat") || IS("openat2") || IS("creat")) {
+        int at = IS("openat") || IS("openat2");
+        if (argc < at + 1 || ret >= STRACE_MAX_FD) return 1;
+        const char *flags = IS("creat") ? "O_CREAT|O_TRUNC"
+                            : argc > at + 1 ? argv[at + 1] : "";
+        if (strstr(flags, "O_DIRECTORY")) return 0;
+        char path[MAX_PATH_LEN];
+        if (unquote(argv[at], path, sizeof(path)) != 0) return 1;
+        if ((id = path_id(st, path)) < 0) return -1;
+        st->fd_file[ret] = id;
+        st->fd_pos[ret] = 0;
+        st->fd_append[ret] = strstr(flags, "O_APPEND") != NULL;
+        uint8_t rflags = 0;
+        if (strstr(flags, "O_TRUNC")) {
+            rflags |= TRACE_F_TRUNC;
+            st->sizes[id] = 0;
+        }
+        return emit(st, tid, ts_ns, TRACE_OP_OPEN, id, 0, 0, rflags);
+    }
+    if (IS("close")) {
+        if (argc < 1 || (id = fd_file_id(st, argv[0], &fd)) < 0) return 0;
+        st->fd_file[fd] = -1;
+        return emit(st, tid, ts_ns, TRACE_OP_CLOSE, id, 0, 0, 0);
+    }
+    if (IS("dup") || IS("dup2") || IS("dup3") ||
+        (IS("fcntl") && argc > 1 && strstr(argv[1], "F_DUPFD"))) {
+        if (argc < 1 || ret >= STRACE_MAX_FD ||
+            (id = fd_file_id(st, argv[0], &fd)) < 0) {
+            return 0;
+        }
+        st->fd_file[ret] = id;
+        st->fd_pos[ret] = st->fd_pos[fd];
+        st->fd_append[ret] = st->fd_append[fd];
+        return 0;
+    }
+    if (IS("read") || IS("readv") || IS("write") || IS("writev")) {
+        if (argc < 1 || (id = fd_file_id(st, argv[0], &fd)) < 0) return 0;
+        int is_write = name[0] == 'w';
+        uint64_t off = is_write && st->fd_append[fd] ? st->sizes[id]
+                                                     : st->fd_pos[fd];
+        st->fd_pos[fd] = off + (uint64_t)ret;
+        if (is_write && off + (uint64_t)ret > st->sizes[id]) {
+            st->sizes[id] = off + (uint64_t)ret;
+        }
+        return emit(st, tid, ts_ns, is_write ? TRACE_OP_WRITE : TRACE_OP_READ,
+                    id, off, (uint64_t)ret, 0);
+    }
+    if (IS("pread64") || IS("preadv") || IS("preadv2") || IS("pwrite64") ||
+        IS("pwritev") || IS("pwritev2")) {
+        if (argc < 4 || (id = fd_file_id(st, argv[0], &fd)) < 0) return 0;
+        int is_write = name[1] == 'w';
+        uint64_t off = strtoull(argv[3], NULL, 0);
+        if (is_write && off + (uint64_t)ret > st->sizes[id]) {
+            st->sizes[id] = off + (uint64_t)ret;
+        }
+        return emit(st, tid, ts_ns, is_write ? TRACE_OP_WRITE : TRACE_OP_READ,
+                    id, off, (uint64_t)ret, 0);
+    }
+    if (IS("lseek")) {
+        if (argc >= 1 && fd_file_id(st, argv[0], &fd) >= 0) {
+            st->fd_pos[fd] = (uint64_t)ret;
+        }
+        return 0;
+    }
+    if (IS("fsync") || IS("fdatasync")) {
+        if (argc < 1 || (id = fd_file_id(st, argv[0], &fd)) < 0) return 0;
+        return emit(st, tid, ts_ns,
+                    IS("fsync") ? TRACE_OP_FSYNC : TRACE_OP_FDATASYNC, id, 0,
+                    0, 0);
+    }
+    if (IS("ftruncate") || IS("ftruncate64")) {
+        if (argc < 2 || (id = fd_file_id(st, argv[0], &fd)) < 0) return 0;
+        uint64_t len = strtoull(argv[1], NULL, 0);
+        st->sizes[id] = len;
+        return emit(st, tid, ts_ns, TRACE_OP_TRUNCATE, id, len, 0, 0);
+    }
+    if (IS("truncate") || IS("truncate64")) {
+        if (argc < 2) return 1;
+        return emit_path(st, tid, ts_ns, TRACE_OP_TRUNCATE, argv[0],
+                         strtoull(argv[1], NULL, 0));
+    }
+    if (IS("unlink")) {
+        if (argc < 1) return 1;
+        return emit_path(st, tid, ts_ns, TRACE_OP_UNLINK, argv[0], 0);
+    }
+    if (IS("unlinkat")) {
+        if (argc < 3 || strstr(argv[2], "AT_REMOVEDIR")) return 0;
+        return emit_path(st, tid, ts_ns, TRACE_OP_UNLINK, argv[1], 0);
+    }
+    if (IS("stat") || IS("lstat") || IS("stat64") || IS("lstat64")) {
+        if (argc < 1) return 1;
+        return emit_path(st, tid, ts_ns, TRACE_OP_STAT, argv[0], 0);
+    }
+    if (IS("newfstatat") || IS("fstatat64") || IS("statx")) {
+        if (argc < 2) return 1;
+        if (strcmp(argv[1], "\"\"") == 0) {
+            if ((id = fd_file_id(st, argv[0], &fd)) < 0) return 0;
+            return emit(st, tid, ts_ns, TRACE_OP_STAT, id, 0, 0, 0);
+        }
+        return emit_path(st, tid, ts_ns, TRACE_OP_STAT, argv[1], 0);
+    }
+    if (IS("fstat") || IS("fstat64")) {
+        if (argc < 1 || (id = fd_file_id(st, argv[0], &fd)) < 0) return 0;
+        return emit(st, tid, ts_ns, TRACE_OP_STAT, id, 0, 0, 0);
+    }
+    return 1;
+}
+
+#undef IS
+
+/* 解析 "name(args) = ret ..." 部分 */
+static int parse_call(struct strace_state *st, long tid, int64_t ts_ns,
+                      char *text) {
+    char *p = text;
+    while (isalnum((unsigned char)*p) || *p == '_') p++;
+    if (p == text || *p != '(') return 1;
+    *p = '\0';
+    char *args = p + 1;
+
+    int depth = 0, inq = 0;
+    char *s;
+    for (s = args; *s; s++) {
+        if (inq) {
+            if (*s == '\\' && s[1]) {
+                s++;
+            } else if (*s == '"') {
+                inq = 0;
+            }
+            continue;
+        }
+        if (*s == '"') {
+            inq = 1;
+        } else if (*s == '(' || *s == '{' || *s == '[') {
+            depth++;
+        } else if (*s == ')' || *s == '}' || *s == ']') {
+            if (depth == 0 && *s == ')') break;
+            depth--;
+        }
+    }
+    if (*s != ')') return 1;
+    *s = '\0';
+
+    char *eq = strstr(s + 1, "= ");
+    if (!eq || eq[2] == '?') return 1;
+    long long ret = strtoll(eq + 2, NULL, 0);
+    if (ret < 0) return 0; /* 失败的调用不回放 */
+
+    char *argv[STRACE_MAX_ARGS];
+    int argc = split_args(args, argv, STRACE_MAX_ARGS);
+    return handle_call(st, tid, ts_ns, text, argv, argc, ret);
+}
+
+/* 解析 "秒.小数" 或 "时:分:秒.小数" 形式的时间戳 */
+static int64_t parse_ts(const char *p, const char *end) {
+    int64_t sec = 0, field = 0, ns = 0, scale = NANOS_PER_SECOND / 10;
+    for (; p < end && *p != '.'; p++) {
+        if (*p == ':') {
+            sec = (sec + field) * 60;
+            field = 0;
+        } else {
+            field = field * 10 + (*p - '0');
+        }
+    }
+    sec += field;
+    for (p++; p < end && isdigit((unsigned char)*p); p++, scale /= 10) {
+        ns += (*p - '0') * scale;
+    }
+    return sec * NANOS_PER_SECOND + ns;
+}
+
+static int parse_line(struct strace_state *st, char *line) {
+    char *p = line;
+    long tid = 0;
+    int64_t ts_ns = -1;
+
+    line[strcspn(line, "\n")] = '\0';
+    while (*p == ' ') p++;
+    if (strncmp(p, "[pid", 4) == 0) {
+        tid = strtol(p + 4, &p, 10);
+        if (*p != ']') return 1;
+        p++;
+    } else if (isdigit((unsigned char)*p)) {
+        char *q = p;
+        while (isdigit((unsigned char)*q)) q++;
+        if (*q == ' ') {
+            tid = strtol(p, NULL, 10);
+            p = q;
+        }
+    }
+    while (*p == ' ') p++;
+    if (isdigit((unsigned char)*p)) {
+        char *q = p;
+        while (isdigit((unsigned char)*q) || *q == '.' || *q == ':') q++;
+        ts_ns = parse_ts(p, q);
+        p = q;
+        while (*p == ' ') p++;
+    }
+    if (ts_ns >= 0 && st->first_ts < 0) st->first_ts = ts_ns;
+    if (*p == '+' || *p == '-' || *p == '\0') return 0; /* 信号 / 退出 */
+
+    char *unfinished = strstr(p, " <unfinished ...>");
+    if (unfinished) {
+        *unfinished = '\0';
+        if (st->pending_count == STRACE_MAX_PENDING) return 1;
+        struct strace_pending *pd = &st->pending[st->pending_count];
+        pd->text = strdup(p);
+        if (!pd->text) return -1;
+        pd->tid = tid;
+        pd->ts_ns = ts_ns;
+        st->pending_count++;
+        return 0;
+    }
+    if (strncmp(p, "<... ", 5) == 0) {
+        char *resumed = strstr(p, "resumed>");
+        if (!resumed) return 1;
+        for (int i = 0; i < st->pending_count; i++) {
+            struct strace_pending *pd = &st->pending[i];
+            if (pd->tid != tid) continue;
+            size_t len = strlen(pd->text) + strlen(resumed + 8) + 1;
+            char *combined = malloc(len);
+            if (!combined) return -1;
+            snprintf(combined, len, "%s%s", pd->text, resumed + 8);
+            int64_t start_ts = pd->ts_ns;
+            free(pd->text);
+            *pd = st->pending[--st->pending_count];
+            int ret = parse_call(st, tid, start_ts, combined);
+            free(combined);
+            return ret;
+        }
+        return 1;
+    }
+    return parse_call(st, tid, ts_ns, p);
+}
+
+static int trace_record_cmp(const void *a, const void *b) {
+    const struct trace_record *ra = a, *rb = b;
+    if (ra->ts_ns != rb->ts_ns) return ra->ts_ns < rb->ts_ns ? -1 : 1;
+    return ra->seq < rb->seq ? -1 : ra->seq > rb->seq;
+}
+
+int trace_from_strace(const char *path, struct trace *t, long *skipped) {
+    memset(t, 0, sizeof(*t));
+    *skipped = 0;
+    FILE *fp = fopen(path, "r");
+    if (!fp) return -1;
+    struct strace_state *st = calloc(1, sizeof(*st));
+    if (!st) {
+        fclose(fp);
+        errno = ENOMEM;
+        return -1;
+    }
+    st->t = t;
+    st->first_ts = -1;
+    for (int i = 0; i < STRACE_MAX_FD; i++) st->fd_file[i] = -1;
+
+    char *line = NULL;
+    size_t cap = 0;
+    int ret = 0;
+    while (getline(&line, &cap, fp) >= 0) {
+        int r = parse_line(st, line);
+        if (r < 0) {
+            errno = ENOMEM;
+            ret = -1;
+            break;
+        }
+        *skipped += r;
+    }
+    free(line);
+    fclose(fp);
+
+    /* 被拆分的调用按发起时间归位 */
+    if (ret == 0) {
+        qsort(t->records, t->count, sizeof(struct trace_record),
+              trace_record_cmp);
+    } else {
+        trace_free(t);
+    }
+    for (int i = 0; i < st->pending_count; i++) free(st->pending[i].text);
+    for (uint32_t i = 0; i < st->path_count; i++) free(st->paths[i]);
+    free(st->paths);
+    free(st->sizes);
+    free(st->slots);
+    free(st->tids);
+    free(st);
+    return ret;
+}
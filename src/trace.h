@@ -0,0 +1,73 @@
+/*
+    I/O 跟踪格式
+    紧凑的二进制跟踪文件 (文件头 + 定长记录)，供 replay 模式回放
+    并提供从 strace 文本输出到二进制跟踪的转换
+*/
+
+#ifndef FSTEST_TRACE_H
+#define FSTEST_TRACE_H
+
+#include "common.h"
+
+#define TRACE_MAGIC "FSTTRACE"
+#define TRACE_VERSION 1
+
+enum trace_op {
+    TRACE_OP_OPEN = 0,
+    TRACE_OP_CLOSE,
+    TRACE_OP_READ,
+    TRACE_OP_WRITE,
+    TRACE_OP_FSYNC,
+    TRACE_OP_FDATASYNC,
+    TRACE_OP_TRUNCATE,         /* offset 为截断后的长度 */
+    TRACE_OP_UNLINK,
+    TRACE_OP_STAT,
+    TRACE_OP_COUNT
+};
+
+/* trace_record.flags */
+#define TRACE_F_TRUNC 0x01     /* open 带 O_TRUNC */
+
+/* 文件头，所有字段为本机字节序 */
+struct trace_header {
+    char magic[8];
+    uint32_t version;
+    uint32_t record_size;
+    uint64_t record_count;
+};
+
+/* 定长 32 字节记录 */
+struct trace_record {
+    uint64_t ts_ns;            /* 相对跟踪起点的发起时间 */
+    uint64_t offset;
+    uint32_t length;
+    uint32_t file_id;          /* 文件编号，回放时映射为测试目录下的文件 */
+    uint16_t thread;           /* 原始线程编号 (从 0 连续编号) */
+    uint8_t op;                /* enum trace_op */
+    uint8_t flags;
+    uint32_t seq;              /* 原始顺序号，同一时间戳时保持顺序 */
+};
+
+_Static_assert(sizeof(struct trace_record) == 32, "trace record size");
+
+/* file_id 上限，回放按 file_id 建文件和 fd 表，超出视为损坏的跟踪 */
+#define TRACE_MAX_FILES (1u << 20)
+
+struct trace {
+    struct trace_record *records;
+    size_t count;
+    size_t capacity;
+    uint32_t file_count;       /* 最大 file_id + 1 */
+    uint32_t thread_count;     /* 最大 thread + 1 */
+};
+
+const char *trace_op_name(enum trace_op op);
+int trace_append(struct trace *t, const struct trace_record *rec);
+void trace_free(struct trace *t);
+int trace_load(const char *path, struct trace *t);
+int trace_save(const char *path, const struct trace *t);
+
+/* 转换 strace -f -ttt 输出；返回 0 成功，skipped 为未能识别的行数 */
+int trace_from_strace(const char *path, struct trace *t, long *skipped);
+
+#endif /* FSTEST_TRACE_H */
@@ -0,0 +1,188 @@
+/*
+    并行 worker 执行实现
+    屏障放在共享匿名映射中 (进程间共享的 mutex / cond)：每个 worker 报到
+    后等待，父进程等全部报到再统一放行，线程创建和 fork 的开销不计入测量
+    区间。每个 worker 在共享内存中记录自己的起止时间，测量区间取最早出发
+    到最晚结束。进程模式下子进程的文件操作统计通过共享内存交回父进程
+*/
+
+#include "worker.h"
+#include "fsop.h"
+
+#include <sys/mman.h>
+#include <sys/wait.h>
+
+enum worker_state { WORKER_WAIT, WORKER_GO, WORKER_ABORT };
+
+struct worker_ctl {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    int ready;
+    int state;
+    struct timespec start[MAX_JOBS];
+    struct timespec end[MAX_JOBS];
+};
+
+struct worker_thread_arg {
+    struct worker_ctl *ctl;
+    int id;
+    void *(*fn)(void *);
+    void *arg;
+};
+
+static void *shared_alloc(size_t size) {
+    void *p = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                   MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    return p == MAP_FAILED ? NULL : p;
+}
+
+void *worker_args_alloc(int n, size_t arg_size, int use_procs) {
+    if (!use_procs) return calloc(n, arg_size);
+    return shared_alloc(n * arg_size); /* 匿名映射已清零 */
+}
+
+void worker_args_free(void *args, int n, size_t arg_size, int use_procs) {
+    if (!args) return;
+    if (use_procs) {
+        munmap(args, n * arg_size);
+    } else {
+        free(args);
+    }
+}
+
+const char *worker_strerror(int64_t ret) {
+    return ret == WORKER_ERR_EXIT ? "worker process exited abnormally"
+                                  : "cannot start workers";
+}
+
+const char *worker_kind(int use_procs) {
+    return use_procs ? "processes" : "threads";
+}
+
+/* 报到并等待放行；返回 0 出发，-1 放弃 */
+static int worker_gate(struct worker_ctl *ctl) {
+    pthread_mutex_lock(&ctl->lock);
+    ctl->ready++;
+    pthread_cond_broadcast(&ctl->cond);
+    while (ctl->state == WORKER_WAIT) {
+        pthread_cond_wait(&ctl->cond, &ctl->lock);
+    }
+    int go = ctl->state == WORKER_GO;
+    pthread_mutex_unlock(&ctl->lock);
+    return go ? 0 : -1;
+}
+
+static void worker_body(struct worker_ctl *ctl, int id, void *(*fn)(void *),
+                        void *arg) {
+    if (worker_gate(ctl) != 0) return;
+    clock_gettime(CLOCK_MONOTONIC, &ctl->start[id]);
+    fn(arg);
+    clock_gettime(CLOCK_MONOTONIC, &ctl->end[id]);
+}
+
+static void *worker_thread(void *p) {
+    struct worker_thread_arg *a = (struct worker_thread_arg *)p;
+    worker_body(a->ctl, a->id, a->fn, a->arg);
+    return NULL;
+}
+
+/* 全部启动成功时等所有 worker 报到后放行，否则通知已启动的 worker 放弃 */
+static void worker_release(struct worker_ctl *ctl, int started, int n) {
+    pthread_mutex_lock(&ctl->lock);
+    if (started == n) {
+        while (ctl->ready < n) pthread_cond_wait(&ctl->cond, &ctl->lock);
+        ctl->state = WORKER_GO;
+    } else {
+        ctl->state = WORKER_ABORT;
+    }
+    pthread_cond_broadcast(&ctl->cond);
+    pthread_mutex_unlock(&ctl->lock);
+}
+
+int64_t run_workers(int n, int use_procs, void *(*fn)(void *), void *args,
+                    size_t arg_size) {
+    if (n < 1 || n > MAX_JOBS) return WORKER_ERR_START;
+    struct worker_ctl *ctl = shared_alloc(sizeof(*ctl));
+    if (!ctl) return WORKER_ERR_START;
+
+    pthread_mutexattr_t mattr;
+    pthread_condattr_t cattr;
+    pthread_mutexattr_init(&mattr);
+    pthread_mutexattr_setpshared(&mattr, PTHREAD_PROCESS_SHARED);
+    pthread_mutex_init(&ctl->lock, &mattr);
+    pthread_mutexattr_destroy(&mattr);
+    pthread_condattr_init(&cattr);
+    pthread_condattr_setpshared(&cattr, PTHREAD_PROCESS_SHARED);
+    pthread_cond_init(&ctl->cond, &cattr);
+    pthread_condattr_destroy(&cattr);
+
+    size_t prof_size = use_procs && fsop_enabled ? fsop_export_size() : 0;
+    char *prof = prof_size ? shared_alloc(prof_size * n) : NULL;
+
+    pthread_t threads[MAX_JOBS];
+    struct worker_thread_arg targs[MAX_JOBS];
+    pid_t pids[MAX_JOBS];
+    int started = 0;
+
+    for (int i = 0; i < n; i++) {
+        void *arg = (char *)args + i * arg_size;
+        if (use_procs) {
+            pid_t pid = fork();
+            if (pid == 0) {
+                /* 子进程继承了父进程的统计，清零后只导出自己的部分 */
+                if (prof) fsop_reset();
+                worker_body(ctl, i, fn, arg);
+                if (prof) fsop_export(prof + i * prof_size);
+                _exit(0);
+            }
+            if (pid < 0) break;
+            pids[i] = pid;
+        } else {
+            targs[i].ctl = ctl;
+            targs[i].id = i;
+            targs[i].fn = fn;
+            targs[i].arg = arg;
+            if (pthread_create(&threads[i], NULL, worker_thread, &targs[i]) !=
+                0) {
+                break;
+            }
+        }
+        started++;
+    }
+
+    worker_release(ctl, started, n);
+    int child_failed = 0;
+    for (int i = 0; i < started; i++) {
+        if (use_procs) {
+            int status;
+            /* 子进程崩溃时它写回共享内存的结果不完整，整轮作废 */
+            if (waitpid(pids[i], &status, 0) != pids[i] ||
+                !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+                child_failed = 1;
+            }
+            if (prof) fsop_import(prof + i * prof_size);
+        } else {
+            pthread_join(threads[i], NULL);
+        }
+    }
+
+    int64_t elapsed = child_failed ? WORKER_ERR_EXIT : WORKER_ERR_START;
+    if (started == n && !child_failed) {
+        struct timespec first = ctl->start[0], last = ctl->end[0];
+        for (int i = 1; i < n; i++) {
+            if (calculate_time_diff_ns(&first, &ctl->start[i]) < 0) {
+                first = ctl->start[i];
+            }
+            if (calculate_time_diff_ns(&last, &ctl->end[i]) > 0) {
+                last = ctl->end[i];
+            }
+        }
+        elapsed = calculate_time_diff_ns(&first, &last);
+    }
+
+    pthread_cond_destroy(&ctl->cond);
+    pthread_mutex_destroy(&ctl->lock);
+    munmap(ctl, sizeof(*ctl));
+    if (prof) munmap(prof, prof_size * n);
+    return elapsed;
+}
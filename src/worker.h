@@ -0,0 +1,32 @@
+/*
+    并行 worker 执行
+    -j 个 worker 以线程 (默认) 或 fork 出的子进程 (--procs) 方式运行
+    进程模式下 worker 参数数组放在共享匿名映射中，子进程写回的结果对父进程
+    可见；所有 worker 在共享内存屏障处就绪后一起出发
+*/
+
+#ifndef FSTEST_WORKER_H
+#define FSTEST_WORKER_H
+
+#include "common.h"
+
+/* 分配 / 释放 n 个 arg_size 大小的 worker 参数 (已清零) */
+void *worker_args_alloc(int n, size_t arg_size, int use_procs);
+void worker_args_free(void *args, int n, size_t arg_size, int use_procs);
+
+/* run_workers 的失败返回值 */
+#define WORKER_ERR_START (-1) /* 线程 / 子进程未能全部启动 */
+#define WORKER_ERR_EXIT (-2)  /* 有子进程被信号终止或退出码非 0 */
+
+/* 运行 n 个 worker，第 i 个的参数为 args + i * arg_size
+   返回最早出发到最晚结束的纳秒数，失败返回 WORKER_ERR_* */
+int64_t run_workers(int n, int use_procs, void *(*fn)(void *), void *args,
+                    size_t arg_size);
+
+/* run_workers 失败返回值的说明，供 TEST_FAIL 输出 */
+const char *worker_strerror(int64_t ret);
+
+/* 输出用的 worker 类型名："threads" / "processes" */
+const char *worker_kind(int use_procs);
+
+#endif /* FSTEST_WORKER_H */